@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+
+#include <bnl/base/buffer.hpp>
+
+using namespace bnl;
+
+static constexpr size_t BLOCK_SIZE = 64 * 1024;
+// Larger than the SSO threshold so every slice references the memory block.
+static constexpr size_t SLICE_SIZE = 32;
+
+static base::buffer
+make_block(bool shared)
+{
+  base::buffer block(BLOCK_SIZE);
+
+  if (shared) {
+    block.share();
+  }
+
+  return block;
+}
+
+// Each iteration creates and destroys a slice which increments and decrements
+// the reference count of the memory block once.
+static void
+buffer_slice(benchmark::State &state)
+{
+  bool shared = state.range(0) != 0;
+  base::buffer block = make_block(shared);
+
+  for (auto _ : state) {
+    if (block.size() < SLICE_SIZE) {
+      state.PauseTiming();
+      block = make_block(shared);
+      state.ResumeTiming();
+    }
+
+    base::buffer slice = block.slice(SLICE_SIZE);
+    benchmark::DoNotOptimize(slice.data());
+  }
+}
+
+BENCHMARK(buffer_slice)->ArgName("shared")->Arg(0)->Arg(1);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <bnl/base/export.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace bnl {
+namespace base {
+
+// Bump allocator that hands out memory from a list of blocks. Memory isn't
+// released per allocation but all at once by `clear` which keeps the blocks
+// around so they can be reused. This makes it a cheap home for data that lives
+// as long as a single unit of work such as the strings of a header block.
+class BNL_BASE_EXPORT arena {
+public:
+  static constexpr size_t BLOCK_SIZE = 1024;
+
+  // Position that `rewind` can return to.
+  struct marker {
+    size_t block;
+    size_t used;
+  };
+
+  arena() = default;
+
+  arena(arena &&) = default;
+  arena &operator=(arena &&) = default;
+
+  // Returns `size` bytes of memory that stay valid until the arena is cleared,
+  // rewound to before the allocation or destroyed.
+  char *allocate(size_t size);
+
+  // Returns the last `size` bytes of the most recent allocation to the arena.
+  void shrink(size_t size) noexcept;
+
+  marker mark() const noexcept;
+
+  // Releases all memory allocated since `marker` was taken.
+  void rewind(marker marker) noexcept;
+
+  void clear() noexcept;
+
+private:
+  struct block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  std::vector<block> blocks_;
+
+  size_t current_ = 0;
+  size_t used_ = 0;
+};
+
+}
+}
@@ -14,6 +14,30 @@ public:
 
   using lookahead_type = lookahead;
 
+  // Releases external memory. See the external memory constructor below.
+  using deleter = void (*)(uint8_t *data, size_t size, void *context);
+
+  // Process wide buffer counters. Only updated while collection is enabled
+  // with `buffer::collect`.
+  struct statistics {
+    // Memory blocks allocated for non-SSO buffers. External buffers count as
+    // one allocation for their control block.
+    uint64_t allocations;
+    // Memory blocks released again.
+    uint64_t frees;
+    // Bytes (including control blocks) of memory blocks currently allocated.
+    uint64_t live;
+    // Highest value of `live` since the last reset.
+    uint64_t peak;
+    // Buffers stored inline without allocating a memory block.
+    uint64_t sso;
+    // Slices and concatenations that copied their data instead of sharing a
+    // memory block.
+    uint64_t copies;
+    // Bytes copied by those slices and concatenations.
+    uint64_t copied;
+  };
+
   buffer() = default; // NOLINT
   buffer(const uint8_t *data, size_t size);
   buffer(const char *data, size_t size);
@@ -21,6 +45,12 @@ public:
   explicit buffer(size_t size);
   explicit buffer(buffer_view data) noexcept;
 
+  // Wraps `size` bytes of memory at `data` that is owned by someone else (a
+  // receive slab, a memory mapped file, ...) without copying it. `deleter` is
+  // called with `data`, `size` and `context` once this buffer and all slices
+  // of it have been destroyed.
+  buffer(uint8_t *data, size_t size, deleter deleter, void *context);
+
   template<size_t Size>
   buffer(const char (&data)[Size]) noexcept // NOLINT
     : buffer(reinterpret_cast<const uint8_t *>(data), Size - 1)
@@ -51,6 +81,24 @@ public:
 
   void consume(size_t size) noexcept;
 
+  // Returns a view of the remaining bytes. Provided for consistency with the
+  // other sequence types so decoders can process contiguous spans of bytes
+  // without indexing byte per byte.
+  buffer_view contiguous() const noexcept;
+
+  // Makes the reference count of the memory block managed by this buffer
+  // atomic. Afterwards, this buffer and the slices that share its memory block
+  // can be moved to and destroyed on different threads. Call this before the
+  // buffer or any of its slices is handed to another thread.
+  //
+  // Buffers that are never shared keep using non-atomic reference counting.
+  void share() noexcept;
+
+  // Returns true if this buffer can be moved to another thread. Small buffers
+  // that don't use a separate memory block can always be moved to another
+  // thread.
+  bool shared() const noexcept;
+
   // Returns a buffer to the next `size` bytes of this buffer and consumes
   // `size` bytes from this buffer. Both this buffer and the returned buffer
   // will manage different slices of the same memory block.
@@ -64,17 +112,38 @@ public:
 
   static buffer concat(const buffer &first, const buffer &second);
 
+  // Enables or disables collecting statistics. Disabled by default so buffers
+  // don't pay for the counters unless someone is looking at them. Memory
+  // blocks allocated while collection was disabled are not tracked.
+  static void collect(bool enabled) noexcept;
+
+  static statistics stats() noexcept;
+
+  // Zeroes all counters except `live`. `peak` is reset to `live`.
+  static void reset_stats() noexcept;
+
 private:
-  buffer(uint32_t *rc, uint8_t *begin, uint8_t *end) noexcept;
+  friend class buffers;
+
+  // Stored in front of the data of every non-SSO memory block.
+  struct control;
+  // Control block of external memory. Allocated separately from the memory.
+  struct external;
 
-  void rc_(uint32_t *location);
-  uint32_t *rc_();
+  buffer(control *control, uint8_t *begin, uint8_t *end) noexcept;
+
+  void control_(control *location);
+  control *control_();
+  const control *control_() const;
 
   bool sso() const noexcept;
   static bool sso(size_t size) noexcept;
 
   void destroy() noexcept;
 
+  // Records a slice or concatenation that copied `size` bytes.
+  static void copied(size_t size) noexcept;
+
 private:
   static constexpr size_t SSO_THRESHOLD = 20;
 
@@ -106,6 +175,9 @@ public:
   void consume(size_t size) noexcept;
   size_t consumed() const noexcept;
 
+  // Returns a view of the bytes that have not been consumed yet.
+  buffer_view contiguous() const noexcept;
+
 private:
   const buffer &buffer_;
   size_t previous_ = 0;
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <bnl/base/buffer.hpp>
+#include <bnl/base/buffer_view.hpp>
+#include <bnl/base/export.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bnl {
+namespace base {
+
+// Builds a buffer from multiple pieces in a single memory block. Encoders write
+// directly into the builder's memory instead of allocating a separate buffer
+// per piece.
+//
+// Bytes are written in two steps: `reserve` returns a pointer to at least
+// `size` writable bytes and `advance` adds the bytes that were actually
+// written to the buffer. Already written bytes can be modified through
+// `operator[]` which allows backpatching length prefixes once the length is
+// known.
+class BNL_BASE_EXPORT buffer_builder {
+public:
+  buffer_builder() noexcept;
+
+  // `capacity` is the size of the memory blocks allocated by the builder. A
+  // large capacity allows many built buffers to share the same memory block
+  // (e.g. when the builder is used as a receive buffer).
+  explicit buffer_builder(size_t capacity);
+
+  buffer_builder(buffer_builder &&) = default;
+  buffer_builder &operator=(buffer_builder &&) = default;
+
+  // Returns the amount of written bytes.
+  size_t size() const noexcept;
+  bool empty() const noexcept;
+
+  uint8_t *reserve(size_t size);
+  void advance(size_t size) noexcept;
+
+  void append(buffer_view data);
+
+  uint8_t operator[](size_t index) const noexcept;
+  uint8_t &operator[](size_t index) noexcept;
+
+  // Returns a buffer containing the written bytes and resets the builder. The
+  // returned buffer shares its memory block with the builder so unused memory
+  // is reused by the next buffer that is built.
+  buffer finish() noexcept;
+
+private:
+  void grow(size_t size);
+
+private:
+  // Written bytes are stored at the front of `storage_`. The rest of `storage_`
+  // is reserved for future writes.
+  buffer storage_;
+  size_t size_ = 0;
+  size_t capacity_;
+};
+
+}
+}
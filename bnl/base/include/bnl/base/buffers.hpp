@@ -3,7 +3,7 @@
 #include <bnl/base/buffer.hpp>
 #include <bnl/base/export.hpp>
 
-#include <list>
+#include <vector>
 
 namespace bnl {
 namespace base {
@@ -27,7 +27,20 @@ public:
 
   buffer slice(size_t size);
 
+  // Like `slice` but returns the next `size` bytes as slices of the underlying
+  // buffers instead of concatenating them into a single buffer. No memory is
+  // copied except for slices small enough to be stored inline.
+  buffers split(size_t size);
+
   void push(buffer buffer);
+
+  // Like `push` but buffers that are small enough to store their bytes inline
+  // are copied into a memory block shared with other small buffers first. The
+  // views returned by `segments` then stay valid until their bytes are
+  // consumed, even if the buffers are moved (e.g. by `split`). Used for data
+  // that is referred to by pointer until it is acknowledged.
+  void push_stable(buffer buffer);
+
   buffer pop();
 
   const buffer &front() const noexcept;
@@ -35,15 +48,50 @@ public:
 
   void consume(size_t size) noexcept;
 
+  // Returns a view of the longest contiguous run of bytes starting at the
+  // first byte. This is the remainder of the first buffer. The view is
+  // invalidated by any modification of `buffers`.
+  buffer_view contiguous() const noexcept;
+
+  // Stores views of at most `count` buffers in `dest`, starting at the first
+  // byte, and returns the number of views stored. Used to pass the buffers to
+  // vectored I/O functions (`sendmsg`, `writev`, ...) without copying them.
+  // The views are invalidated by any modification of `buffers`.
+  size_t segments(buffer_view *dest, size_t count) const noexcept;
+
 private:
+  struct segment {
+    buffer data;
+    // Position of the end of this buffer counted from the first byte that was
+    // ever pushed. Because buffers are only consumed from the front, the end
+    // position of a buffer never changes.
+    size_t end;
+  };
+
   void discard();
 
-  buffer concat(std::list<buffer>::iterator start,
-                std::list<buffer>::iterator end,
-                size_t left) const;
+  size_t find(size_t position) const noexcept;
+
+  buffer_view contiguous(size_t index) const noexcept;
+
+  buffer concat(size_t start, size_t end, size_t left) const;
 
 private:
-  std::list<buffer> buffers_;
+  // Buffers before `first_` have been fully consumed. They are removed from
+  // the vector in bulk to keep `consume` and `pop` amortized O(1).
+  std::vector<segment> buffers_;
+  size_t first_ = 0;
+
+  size_t begin_ = 0;
+  size_t end_ = 0;
+
+  // Unused part of the memory block that small buffers are copied into by
+  // `push_stable`.
+  buffer stable_;
+
+  // Index of the buffer that contained the last byte accessed through
+  // `operator[]`. Speeds up the sequential access pattern used by decoders.
+  mutable size_t cursor_ = 0;
 };
 
 class BNL_BASE_EXPORT buffers::lookahead {
@@ -69,6 +117,11 @@ public:
   void consume(size_t size) noexcept;
   size_t consumed() const noexcept;
 
+  // Returns a view of the longest contiguous run of bytes starting at the
+  // current position. Decoders use this to process bytes straight from memory
+  // and only fall back to indexing when a value spans multiple buffers.
+  buffer_view contiguous() const noexcept;
+
 private:
   const buffers &buffers_;
   size_t previous_ = 0;
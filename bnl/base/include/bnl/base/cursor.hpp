@@ -0,0 +1,126 @@
+#pragma once
+
+#include <bnl/base/buffer_view.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace bnl {
+namespace base {
+
+// Non-owning sequence over contiguous memory. Data that's already in memory
+// (e.g. a receive buffer or a memory mapped file) can be decoded through a
+// cursor without copying it into a `buffer` first. The memory has to outlive
+// the cursor and anything decoded from it that refers to it (e.g. header
+// views).
+//
+// All accessors are defined inline so decoding from a cursor compiles down to
+// plain pointer arithmetic.
+class cursor {
+public:
+  class lookahead;
+
+  using lookahead_type = lookahead;
+
+  cursor() = default;
+
+  cursor(const uint8_t *data, size_t size) noexcept
+    : data_(data)
+    , size_(size)
+  {}
+
+  explicit cursor(buffer_view data) noexcept
+    : cursor(data.data(), data.size())
+  {}
+
+  cursor(const cursor &) = default;
+  cursor &operator=(const cursor &) = default;
+
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  uint8_t operator[](size_t index) const noexcept
+  {
+    assert(index < size_);
+    return data_[index];
+  }
+
+  uint8_t operator*() const noexcept
+  {
+    assert(size_ > 0);
+    return *data_;
+  }
+
+  void consume(size_t size) noexcept
+  {
+    assert(size <= size_);
+    data_ += size;
+    size_ -= size;
+  }
+
+  buffer_view contiguous() const noexcept { return { data_, size_ }; }
+
+private:
+  const uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+};
+
+class cursor::lookahead {
+public:
+  using lookahead_type = lookahead;
+
+  lookahead(const cursor &cursor) noexcept // NOLINT
+    : data_(cursor.data_)
+    , size_(cursor.size_)
+  {}
+
+  lookahead(const lookahead &other) noexcept
+    : data_(other.data_ + other.position_)
+    , size_(other.size_ - other.position_)
+  {}
+
+  const lookahead &operator=(const lookahead &) = delete;
+
+  lookahead(lookahead &&) = delete;
+  lookahead &operator=(lookahead &&) = delete;
+
+  ~lookahead() = default;
+
+  size_t size() const noexcept { return size_ - position_; }
+  bool empty() const noexcept { return size() == 0; }
+
+  uint8_t operator[](size_t index) const noexcept
+  {
+    assert(index < size());
+    return data_[position_ + index];
+  }
+
+  uint8_t operator*() const noexcept
+  {
+    assert(!empty());
+    return data_[position_];
+  }
+
+  void consume(size_t size) noexcept
+  {
+    assert(size <= this->size());
+    position_ += size;
+  }
+
+  size_t consumed() const noexcept { return position_; }
+
+  // Returns a view of the bytes that have not been consumed yet.
+  buffer_view contiguous() const noexcept
+  {
+    return { data_ + position_, size() };
+  }
+
+private:
+  const uint8_t *data_;
+  size_t size_;
+  size_t position_ = 0;
+};
+
+}
+}
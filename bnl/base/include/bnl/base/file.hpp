@@ -0,0 +1,50 @@
+#pragma once
+
+#include <bnl/base/buffer.hpp>
+#include <bnl/base/export.hpp>
+#include <bnl/base/result.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+
+namespace bnl {
+namespace base {
+
+// Read-only file whose contents are accessed by memory mapping ranges of it
+// into buffers. Pages are only read from disk when they are accessed so large
+// files can be sent without loading them into memory first.
+class BNL_BASE_EXPORT file {
+public:
+  file() = default;
+
+  file(file &&other) noexcept;
+  file &operator=(file &&other) noexcept;
+
+  ~file() noexcept;
+
+  static result<file, std::error_code> open(const char *path);
+
+  bool valid() const noexcept;
+
+  uint64_t size() const noexcept;
+
+  // Maps `size` bytes starting at `offset` into a buffer. The mapping is
+  // released once the buffer and all slices of it have been destroyed, even
+  // if the file itself is closed before that.
+  //
+  // The mapping is read-only so the buffer must not be modified.
+  result<buffer, std::error_code> map(uint64_t offset, size_t size) const;
+
+private:
+  file(int fd, uint64_t size) noexcept;
+
+  void close() noexcept;
+
+private:
+  int fd_ = -1;
+  uint64_t size_ = 0;
+};
+
+}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <bnl/base/export.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace bnl {
+namespace base {
+namespace memory {
+
+// Allocator used by `base::buffer` to allocate the memory blocks that back
+// non-SSO buffers. `size` passed to `deallocate` is always the size that was
+// passed to the matching `allocate` call.
+class BNL_BASE_EXPORT api {
+public:
+  api() = default;
+
+  virtual ~api() noexcept;
+
+  virtual void *allocate(size_t size) = 0;
+  virtual void deallocate(void *pointer, size_t size) noexcept = 0;
+};
+
+// Forwards every allocation to the global heap.
+class BNL_BASE_EXPORT heap : public api {
+public:
+  heap() = default;
+
+  void *allocate(size_t size) override;
+  void deallocate(void *pointer, size_t size) noexcept override;
+};
+
+// Size class allocator that recycles freed blocks through per-thread free
+// lists so allocations of a known size class don't have to go through the
+// global heap. The size classes include packet sized classes (QUIC packets and
+// full UDP datagrams) and a 64 KiB class. Allocations that don't fit in any
+// size class are forwarded to the global heap.
+//
+// Free lists are shared between all pools on the same thread. A block freed on
+// another thread than the one it was allocated on ends up in the free list of
+// the freeing thread.
+class BNL_BASE_EXPORT pool : public api {
+public:
+  struct statistics {
+    // Allocations served from a free list.
+    uint64_t hits;
+    // Allocations forwarded to the global heap.
+    uint64_t misses;
+  };
+
+  pool() = default;
+
+  void *allocate(size_t size) override;
+  void deallocate(void *pointer, size_t size) noexcept override;
+
+  statistics stats() const noexcept;
+
+private:
+  std::atomic<uint64_t> hits_{ 0 };
+  std::atomic<uint64_t> misses_{ 0 };
+};
+
+}
+
+// Allocator used for all new buffers. Defaults to a `memory::pool`. Set to
+// `nullptr` to allocate directly with `new`. Changing the allocator does not
+// affect existing buffers since each buffer remembers the allocator its memory
+// block was allocated with.
+BNL_BASE_EXPORT extern memory::api *allocator;
+
+}
+}
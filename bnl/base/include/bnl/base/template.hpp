@@ -1,20 +1,28 @@
 #pragma once
 
+#include <bnl/base/buffer.hpp>
+#include <bnl/base/buffers.hpp>
+#include <bnl/base/cursor.hpp>
+
 // Macros for explicit template instantiation. See the http3 codec folder for
 // example usage.
 
 #define BNL_BASE_SEQUENCE_DECL(IMPL)                                           \
   extern IMPL(base::buffer);                                                   \
-  extern IMPL(base::buffers)
+  extern IMPL(base::buffers);                                                  \
+  extern IMPL(base::cursor)
 
 #define BNL_BASE_SEQUENCE_IMPL(IMPL)                                           \
   IMPL(base::buffer);                                                          \
-  IMPL(base::buffers)
+  IMPL(base::buffers);                                                         \
+  IMPL(base::cursor)
 
 #define BNL_BASE_LOOKAHEAD_DECL(IMPL)                                          \
   extern IMPL(base::buffer::lookahead);                                        \
-  extern IMPL(base::buffers::lookahead)
+  extern IMPL(base::buffers::lookahead);                                       \
+  extern IMPL(base::cursor::lookahead)
 
 #define BNL_BASE_LOOKAHEAD_IMPL(IMPL)                                          \
   IMPL(base::buffer::lookahead);                                               \
-  IMPL(base::buffers::lookahead)
+  IMPL(base::buffers::lookahead);                                              \
+  IMPL(base::cursor::lookahead)
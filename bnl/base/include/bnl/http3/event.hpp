@@ -1,28 +1,42 @@
 #pragma once
 
 #include <bnl/base/buffer.hpp>
+#include <bnl/base/buffers.hpp>
 #include <bnl/base/export.hpp>
 #include <bnl/http3/header.hpp>
 #include <bnl/http3/settings.hpp>
 #include <bnl/quic/event.hpp>
 
+#include <vector>
+
 namespace bnl {
 namespace http3 {
 
 class BNL_BASE_EXPORT event {
 public:
-  enum class type { settings, header, body, finished };
+  enum class type { settings, headers, body, finished };
 
   struct payload {
     using settings = http3::settings;
 
-    struct header {
+    struct headers {
       uint64_t id;
       bool fin;
-      http3::header header;
+      // All headers of the header block in the order they were received. The
+      // list and the headers it refers to are owned by the stream and stay
+      // valid until the stream is finished. Convert the headers to
+      // `http3::header` to keep them longer.
+      const std::vector<http3::header_view> *list;
     };
 
-    using body = quic::data;
+    struct body {
+      uint64_t id;
+      bool fin;
+      // DATA frame payload received since the previous body event. The
+      // buffers are slices of the received stream data so the payload is not
+      // copied when it spans multiple QUIC packets.
+      base::buffers buffers;
+    };
 
     struct finished {
       uint64_t id;
@@ -30,7 +44,7 @@ public:
   };
 
   event(payload::settings settings) noexcept; // NOLINT
-  event(payload::header header) noexcept;     // NOLINT
+  event(payload::headers headers) noexcept;   // NOLINT
   event(payload::body body) noexcept;         // NOLINT
   event(payload::finished finished) noexcept; // NOLINT
 
@@ -47,7 +61,7 @@ private:
 public:
   union {
     payload::settings settings;
-    payload::header header;
+    payload::headers headers;
     payload::body body;
     payload::finished finished;
   };
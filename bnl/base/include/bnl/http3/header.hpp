@@ -40,6 +40,7 @@ class BNL_BASE_EXPORT header {
 public:
   header() = default;
   header(base::string name, base::string value) noexcept;
+  explicit header(header_view header);
 
   header(const header &) = default;
   header &operator=(const header &) = default;
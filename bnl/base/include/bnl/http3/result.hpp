@@ -16,6 +16,8 @@ enum class error : uint64_t {
   unexpected_frame = 0x0013,
   malformed_frame = 0x0100,
   qpack_decompression_failed = 0x200,
+  qpack_encoder_stream_error = 0x201,
+  qpack_decoder_stream_error = 0x202,
 
   incomplete = 0x40ULL << 56U,
   idle,
@@ -0,0 +1,66 @@
+#include <bnl/base/arena.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace bnl {
+namespace base {
+
+char *
+arena::allocate(size_t size)
+{
+  // Blocks that are too small for `size` stay unused until the next `clear`.
+  while (current_ < blocks_.size()) {
+    block &block = blocks_[current_];
+
+    if (block.size - used_ >= size) {
+      char *data = block.data.get() + used_;
+      used_ += size;
+      return data;
+    }
+
+    current_++;
+    used_ = 0;
+  }
+
+  size_t block_size = std::max(size, BLOCK_SIZE);
+  blocks_.push_back({ std::unique_ptr<char[]>(new char[block_size]),
+                      block_size });
+
+  current_ = blocks_.size() - 1;
+  used_ = size;
+
+  return blocks_.back().data.get();
+}
+
+void
+arena::shrink(size_t size) noexcept
+{
+  assert(size <= used_);
+  used_ -= size;
+}
+
+arena::marker
+arena::mark() const noexcept
+{
+  return { current_, used_ };
+}
+
+void
+arena::rewind(marker marker) noexcept
+{
+  assert(marker.block <= current_);
+
+  current_ = marker.block;
+  used_ = marker.used;
+}
+
+void
+arena::clear() noexcept
+{
+  current_ = 0;
+  used_ = 0;
+}
+
+}
+}
@@ -1,32 +1,197 @@
 #include <bnl/base/buffer.hpp>
 
+#include <bnl/base/memory.hpp>
+
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <new>
 
 namespace bnl {
 namespace base {
 
+struct buffer::control {
+  control(size_t size, memory::api *allocator) noexcept
+    : rc(1)
+    , size(size)
+    , allocator(allocator)
+  {}
+
+  void acquire() noexcept
+  {
+    if (shared) {
+      rc.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      // Plain load and store instead of a read-modify-write operation so
+      // buffers that are never shared don't pay for the atomic.
+      rc.store(rc.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+    }
+  }
+
+  // Returns true if the last reference to the memory block was released.
+  bool release() noexcept
+  {
+    if (shared) {
+      return rc.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    uint32_t left = rc.load(std::memory_order_relaxed) - 1;
+    rc.store(left, std::memory_order_relaxed);
+
+    return left == 0;
+  }
+
+  std::atomic<uint32_t> rc;
+  // Size of the memory block including the control block.
+  size_t size;
+  // Allocator the memory block was allocated with or `nullptr` if it was
+  // allocated with `new`.
+  memory::api *allocator;
+  // Set by `buffer::share`. Never reset since we can't know when the other
+  // threads stop using the memory block.
+  bool shared = false;
+  // True if this control block is part of an `external` control block.
+  bool external = false;
+  // True if the memory block was allocated while statistics were collected.
+  bool tracked = false;
+};
+
+struct buffer::external : buffer::control {
+  external(uint8_t *data,
+           size_t size,
+           buffer::deleter deleter,
+           void *context,
+           memory::api *allocator) noexcept
+    : control(sizeof(external), allocator)
+    , data(data)
+    , length(size)
+    , deleter(deleter)
+    , context(context)
+  {
+    control::external = true;
+  }
+
+  uint8_t *data;
+  size_t length;
+  buffer::deleter deleter;
+  void *context;
+};
+
+// Counters behind `buffer::stats`. All operations are relaxed since the
+// counters don't synchronize anything.
+struct counters {
+  std::atomic<bool> enabled;
+  std::atomic<uint64_t> allocations;
+  std::atomic<uint64_t> frees;
+  std::atomic<uint64_t> live;
+  std::atomic<uint64_t> peak;
+  std::atomic<uint64_t> sso;
+  std::atomic<uint64_t> copies;
+  std::atomic<uint64_t> copied;
+};
+
+static counters collected = {};
+
+static bool
+collecting() noexcept
+{
+  return collected.enabled.load(std::memory_order_relaxed);
+}
+
+static void
+increment(std::atomic<uint64_t> &counter, uint64_t amount = 1) noexcept
+{
+  counter.fetch_add(amount, std::memory_order_relaxed);
+}
+
+static void
+allocated(size_t size) noexcept
+{
+  increment(collected.allocations);
+
+  uint64_t live =
+    collected.live.fetch_add(size, std::memory_order_relaxed) + size;
+  uint64_t peak = collected.peak.load(std::memory_order_relaxed);
+
+  // `compare_exchange_weak` reloads `peak` if another thread raised it first.
+  while (live > peak && !collected.peak.compare_exchange_weak(
+                          peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+static void
+freed(size_t size) noexcept
+{
+  increment(collected.frees);
+  collected.live.fetch_sub(size, std::memory_order_relaxed);
+}
+
+static void *
+allocate(memory::api *allocator, size_t size)
+{
+  return allocator != nullptr ? allocator->allocate(size)
+                              : new uint8_t[size]; // NOLINT
+}
+
+static void
+deallocate(memory::api *allocator, void *block, size_t size) noexcept
+{
+  if (allocator != nullptr) {
+    allocator->deallocate(block, size);
+  } else {
+    delete[] static_cast<uint8_t *>(block); // NOLINT
+  }
+}
+
 buffer::buffer(size_t size) // NOLINT
 {
   if (sso(size)) {
     begin_ = sso_;
-    rc_(nullptr);
+    control_(nullptr);
+
+    if (collecting()) {
+      increment(collected.sso);
+    }
   } else {
-    // Allocate 4 extra bytes to store the reference count.
-    rc_(reinterpret_cast<uint32_t *>(
-      new uint8_t[sizeof(uint32_t) + size])); // NOLINT
+    // Allocate extra space to store the control block.
+    size_t block_size = sizeof(control) + size;
+    memory::api *allocator = base::allocator;
+    void *block = allocate(allocator, block_size);
 
-    // Initialize the reference count.
-    (*rc_()) = 1;
+    control_(new (block) control(block_size, allocator));
 
-    // The reference count is stored at the begin of the
-    // buffer so the actual data starts at a 4 byte offset.
-    begin_ = reinterpret_cast<uint8_t *>(rc_()) + sizeof(uint32_t);
+    if (collecting()) {
+      control_()->tracked = true;
+      allocated(block_size);
+    }
+
+    // The control block is stored at the begin of the memory block so the
+    // actual data starts right after it.
+    begin_ = reinterpret_cast<uint8_t *>(control_()) + sizeof(control);
   }
 
   end_ = begin_ + size;
 }
 
+buffer::buffer(uint8_t *data, size_t size, deleter deleter, void *context)
+  : begin_(data)
+  , end_(data + size)
+{
+  assert(data != nullptr);
+  assert(deleter != nullptr);
+
+  memory::api *allocator = base::allocator;
+  void *block = allocate(allocator, sizeof(external));
+
+  control_(new (block) external(data, size, deleter, context, allocator));
+
+  if (collecting()) {
+    control_()->tracked = true;
+    allocated(sizeof(external));
+  }
+}
+
 buffer::buffer(const uint8_t *data, size_t size)
   : buffer(size)
 {
@@ -60,12 +225,12 @@ buffer::operator=(buffer &&other) noexcept
       end_ = begin_ + other.size();
       std::copy(other.begin(), other.end(), begin_);
     } else {
-      rc_(other.rc_());
+      control_(other.control_());
       begin_ = other.begin_;
       end_ = other.end_;
     }
 
-    other.rc_(nullptr);
+    other.control_(nullptr);
     other.begin_ = nullptr;
     other.end_ = nullptr;
   }
@@ -155,6 +320,26 @@ buffer::consume(size_t size) noexcept
   begin_ += size;
 }
 
+buffer_view
+buffer::contiguous() const noexcept
+{
+  return { data(), size() };
+}
+
+void
+buffer::share() noexcept
+{
+  if (!sso()) {
+    control_()->shared = true;
+  }
+}
+
+bool
+buffer::shared() const noexcept
+{
+  return sso() || control_()->shared;
+}
+
 void
 buffer::destroy() noexcept
 {
@@ -162,12 +347,23 @@ buffer::destroy() noexcept
     return;
   }
 
-  (*rc_())--;
-  if (*rc_() == 0) {
-    // The reference count pointer conveniently also points to the start of the
-    // allocated array.
-    delete[] reinterpret_cast<uint8_t *>(rc_()); // NOLINT
-    rc_(nullptr);
+  control *control = control_();
+
+  if (control->release()) {
+    if (control->external) {
+      external *block = static_cast<external *>(control);
+      block->deleter(block->data, block->length, block->context);
+    }
+
+    if (control->tracked) {
+      freed(control->size);
+    }
+
+    // The control block pointer conveniently also points to the start of the
+    // allocated memory block.
+    deallocate(control->allocator, control, control->size);
+
+    control_(nullptr);
   }
 }
 
@@ -184,8 +380,9 @@ buffer::slice(size_t size) noexcept
 
   if (sso(size)) {
     result = buffer(data(), size);
+    copied(size);
   } else {
-    result = buffer(rc_(), data(), data() + size);
+    result = buffer(control_(), data(), data() + size);
   }
 
   consume(size);
@@ -206,28 +403,75 @@ buffer::concat(const buffer &first, const buffer &second)
   std::copy_n(first.data(), first.size(), result.data());
   std::copy_n(second.data(), second.size(), result.data() + first.size());
 
+  copied(result.size());
+
   return result;
 }
 
-buffer::buffer(uint32_t *rc, uint8_t *begin, uint8_t *end) noexcept // NOLINT
+void
+buffer::collect(bool enabled) noexcept
+{
+  collected.enabled.store(enabled, std::memory_order_relaxed);
+}
+
+buffer::statistics
+buffer::stats() noexcept
+{
+  return { collected.allocations.load(std::memory_order_relaxed),
+           collected.frees.load(std::memory_order_relaxed),
+           collected.live.load(std::memory_order_relaxed),
+           collected.peak.load(std::memory_order_relaxed),
+           collected.sso.load(std::memory_order_relaxed),
+           collected.copies.load(std::memory_order_relaxed),
+           collected.copied.load(std::memory_order_relaxed) };
+}
+
+void
+buffer::reset_stats() noexcept
+{
+  collected.allocations.store(0, std::memory_order_relaxed);
+  collected.frees.store(0, std::memory_order_relaxed);
+  collected.peak.store(collected.live.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+  collected.sso.store(0, std::memory_order_relaxed);
+  collected.copies.store(0, std::memory_order_relaxed);
+  collected.copied.store(0, std::memory_order_relaxed);
+}
+
+void
+buffer::copied(size_t size) noexcept
+{
+  if (collecting()) {
+    increment(collected.copies);
+    increment(collected.copied, size);
+  }
+}
+
+buffer::buffer(control *control, uint8_t *begin, uint8_t *end) noexcept // NOLINT
   : begin_(begin)
   , end_(end)
 {
-  rc_(rc);
+  control_(control);
   // Increment the reference count.
-  (*rc_())++;
+  control_()->acquire();
 }
 
 void
-buffer::rc_(uint32_t *location)
+buffer::control_(control *location)
 {
-  reinterpret_cast<uint32_t **>(sso_)[0] = location;
+  reinterpret_cast<control **>(sso_)[0] = location;
 }
 
-uint32_t *
-buffer::rc_()
+buffer::control *
+buffer::control_()
 {
-  return reinterpret_cast<uint32_t **>(sso_)[0];
+  return reinterpret_cast<control **>(sso_)[0];
+}
+
+const buffer::control *
+buffer::control_() const
+{
+  return reinterpret_cast<control *const *>(sso_)[0];
 }
 
 bool
@@ -287,5 +531,11 @@ buffer::lookahead::consumed() const noexcept
   return position_;
 }
 
+buffer_view
+buffer::lookahead::contiguous() const noexcept
+{
+  return { buffer_.data() + previous_ + position_, size() };
+}
+
 }
 }
@@ -0,0 +1,91 @@
+#include <bnl/base/buffer_builder.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace bnl {
+namespace base {
+
+// Avoid a series of tiny reallocations when building small buffers.
+static constexpr size_t MIN_CAPACITY = 128;
+
+buffer_builder::buffer_builder() noexcept
+  : capacity_(MIN_CAPACITY)
+{}
+
+buffer_builder::buffer_builder(size_t capacity)
+  : storage_(capacity)
+  , capacity_(std::max(capacity, MIN_CAPACITY))
+{}
+
+size_t
+buffer_builder::size() const noexcept
+{
+  return size_;
+}
+
+bool
+buffer_builder::empty() const noexcept
+{
+  return size() == 0;
+}
+
+uint8_t *
+buffer_builder::reserve(size_t size)
+{
+  if (storage_.size() - size_ < size) {
+    grow(size);
+  }
+
+  return storage_.data() + size_;
+}
+
+void
+buffer_builder::advance(size_t size) noexcept
+{
+  assert(size <= storage_.size() - size_);
+  size_ += size;
+}
+
+void
+buffer_builder::append(buffer_view data)
+{
+  std::copy_n(data.data(), data.size(), reserve(data.size()));
+  advance(data.size());
+}
+
+uint8_t buffer_builder::operator[](size_t index) const noexcept
+{
+  assert(index < size_);
+  return storage_[index];
+}
+
+uint8_t &buffer_builder::operator[](size_t index) noexcept
+{
+  assert(index < size_);
+  return storage_[index];
+}
+
+buffer
+buffer_builder::finish() noexcept
+{
+  buffer result = storage_.slice(size_);
+  size_ = 0;
+
+  return result;
+}
+
+void
+buffer_builder::grow(size_t size)
+{
+  // Grow exponentially when a single buffer outgrows the memory block.
+  size_t capacity = std::max(capacity_, (size_ + size) * 2);
+
+  buffer storage(capacity);
+  std::copy_n(storage_.data(), size_, storage.data());
+
+  storage_ = std::move(storage);
+}
+
+}
+}
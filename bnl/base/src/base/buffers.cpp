@@ -6,28 +6,17 @@
 namespace bnl {
 namespace base {
 
-static std::list<buffer>::iterator
-find_first_not_empty(std::list<buffer> &buffers)
-{
-  for (auto it = buffers.begin(); it != buffers.end(); it++) {
-    if (!it->empty()) {
-      return it;
-    }
-  }
+// Minimum amount of consumed buffers before they are removed from the front of
+// the vector.
+static constexpr size_t COMPACT_THRESHOLD = 16;
 
-  return buffers.end();
-}
+// Size of the memory blocks small buffers are copied into by `push_stable`.
+static constexpr size_t STABLE_BLOCK_SIZE = 1024;
 
 size_t
 buffers::size() const noexcept
 {
-  size_t size = 0;
-
-  for (const buffer &buffer : buffers_) {
-    size += buffer.size();
-  }
-
-  return size;
+  return end_ - begin_;
 }
 
 bool
@@ -40,13 +29,11 @@ uint8_t buffers::operator[](size_t index) const noexcept
 {
   assert(index < size());
 
-  auto it = buffers_.begin();
-  while (it != buffers_.end() && index >= it->size()) {
-    index -= it->size();
-    it++;
-  }
+  size_t position = begin_ + index;
+  const segment &segment = buffers_[find(position)];
+  const buffer &buffer = segment.data;
 
-  return (*it)[index];
+  return buffer[buffer.size() - (segment.end - position)];
 }
 
 uint8_t buffers::operator*() const noexcept
@@ -59,20 +46,25 @@ buffers::slice(size_t size)
 {
   assert(size <= this->size());
 
-  auto begin = find_first_not_empty(buffers_);
-  assert(begin != buffers_.end());
+  size_t begin = first_;
+  while (begin != buffers_.size() && buffers_[begin].data.empty()) {
+    begin++;
+  }
+
+  assert(begin != buffers_.size());
 
-  auto end = begin;
+  size_t end = begin;
   size_t left = size;
-  while (end != buffers_.end() && left > end->size()) {
-    left -= end->size();
+  while (end != buffers_.size() && left > buffers_[end].data.size()) {
+    left -= buffers_[end].data.size();
     end++;
   }
 
-  assert(end != buffers_.end());
+  assert(end != buffers_.size());
 
   if (begin == end) {
-    base::buffer result = begin->slice(left);
+    base::buffer result = buffers_[begin].data.slice(left);
+    begin_ += left;
     discard();
     return result;
   }
@@ -84,31 +76,79 @@ buffers::slice(size_t size)
   return result;
 }
 
+buffers
+buffers::split(size_t size)
+{
+  assert(size <= this->size());
+
+  buffers result;
+
+  while (size != 0) {
+    buffer &front = buffers_[first_].data;
+
+    if (front.size() <= size) {
+      size -= front.size();
+      result.push(pop());
+      continue;
+    }
+
+    result.push(front.slice(size));
+    begin_ += size;
+    size = 0;
+  }
+
+  return result;
+}
+
 void
 buffers::push(buffer buffer)
 {
-  buffers_.emplace_back(std::move(buffer));
+  end_ += buffer.size();
+  buffers_.push_back(segment{ std::move(buffer), end_ });
+}
+
+void
+buffers::push_stable(buffer buffer)
+{
+  if (buffer.empty() || !buffer.sso()) {
+    push(std::move(buffer));
+    return;
+  }
+
+  if (stable_.size() < buffer.size()) {
+    stable_ = base::buffer(STABLE_BLOCK_SIZE);
+  }
+
+  uint8_t *begin = stable_.data();
+  std::copy_n(buffer.data(), buffer.size(), begin);
+  stable_.consume(buffer.size());
+
+  // Share the memory block instead of slicing it since small slices are
+  // copied into inline storage again.
+  push(base::buffer(stable_.control_(), begin, begin + buffer.size()));
 }
 
 buffer
 buffers::pop()
 {
   assert(size() > 0);
-  buffer result = std::move(buffers_.front());
-  buffers_.pop_front();
+  buffer result = std::move(buffers_[first_].data);
+  begin_ += result.size();
+  first_++;
+  discard();
   return result;
 }
 
 const buffer &
 buffers::front() const noexcept
 {
-  return buffers_.front();
+  return buffers_[first_].data;
 }
 
 const buffer &
 buffers::back() const noexcept
 {
-  return buffers_.back();
+  return buffers_.back().data;
 }
 
 void
@@ -116,32 +156,116 @@ buffers::consume(size_t size) noexcept
 {
   assert(size <= this->size());
 
-  for (auto it = buffers_.begin(); size != 0; it++) {
-    size_t to_consume = std::min(size, it->size());
-    it->consume(to_consume);
+  begin_ += size;
+
+  for (size_t i = first_; size != 0; i++) {
+    buffer &buffer = buffers_[i].data;
+    size_t to_consume = std::min(size, buffer.size());
+    buffer.consume(to_consume);
     size -= to_consume;
   }
 
   discard();
 }
 
+buffer_view
+buffers::contiguous() const noexcept
+{
+  return contiguous(0);
+}
+
+buffer_view
+buffers::contiguous(size_t index) const noexcept
+{
+  if (index == size()) {
+    return {};
+  }
+
+  size_t position = begin_ + index;
+  const segment &segment = buffers_[find(position)];
+  const buffer &buffer = segment.data;
+  size_t left = segment.end - position;
+
+  return { buffer.data() + buffer.size() - left, left };
+}
+
+size_t
+buffers::segments(buffer_view *dest, size_t count) const noexcept
+{
+  size_t stored = 0;
+
+  for (size_t i = first_; i != buffers_.size() && stored != count; i++) {
+    const buffer &buffer = buffers_[i].data;
+
+    if (buffer.empty()) {
+      continue;
+    }
+
+    dest[stored++] = buffer;
+  }
+
+  return stored;
+}
+
 void
 buffers::discard()
 {
-  auto it = buffers_.begin();
-  while (it != buffers_.end() && it->empty()) {
-    it = buffers_.erase(it);
+  while (first_ != buffers_.size() && buffers_[first_].data.empty()) {
+    // Release the memory of consumed buffers immediately.
+    buffers_[first_].data = buffer();
+    first_++;
+  }
+
+  if (first_ == buffers_.size()) {
+    buffers_.clear();
+    first_ = 0;
+    cursor_ = 0;
+    return;
+  }
+
+  if (first_ >= COMPACT_THRESHOLD && first_ >= buffers_.size() / 2) {
+    auto begin = buffers_.begin();
+    buffers_.erase(begin, begin + static_cast<std::ptrdiff_t>(first_));
+    first_ = 0;
+    cursor_ = 0;
   }
 }
 
+size_t
+buffers::find(size_t position) const noexcept
+{
+  // Decoders mostly access bytes sequentially so we first check the buffer
+  // that was used for the previous access and the one right after it.
+  for (size_t i = std::max(cursor_, first_);
+       i < buffers_.size() && i <= cursor_ + 1;
+       i++) {
+    const segment &segment = buffers_[i];
+
+    if (position < segment.end &&
+        position >= segment.end - segment.data.size()) {
+      cursor_ = i;
+      return i;
+    }
+  }
+
+  auto begin = buffers_.begin() + static_cast<std::ptrdiff_t>(first_);
+  auto match = std::upper_bound(
+    begin, buffers_.end(), position, [](size_t position, const segment &segment) {
+      return position < segment.end;
+    });
+
+  assert(match != buffers_.end());
+
+  cursor_ = static_cast<size_t>(match - buffers_.begin());
+  return cursor_;
+}
+
 buffer
-buffers::concat(std::list<buffer>::iterator start,
-                std::list<buffer>::iterator end,
-                size_t left) const
+buffers::concat(size_t start, size_t end, size_t left) const
 {
   size_t size = 0;
-  for (auto it = start; it != end; it++) {
-    size += it->size();
+  for (size_t i = start; i != end; i++) {
+    size += buffers_[i].data.size();
   }
 
   size += left;
@@ -149,12 +273,15 @@ buffers::concat(std::list<buffer>::iterator start,
   buffer result(size);
   size_t offset = 0;
 
-  for (auto it = start; it != end; it++) {
-    std::copy_n(it->data(), it->size(), result.data() + offset);
-    offset += it->size();
+  for (size_t i = start; i != end; i++) {
+    const buffer &buffer = buffers_[i].data;
+    std::copy_n(buffer.data(), buffer.size(), result.data() + offset);
+    offset += buffer.size();
   }
 
-  std::copy_n(end->data(), left, result.data() + offset);
+  std::copy_n(buffers_[end].data.data(), left, result.data() + offset);
+
+  buffer::copied(size);
 
   return result;
 }
@@ -204,5 +331,11 @@ buffers::lookahead::consumed() const noexcept
   return position_;
 }
 
+buffer_view
+buffers::lookahead::contiguous() const noexcept
+{
+  return buffers_.contiguous(previous_ + position_);
+}
+
 }
 }
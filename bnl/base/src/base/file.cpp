@@ -0,0 +1,161 @@
+#include <bnl/base/file.hpp>
+
+#include <cassert>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bnl {
+namespace base {
+
+file::file(int fd, uint64_t size) noexcept
+  : fd_(fd)
+  , size_(size)
+{}
+
+file::file(file &&other) noexcept
+  : file()
+{
+  operator=(std::move(other));
+}
+
+file &
+file::operator=(file &&other) noexcept
+{
+  if (&other != this) {
+    close();
+
+    fd_ = other.fd_;
+    size_ = other.size_;
+
+    other.fd_ = -1;
+    other.size_ = 0;
+  }
+
+  return *this;
+}
+
+file::~file() noexcept
+{
+  close();
+}
+
+bool
+file::valid() const noexcept
+{
+  return fd_ != -1;
+}
+
+uint64_t
+file::size() const noexcept
+{
+  return size_;
+}
+
+#if defined(_WIN32)
+
+result<file, std::error_code>
+file::open(const char *path)
+{
+  (void) path;
+  return std::make_error_code(std::errc::function_not_supported);
+}
+
+result<buffer, std::error_code>
+file::map(uint64_t offset, size_t size) const
+{
+  (void) offset;
+  (void) size;
+  return std::make_error_code(std::errc::function_not_supported);
+}
+
+void
+file::close() noexcept
+{}
+
+#else
+
+static std::error_code
+last_error() noexcept
+{
+  return { errno, std::system_category() };
+}
+
+result<file, std::error_code>
+file::open(const char *path)
+{
+  int fd = ::open(path, O_RDONLY | O_CLOEXEC); // NOLINT
+  if (fd == -1) {
+    return last_error();
+  }
+
+  struct stat stat = {};
+
+  int rv = ::fstat(fd, &stat);
+  if (rv == -1) {
+    std::error_code error = last_error();
+    ::close(fd);
+    return error;
+  }
+
+  return file(fd, static_cast<uint64_t>(stat.st_size));
+}
+
+static void
+unmap(uint8_t *data, size_t size, void *context)
+{
+  (void) context;
+  ::munmap(data, size);
+}
+
+result<buffer, std::error_code>
+file::map(uint64_t offset, size_t size) const
+{
+  assert(valid());
+
+  if (offset > size_ || size > size_ - offset) {
+    return std::make_error_code(std::errc::invalid_argument);
+  }
+
+  if (size == 0) {
+    return buffer();
+  }
+
+  // `mmap` requires the offset to be a multiple of the page size.
+  uint64_t page_size = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+  size_t alignment = static_cast<size_t>(offset % page_size);
+
+  void *mapping = ::mmap(nullptr,
+                         alignment + size,
+                         PROT_READ,
+                         MAP_PRIVATE,
+                         fd_,
+                         static_cast<off_t>(offset - alignment));
+  if (mapping == MAP_FAILED) { // NOLINT
+    return last_error();
+  }
+
+  buffer result(static_cast<uint8_t *>(mapping), alignment + size, unmap,
+                nullptr);
+  result.consume(alignment);
+
+  return result;
+}
+
+void
+file::close() noexcept
+{
+  if (fd_ != -1) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+#endif
+
+}
+}
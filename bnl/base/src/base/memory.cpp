@@ -0,0 +1,169 @@
+#include <bnl/base/memory.hpp>
+
+#include <cassert>
+#include <new>
+
+namespace bnl {
+namespace base {
+namespace memory {
+
+api::~api() noexcept = default;
+
+void *
+heap::allocate(size_t size)
+{
+  return new uint8_t[size]; // NOLINT
+}
+
+void
+heap::deallocate(void *pointer, size_t size) noexcept
+{
+  (void) size;
+  delete[] static_cast<uint8_t *>(pointer); // NOLINT
+}
+
+// Sizes include the buffer's control block. 1280 fits the largest QUIC packet
+// ngtcp2 writes over IPv4 and 1536 a full Ethernet sized UDP datagram. The
+// largest class leaves room for a full 64 KiB buffer plus its control block.
+static constexpr size_t SIZE_CLASSES[] = { 64,   256,   1280, 1536,
+                                           4096, 16384, 66560 };
+static constexpr size_t NUM_SIZE_CLASSES =
+  sizeof(SIZE_CLASSES) / sizeof(SIZE_CLASSES[0]);
+
+// Maximum number of free blocks kept per size class per thread. Blocks freed
+// when the free list is full go back to the global heap.
+static constexpr size_t FREE_LIST_LIMIT = 256;
+
+struct node {
+  node *next;
+};
+
+struct cache {
+  node *free[NUM_SIZE_CLASSES];
+  size_t size[NUM_SIZE_CLASSES];
+  bool released;
+};
+
+// `cache` is trivially destructible so it stays usable after
+// `release_on_exit` ran which allows buffers that are destroyed late during
+// thread exit to still be freed.
+static thread_local cache local = {};
+
+static void
+release(cache &cache) noexcept
+{
+  for (size_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+    while (cache.free[i] != nullptr) {
+      node *block = cache.free[i];
+      cache.free[i] = block->next;
+      ::operator delete(block);
+    }
+
+    cache.size[i] = 0;
+  }
+}
+
+struct release_on_exit {
+  ~release_on_exit() noexcept
+  {
+    release(local);
+    local.released = true;
+  }
+};
+
+static cache &
+thread_cache() noexcept
+{
+  // Registers the destructor that returns the free blocks of this thread to
+  // the global heap when the thread exits.
+  static thread_local release_on_exit guard;
+  (void) guard;
+
+  return local;
+}
+
+static size_t
+size_class(size_t size) noexcept
+{
+  size_t i = 0;
+  while (i < NUM_SIZE_CLASSES && size > SIZE_CLASSES[i]) {
+    i++;
+  }
+
+  return i;
+}
+
+void *
+pool::allocate(size_t size)
+{
+  size_t index = size_class(size);
+
+  if (index == NUM_SIZE_CLASSES) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(size);
+  }
+
+  cache &cache = thread_cache();
+  node *block = cache.free[index];
+
+  if (block == nullptr) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(SIZE_CLASSES[index]);
+  }
+
+  cache.free[index] = block->next;
+  cache.size[index]--;
+
+  hits_.fetch_add(1, std::memory_order_relaxed);
+
+  return block;
+}
+
+void
+pool::deallocate(void *pointer, size_t size) noexcept
+{
+  size_t index = size_class(size);
+
+  if (index == NUM_SIZE_CLASSES) {
+    ::operator delete(pointer);
+    return;
+  }
+
+  cache &cache = thread_cache();
+
+  if (cache.released || cache.size[index] == FREE_LIST_LIMIT) {
+    ::operator delete(pointer);
+    return;
+  }
+
+  node *block = static_cast<node *>(pointer);
+  block->next = cache.free[index];
+
+  cache.free[index] = block;
+  cache.size[index]++;
+}
+
+pool::statistics
+pool::stats() const noexcept
+{
+  return { hits_.load(std::memory_order_relaxed),
+           misses_.load(std::memory_order_relaxed) };
+}
+
+}
+
+// Never destroyed so buffers that are freed by other static destructors can
+// still return their memory to the pool. Buffers allocated by static
+// constructors that run before `allocator` is initialized use `new` instead
+// and remember that.
+static memory::pool *
+default_pool()
+{
+  static memory::pool *pool = new memory::pool();
+  return pool;
+}
+
+memory::api *allocator = default_pool();
+
+}
+}
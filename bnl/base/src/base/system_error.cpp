@@ -37,6 +37,10 @@ error_category_impl::message(int code) const noexcept
       return "malformed frame";
     case error::qpack_decompression_failed:
       return "qpack decompression failed";
+    case error::qpack_encoder_stream_error:
+      return "qpack encoder stream error";
+    case error::qpack_decoder_stream_error:
+      return "qpack decoder stream error";
     case error::not_implemented:
       return "not implemented";
     case error::varint_overflow:
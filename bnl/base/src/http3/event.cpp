@@ -8,9 +8,9 @@ event::event(payload::settings settings) noexcept // NOLINT
   , settings(settings)
 {}
 
-event::event(payload::header header) noexcept // NOLINT
-  : type_(event::type::header)
-  , header(std::move(header))
+event::event(payload::headers headers) noexcept // NOLINT
+  : type_(event::type::headers)
+  , headers(headers)
 {}
 
 event::event(payload::body body) noexcept // NOLINT
@@ -30,8 +30,8 @@ event::event(event &&other) noexcept // NOLINT
     case event::type::settings:
       new (&settings) payload::settings(other.settings);
       break;
-    case event::type::header:
-      new (&header) payload::header(std::move(other.header));
+    case event::type::headers:
+      new (&headers) payload::headers(other.headers);
       break;
     case event::type::body:
       new (&body) payload::body(std::move(other.body));
@@ -58,8 +58,8 @@ event::~event() noexcept
     case event::type::settings:
       destroy(settings);
       break;
-    case event::type::header:
-      destroy(header);
+    case event::type::headers:
+      destroy(headers);
       break;
     case event::type::body:
       destroy(body);
@@ -58,6 +58,11 @@ header::header(base::string name, base::string value) noexcept
   , value_(std::move(value))
 {}
 
+header::header(header_view header)
+  : name_(header.name().data(), header.name().size())
+  , value_(header.value().data(), header.value().size())
+{}
+
 base::string_view
 header::name() const noexcept
 {
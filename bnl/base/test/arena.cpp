@@ -0,0 +1,66 @@
+#include <doctest.h>
+
+#include <bnl/base/arena.hpp>
+
+#include <cstring>
+
+using namespace bnl;
+
+TEST_CASE("arena")
+{
+  base::arena arena;
+
+  SUBCASE("allocate")
+  {
+    char *first = arena.allocate(3);
+    char *second = arena.allocate(5);
+
+    REQUIRE(second == first + 3);
+
+    std::memcpy(first, "abc", 3);
+    std::memcpy(second, "defgh", 5);
+
+    REQUIRE(std::memcmp(first, "abcdefgh", 8) == 0);
+  }
+
+  SUBCASE("large allocation")
+  {
+    arena.allocate(10);
+
+    // Allocations larger than a block get a block of their own.
+    char *large = arena.allocate(base::arena::BLOCK_SIZE * 2);
+    std::memset(large, 'a', base::arena::BLOCK_SIZE * 2);
+
+    char *next = arena.allocate(10);
+    REQUIRE((next < large || next >= large + base::arena::BLOCK_SIZE * 2));
+  }
+
+  SUBCASE("shrink")
+  {
+    char *first = arena.allocate(10);
+    arena.shrink(6);
+
+    REQUIRE(arena.allocate(1) == first + 4);
+  }
+
+  SUBCASE("rewind")
+  {
+    arena.allocate(10);
+    base::arena::marker marker = arena.mark();
+
+    char *first = arena.allocate(base::arena::BLOCK_SIZE);
+    arena.rewind(marker);
+
+    REQUIRE(arena.allocate(base::arena::BLOCK_SIZE) == first);
+  }
+
+  SUBCASE("clear")
+  {
+    char *first = arena.allocate(10);
+    arena.allocate(base::arena::BLOCK_SIZE);
+    arena.clear();
+
+    // Blocks are reused after clearing.
+    REQUIRE(arena.allocate(10) == first);
+  }
+}
@@ -62,4 +62,102 @@ TEST_CASE("buffer")
     base::buffer second = data.slice(1);
     REQUIRE(second[0] == 'd');
   }
+
+  SUBCASE("share")
+  {
+    base::buffer data(1000);
+    REQUIRE(!data.shared());
+
+    base::buffer first = data.slice(100);
+
+    data.share();
+    REQUIRE(data.shared());
+    REQUIRE(first.shared());
+
+    base::buffer second = data.slice(100);
+    REQUIRE(second.shared());
+
+    base::buffer small(10);
+    REQUIRE(small.shared());
+  }
+}
+
+static void
+release(uint8_t *data, size_t size, void *context)
+{
+  (void) data;
+  (void) size;
+  *static_cast<bool *>(context) = true;
+}
+
+TEST_CASE("buffer: external")
+{
+  uint8_t memory[100] = {};
+  memory[50] = 10;
+
+  bool released = false;
+
+  {
+    base::buffer data(memory, sizeof(memory), release, &released);
+    REQUIRE(data.data() == memory);
+    REQUIRE(data[50] == 10);
+
+    data.consume(10);
+    base::buffer slice = data.slice(50);
+    REQUIRE(slice.data() == memory + 10);
+
+    data = base::buffer();
+    REQUIRE(!released);
+  }
+
+  REQUIRE(released);
+}
+
+TEST_CASE("buffer: statistics")
+{
+  base::buffer::collect(true);
+  base::buffer::reset_stats();
+
+  base::buffer::statistics before = base::buffer::stats();
+
+  {
+    base::buffer data(1000);
+    base::buffer small(10);
+    REQUIRE(small.size() == 10);
+
+    base::buffer first = data.slice(500);
+    base::buffer second = data.slice(10);
+    REQUIRE(second.size() == 10);
+
+    base::buffer::statistics during = base::buffer::stats();
+    REQUIRE(during.allocations == before.allocations + 1);
+    REQUIRE(during.frees == before.frees);
+    REQUIRE(during.live > before.live + 1000);
+    REQUIRE(during.peak >= during.live);
+    // `small` and the copy made by the second slice.
+    REQUIRE(during.sso == before.sso + 2);
+    REQUIRE(during.copies == before.copies + 1);
+    REQUIRE(during.copied == before.copied + 10);
+
+    base::buffer::concat(first, data);
+
+    during = base::buffer::stats();
+    REQUIRE(during.allocations == before.allocations + 2);
+    REQUIRE(during.frees == before.frees + 1);
+    REQUIRE(during.copies == before.copies + 2);
+    REQUIRE(during.copied == before.copied + 10 + 990);
+  }
+
+  base::buffer::statistics after = base::buffer::stats();
+  REQUIRE(after.frees == after.allocations);
+  REQUIRE(after.live == before.live);
+  REQUIRE(after.peak > after.live);
+
+  base::buffer::collect(false);
+
+  {
+    base::buffer data(1000);
+  }
+
+  REQUIRE(base::buffer::stats().allocations == after.allocations);
 }
@@ -0,0 +1,75 @@
+#include <doctest.h>
+
+#include <bnl/base/buffer_builder.hpp>
+
+using namespace bnl;
+
+TEST_CASE("buffer builder")
+{
+  base::buffer_builder builder;
+
+  SUBCASE("append")
+  {
+    builder.append("abc");
+    builder.append("defgh");
+
+    REQUIRE(builder.size() == 8);
+
+    base::buffer result = builder.finish();
+
+    REQUIRE(result == "abcdefgh");
+    REQUIRE(builder.empty());
+  }
+
+  SUBCASE("reserve")
+  {
+    uint8_t *dest = builder.reserve(10);
+    dest[0] = 'a';
+    dest[1] = 'b';
+    builder.advance(2);
+
+    REQUIRE(builder.size() == 2);
+    REQUIRE(builder.finish() == "ab");
+  }
+
+  SUBCASE("backpatch")
+  {
+    builder.append("a");
+    builder.append("bcd");
+    builder[0] = 'z';
+
+    REQUIRE(builder.finish() == "zbcd");
+  }
+
+  SUBCASE("grow")
+  {
+    base::buffer data(1000);
+    std::fill(data.begin(), data.end(), 'x');
+
+    builder.append("abc");
+    builder.append(data);
+    builder.append(data);
+
+    base::buffer result = builder.finish();
+
+    REQUIRE(result.size() == 2003);
+    REQUIRE(result[0] == 'a');
+    REQUIRE(result[2002] == 'x');
+  }
+
+  SUBCASE("reuse")
+  {
+    base::buffer_builder builder(1000);
+
+    builder.append("abcdefghijklmnopqrstuvwxyz");
+    base::buffer first = builder.finish();
+
+    builder.append("zyxwvutsrqponmlkjihgfedcba");
+    base::buffer second = builder.finish();
+
+    REQUIRE(first == "abcdefghijklmnopqrstuvwxyz");
+    REQUIRE(second == "zyxwvutsrqponmlkjihgfedcba");
+    // Both buffers are slices of the same memory block.
+    REQUIRE(second.data() == first.data() + first.size());
+  }
+}
@@ -22,3 +22,168 @@ TEST_CASE("buffers")
 
   buffers.consume(5);
 }
+
+TEST_CASE("buffers: random access")
+{
+  base::buffers buffers;
+
+  for (uint8_t i = 0; i < 100; i++) {
+    base::buffer buffer(i % 3 + 1);
+    std::fill_n(buffer.data(), buffer.size(), i);
+    buffers.push(std::move(buffer));
+  }
+
+  REQUIRE(buffers.size() == 199);
+
+  SUBCASE("index")
+  {
+    REQUIRE(buffers[0] == 0);
+    REQUIRE(buffers[198] == 99);
+    REQUIRE(buffers[3] == 2);
+    REQUIRE(buffers[1] == 1);
+    REQUIRE(buffers[197] == 98);
+  }
+
+  SUBCASE("consume")
+  {
+    buffers.consume(150);
+
+    REQUIRE(buffers.size() == 49);
+    REQUIRE(buffers[48] == 99);
+
+    base::buffer slice = buffers.slice(10);
+    REQUIRE(slice.size() == 10);
+    REQUIRE(buffers.size() == 39);
+
+    while (!buffers.empty()) {
+      buffers.pop();
+    }
+
+    REQUIRE(buffers.size() == 0);
+  }
+}
+
+TEST_CASE("buffers: contiguous")
+{
+  base::buffers buffers;
+  buffers.push("abc");
+  buffers.push("defgh");
+
+  REQUIRE(buffers.contiguous() == "abc");
+
+  base::buffers::lookahead lookahead(buffers);
+  lookahead.consume(2);
+  REQUIRE(lookahead.contiguous() == "c");
+
+  lookahead.consume(2);
+  REQUIRE(lookahead.contiguous() == "efgh");
+
+  lookahead.consume(4);
+  REQUIRE(lookahead.contiguous().empty());
+
+  buffers.consume(4);
+  REQUIRE(buffers.contiguous() == "efgh");
+}
+
+TEST_CASE("buffers: split")
+{
+  base::buffers buffers;
+
+  base::buffer first(100);
+  base::buffer second(100);
+  const uint8_t *data = second.data();
+
+  buffers.push(std::move(first));
+  buffers.push(std::move(second));
+
+  base::buffers split = buffers.split(150);
+
+  REQUIRE(split.size() == 150);
+  REQUIRE(buffers.size() == 50);
+
+  split.pop();
+  REQUIRE(split.front().data() == data);
+  REQUIRE(buffers.front().data() == data + 50);
+}
+
+TEST_CASE("buffers: split segments")
+{
+  // Mimics a QUIC stream write that spans multiple segments: the segments are
+  // handed out as views and the written range is split off to keep them alive.
+  base::buffers sent;
+  base::buffer_view segments[3];
+
+  {
+    base::buffers buffers;
+
+    for (uint8_t i = 0; i < 3; i++) {
+      base::buffer buffer(64);
+      std::fill_n(buffer.data(), buffer.size(), i);
+      buffers.push(std::move(buffer));
+    }
+
+    REQUIRE(buffers.segments(segments, 3) == 3);
+
+    sent = buffers.split(150);
+  }
+
+  // The split buffers share the memory of the views instead of copying it.
+  REQUIRE(sent.size() == 150);
+
+  for (size_t i = 0; i < 3; i++) {
+    const base::buffer &buffer = sent.front();
+    REQUIRE(buffer.data() == segments[i].data());
+
+    for (size_t j = 0; j < buffer.size(); j++) {
+      REQUIRE(segments[i].data()[j] == i);
+    }
+
+    sent.pop();
+  }
+}
+
+TEST_CASE("buffers: push stable")
+{
+  base::buffers sent;
+  base::buffer_view segments[3];
+
+  {
+    base::buffers buffers;
+    buffers.push_stable("abc");
+    buffers.push_stable("defgh");
+    buffers.push_stable("ij");
+
+    REQUIRE(buffers.segments(segments, 3) == 3);
+
+    // Moving the small buffers doesn't move their bytes.
+    sent = buffers.split(buffers.size());
+  }
+
+  REQUIRE(sent.size() == 10);
+
+  REQUIRE(segments[0] == "abc");
+  REQUIRE(segments[1] == "defgh");
+  REQUIRE(segments[2] == "ij");
+
+  for (const base::buffer_view &segment : segments) {
+    REQUIRE(sent.front().data() == segment.data());
+    sent.pop();
+  }
+}
+
+TEST_CASE("buffers: segments")
+{
+  base::buffers buffers;
+  buffers.push("abc");
+  buffers.push("defgh");
+  buffers.push("ij");
+
+  buffers.consume(1);
+
+  base::buffer_view segments[2];
+  size_t count = buffers.segments(segments, 2);
+
+  REQUIRE(count == 2);
+  REQUIRE(segments[0] == "bc");
+  REQUIRE(segments[1] == "defgh");
+}
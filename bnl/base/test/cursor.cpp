@@ -0,0 +1,54 @@
+#include <doctest.h>
+
+#include <bnl/base/buffer.hpp>
+#include <bnl/base/cursor.hpp>
+
+using namespace bnl;
+
+TEST_CASE("cursor")
+{
+  base::buffer buffer = "abcdefgh";
+  base::cursor cursor(buffer);
+
+  REQUIRE(cursor.size() == 8);
+  REQUIRE(*cursor == 'a');
+  REQUIRE(cursor[7] == 'h');
+
+  SUBCASE("consume")
+  {
+    cursor.consume(3);
+
+    REQUIRE(cursor.size() == 5);
+    REQUIRE(*cursor == 'd');
+    REQUIRE(cursor.contiguous().data() == buffer.data() + 3);
+
+    cursor.consume(5);
+    REQUIRE(cursor.empty());
+  }
+
+  SUBCASE("lookahead")
+  {
+    cursor.consume(2);
+
+    base::cursor::lookahead lookahead(cursor);
+    REQUIRE(lookahead.size() == 6);
+    REQUIRE(*lookahead == 'c');
+
+    lookahead.consume(2);
+    REQUIRE(lookahead.consumed() == 2);
+    REQUIRE(lookahead[0] == 'e');
+    REQUIRE(lookahead.contiguous().size() == 4);
+
+    base::cursor::lookahead nested(lookahead);
+    REQUIRE(nested.consumed() == 0);
+    REQUIRE(*nested == 'e');
+
+    nested.consume(4);
+    REQUIRE(nested.empty());
+
+    // The cursor isn't modified until the lookahead is committed.
+    REQUIRE(cursor.size() == 6);
+    cursor.consume(lookahead.consumed());
+    REQUIRE(*cursor == 'e');
+  }
+}
@@ -0,0 +1,84 @@
+#include <doctest.h>
+
+#include <bnl/base/file.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <unistd.h>
+
+using namespace bnl;
+
+// Creates a uniquely named file in the temporary directory and removes it
+// again when it goes out of scope, even if a check fails.
+class temporary {
+public:
+  temporary()
+  {
+    const char *directory = std::getenv("TMPDIR");
+    path_ = std::string(directory != nullptr ? directory : "/tmp") +
+            "/bnl-test-file-XXXXXX";
+
+    fd_ = mkstemp(&path_[0]);
+  }
+
+  temporary(const temporary &) = delete;
+  temporary &operator=(const temporary &) = delete;
+
+  ~temporary()
+  {
+    if (fd_ >= 0) {
+      std::remove(path_.c_str());
+    }
+  }
+
+  int fd() const noexcept { return fd_; }
+  const char *path() const noexcept { return path_.c_str(); }
+
+private:
+  std::string path_;
+  int fd_ = -1;
+};
+
+TEST_CASE("file")
+{
+  temporary temporary;
+  REQUIRE(temporary.fd() >= 0);
+
+  {
+    std::FILE *stream = fdopen(temporary.fd(), "wb");
+    REQUIRE(stream != nullptr);
+
+    for (size_t i = 0; i < 10000; i++) {
+      std::fputc(static_cast<int>('a' + i % 26), stream);
+    }
+
+    std::fclose(stream);
+  }
+
+  base::file file = base::file::open(temporary.path()).value();
+  REQUIRE(file.size() == 10000);
+
+  SUBCASE("map")
+  {
+    base::buffer data = file.map(5000, 100).value();
+
+    REQUIRE(data.size() == 100);
+    REQUIRE(data[0] == 'a' + 5000 % 26);
+
+    base::buffer slice = data.slice(50);
+
+    // The mapping stays valid after the file and the original buffer are
+    // gone.
+    file = base::file();
+    data = base::buffer();
+
+    REQUIRE(slice[49] == 'a' + 5049 % 26);
+  }
+
+  SUBCASE("map: out of range")
+  {
+    REQUIRE(!file.map(9000, 2000));
+  }
+}
@@ -0,0 +1,74 @@
+#include <doctest.h>
+
+#include <bnl/base/buffer.hpp>
+#include <bnl/base/memory.hpp>
+
+using namespace bnl;
+
+TEST_CASE("memory")
+{
+  base::memory::api *previous = base::allocator;
+
+  SUBCASE("pool")
+  {
+    base::memory::pool pool;
+    base::allocator = &pool;
+
+    const uint8_t *data = nullptr;
+
+    {
+      base::buffer first(1200);
+      data = first.data();
+    }
+
+    base::memory::pool::statistics before = pool.stats();
+
+    // The block of `first` is reused from the free list.
+    base::buffer second(1200);
+    REQUIRE(second.data() == data);
+
+    base::memory::pool::statistics after = pool.stats();
+    REQUIRE(after.hits == before.hits + 1);
+    REQUIRE(after.misses == before.misses);
+  }
+
+  SUBCASE("pool: oversized")
+  {
+    base::memory::pool pool;
+    base::allocator = &pool;
+
+    base::buffer data(1024 * 1024);
+    data[1024 * 1024 - 1] = 24;
+
+    REQUIRE(pool.stats().hits == 0);
+    REQUIRE(pool.stats().misses == 1);
+  }
+
+  SUBCASE("sso")
+  {
+    base::memory::pool pool;
+    base::allocator = &pool;
+
+    base::buffer data(10);
+
+    REQUIRE(pool.stats().hits == 0);
+    REQUIRE(pool.stats().misses == 0);
+  }
+
+  SUBCASE("switch")
+  {
+    base::memory::heap heap;
+    base::allocator = &heap;
+
+    base::buffer first(1000);
+    first[999] = 100;
+
+    // Buffers are freed with the allocator they were allocated with.
+    base::allocator = nullptr;
+
+    base::buffer second = first.slice(1000);
+    REQUIRE(second[999] == 100);
+  }
+
+  base::allocator = previous;
+}
@@ -299,12 +299,16 @@ run(int argc, char *argv[])
       case http3::event::type::settings:
         break;
 
-      case http3::event::type::header:
-        headers.emplace_back(std::move(event.header.header));
+      case http3::event::type::headers:
+        for (http3::header_view header : *event.headers.list) {
+          headers.emplace_back(header);
+        }
         break;
 
       case http3::event::type::body:
-        body = base::buffer::concat(body, event.body.buffer);
+        while (!event.body.buffers.empty()) {
+          body = base::buffer::concat(body, event.body.buffers.pop());
+        }
         break;
 
       case http3::event::type::finished:
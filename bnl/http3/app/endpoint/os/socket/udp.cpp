@@ -3,9 +3,31 @@
 #include <bnl/base/log.hpp>
 
 #include <arpa/inet.h>
+#include <array>
 #include <cassert>
 #include <sys/epoll.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+// Maximum amount of datagrams sent with a single system call.
+static constexpr size_t SEND_BATCH_SIZE = 16;
+
+// Full Ethernet sized UDP datagram. QUIC peers don't send larger datagrams
+// unless they probed the path for a larger MTU.
+static constexpr size_t MAX_DATAGRAM_SIZE = 1500;
+
+// Amount of full sized datagrams received into a single memory block. A
+// block (and its control block) fits the 16 KiB size class of the default
+// allocator so a datagram that's still in use doesn't keep a much larger
+// block alive.
+static constexpr size_t RECV_BATCH_SIZE = 10;
+static constexpr size_t RECV_BLOCK_SIZE = RECV_BATCH_SIZE * MAX_DATAGRAM_SIZE;
+
+// Datagrams up to this size (e.g. ACK only packets) are copied out of the
+// memory block so they don't keep it alive and the space is reused for the
+// next datagram.
+static constexpr size_t RECV_COPY_SIZE = 256;
 
 static sockaddr_storage
 make_sockaddr(ip::endpoint endpoint)
@@ -109,7 +131,8 @@ namespace os {
 namespace socket {
 
 udp::udp(ip::endpoint peer)
-  : socket_(make_socket(peer).assume_value())
+  : recv_buffer_(RECV_BLOCK_SIZE)
+  , socket_(make_socket(peer).assume_value())
 {}
 
 ip::endpoint
@@ -169,20 +192,37 @@ udp::send()
     return error::idle;
   }
 
-  const base::buffer &first = send_buffer_.front();
-  ssize_t rv = ::send(socket_, first.data(), first.size(), 0);
+  // Every buffer holds a single datagram. The buffers are passed to the kernel
+  // without copying and sent with a single system call.
+  std::array<base::buffer_view, SEND_BATCH_SIZE> datagrams;
+  size_t count = send_buffer_.segments(datagrams.data(), datagrams.size());
+
+  std::array<iovec, SEND_BATCH_SIZE> iov = {};
+  std::array<mmsghdr, SEND_BATCH_SIZE> messages = {};
+
+  for (size_t i = 0; i < count; i++) {
+    // `sendmmsg` doesn't modify the datagrams.
+    iov[i].iov_base = const_cast<uint8_t *>(datagrams[i].data()); // NOLINT
+    iov[i].iov_len = datagrams[i].size();
+
+    messages[i].msg_hdr.msg_iov = &iov[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int rv = ::sendmmsg(socket_, messages.data(), static_cast<unsigned>(count), 0);
 
   if (rv == -1) {
     if (errno == EAGAIN) {
       return { errno, std::system_category() };
     }
 
-    THROW_SYSTEM(write, errno);
+    THROW_SYSTEM(sendmmsg, errno);
   }
 
-  send_buffer_.consume(static_cast<size_t>(rv));
-
-  BNL_LOG_T("send: {}", rv);
+  for (size_t i = 0; i < static_cast<size_t>(rv); i++) {
+    send_buffer_.consume(datagrams[i].size());
+    BNL_LOG_T("send: {}", messages[i].msg_len);
+  }
 
   return base::success();
 }
@@ -202,9 +242,9 @@ udp::recv()
     THROW_SYSTEM(ioctl, errno);
   }
 
-  base::buffer datagram(static_cast<size_t>(size));
+  uint8_t *dest = recv_buffer_.reserve(static_cast<size_t>(size));
 
-  ssize_t rv = ::recv(socket_, datagram.data(), datagram.size(), 0);
+  ssize_t rv = ::recv(socket_, dest, static_cast<size_t>(size), 0);
   if (rv == -1) {
     if (errno == EAGAIN) {
       return { errno, std::system_category() };
@@ -215,7 +255,13 @@ udp::recv()
 
   BNL_LOG_T("recv: {}", rv);
 
-  return datagram;
+  if (static_cast<size_t>(rv) <= RECV_COPY_SIZE) {
+    return base::buffer(dest, static_cast<size_t>(rv));
+  }
+
+  recv_buffer_.advance(static_cast<size_t>(rv));
+
+  return recv_buffer_.finish();
 }
 
 }
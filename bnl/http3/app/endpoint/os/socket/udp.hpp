@@ -5,6 +5,7 @@
 #include <sd/event/loop.hpp>
 
 #include <bnl/base/buffer.hpp>
+#include <bnl/base/buffer_builder.hpp>
 #include <bnl/base/buffers.hpp>
 #include <bnl/ip/endpoint.hpp>
 #include <bnl/ip/host.hpp>
@@ -35,6 +36,9 @@ public:
 
 private:
   base::buffers send_buffer_;
+  // Datagrams are received into memory blocks shared by multiple datagrams
+  // instead of allocating a new buffer per datagram.
+  base::buffer_builder recv_buffer_;
   os::fd socket_;
 };
 
@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+
+#include <bnl/base/cursor.hpp>
+#include <bnl/http3/codec/body.hpp>
+
+using namespace bnl;
+
+static constexpr size_t WRITES = 1024;
+
+// Streams `WRITES` small writes of `state.range(0)` bytes, sending whatever
+// the encoder produces after each write like a connection would.
+static void
+body_stream(benchmark::State &state, size_t coalesce)
+{
+  size_t size = static_cast<size_t>(state.range(0));
+  base::buffer chunk(size);
+  std::fill_n(chunk.data(), size, 'a');
+
+  size_t buffers = 0;
+
+  for (auto _ : state) {
+    http3::body::encoder encoder;
+
+    http3::body::policy policy;
+    policy.coalesce = coalesce;
+    encoder.configure(policy).value();
+
+    for (size_t i = 0; i < WRITES; i++) {
+      encoder.add(base::buffer(chunk.data(), chunk.size())).value();
+
+      while (true) {
+        http3::result<base::buffer> r = encoder.encode();
+        if (!r) {
+          break;
+        }
+
+        benchmark::DoNotOptimize(r.value().data());
+        buffers++;
+      }
+    }
+
+    encoder.fin().value();
+
+    while (!encoder.finished()) {
+      benchmark::DoNotOptimize(encoder.encode().value().data());
+      buffers++;
+    }
+  }
+
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations() * WRITES * size));
+  state.counters["buffers"] = benchmark::Counter(
+    static_cast<double>(buffers), benchmark::Counter::kAvgIterations);
+}
+
+static void
+body_stream_immediate(benchmark::State &state)
+{
+  body_stream(state, 0);
+}
+
+BENCHMARK(body_stream_immediate)->Arg(16)->Arg(256)->Arg(4096);
+
+static void
+body_stream_coalesced(benchmark::State &state)
+{
+  body_stream(state, 16 * 1024);
+}
+
+BENCHMARK(body_stream_coalesced)->Arg(16)->Arg(256)->Arg(4096);
+
+static constexpr size_t FRAMES = 256;
+static constexpr size_t FRAME_SIZE = 1024;
+
+static base::buffer
+frames()
+{
+  http3::body::encoder encoder;
+  base::buffer encoded;
+
+  for (size_t i = 0; i < FRAMES; i++) {
+    base::buffer chunk(FRAME_SIZE);
+    std::fill_n(chunk.data(), chunk.size(), 'a');
+
+    encoder.add(std::move(chunk)).value();
+    encoded = base::buffer::concat(encoded, encoder.encode().value());
+  }
+
+  return encoded;
+}
+
+static void
+release(uint8_t * /* data */, size_t /* size */, void * /* context */)
+{}
+
+static void
+body_decode_buffer(benchmark::State &state)
+{
+  base::buffer encoded = frames();
+
+  for (auto _ : state) {
+    // Wrap the received data without copying it like a receive buffer would.
+    base::buffer received(encoded.data(), encoded.size(), release, nullptr);
+    http3::body::decoder decoder;
+
+    while (!received.empty()) {
+      base::buffers body_part = decoder.decode(received).value();
+      benchmark::DoNotOptimize(body_part.size());
+    }
+  }
+
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+
+BENCHMARK(body_decode_buffer);
+
+static void
+body_decode_cursor(benchmark::State &state)
+{
+  base::buffer encoded = frames();
+
+  for (auto _ : state) {
+    base::cursor received(encoded);
+    http3::body::decoder decoder;
+
+    while (!received.empty()) {
+      base::buffer_view body_part = decoder.decode(received).value();
+      benchmark::DoNotOptimize(body_part.data());
+    }
+  }
+
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+
+BENCHMARK(body_decode_cursor);
@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+
+#include <bnl/base/cursor.hpp>
+#include <bnl/http3/codec/headers.hpp>
+
+#include <vector>
+
+using namespace bnl;
+
+static base::buffer
+encoded(http3::qpack::stream::encoder *qpack)
+{
+  http3::headers::encoder encoder(0, qpack);
+
+  encoder.add({ ":method", "GET" }).value();
+  encoder.add({ ":scheme", "https" }).value();
+  encoder.add({ ":authority", "www.example.com" }).value();
+  encoder.add({ ":path", "/assets/stylesheets/application.css" }).value();
+  encoder.add({ "user-agent", "bnl" }).value();
+  encoder.add({ "x-request-id", "1a2b3c4d5e6f7a8b9c0d" }).value();
+  encoder.fin().value();
+
+  return encoder.encode().value();
+}
+
+static void
+release(uint8_t * /* data */, size_t /* size */, void * /* context */)
+{}
+
+static void
+headers_decode_buffer(benchmark::State &state)
+{
+  http3::qpack::stream::encoder qpack;
+  http3::qpack::stream::decoder decoder;
+
+  base::buffer encoded = ::encoded(&qpack);
+  std::vector<http3::header_view> headers;
+
+  for (auto _ : state) {
+    // Wrap the received data without copying it like a receive buffer would.
+    base::buffer received(encoded.data(), encoded.size(), release, nullptr);
+
+    http3::headers::decoder receiver(0, &decoder);
+    receiver.decode(received, headers).value();
+    benchmark::DoNotOptimize(headers.data());
+  }
+
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+
+BENCHMARK(headers_decode_buffer);
+
+static void
+headers_decode_cursor(benchmark::State &state)
+{
+  http3::qpack::stream::encoder qpack;
+  http3::qpack::stream::decoder decoder;
+
+  base::buffer encoded = ::encoded(&qpack);
+  std::vector<http3::header_view> headers;
+
+  for (auto _ : state) {
+    base::cursor received(encoded);
+
+    http3::headers::decoder receiver(0, &decoder);
+    receiver.decode(received, headers).value();
+    benchmark::DoNotOptimize(headers.data());
+  }
+
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+
+BENCHMARK(headers_decode_cursor);
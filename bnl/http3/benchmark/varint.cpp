@@ -0,0 +1,164 @@
+#include <benchmark/benchmark.h>
+
+#include <bnl/base/buffer_builder.hpp>
+#include <bnl/base/cursor.hpp>
+#include <bnl/http3/codec/varint.hpp>
+
+#include <vector>
+
+using namespace bnl;
+
+static constexpr size_t COUNT = 1024;
+
+// Mostly small varints (frame types, lengths, setting ids) with the occasional
+// larger one (stream ids, large lengths).
+static std::vector<uint64_t>
+varints()
+{
+  std::vector<uint64_t> varints;
+  varints.reserve(COUNT);
+
+  for (size_t i = 0; i < COUNT; i++) {
+    switch (i % 8) {
+      case 7:
+        varints.push_back(i * 1000003);
+        break;
+      case 5:
+      case 6:
+        varints.push_back(i * 31);
+        break;
+      default:
+        varints.push_back(i % 64);
+    }
+  }
+
+  return varints;
+}
+
+static base::buffer
+encoded()
+{
+  std::vector<uint64_t> values = varints();
+
+  base::buffer_builder builder;
+  http3::varint::encode(builder, values.data(), values.size()).value();
+
+  return builder.finish();
+}
+
+static void
+varint_encode(benchmark::State &state)
+{
+  std::vector<uint64_t> values = varints();
+  base::buffer encoded(::encoded().size());
+
+  for (auto _ : state) {
+    uint8_t *dest = encoded.data();
+
+    for (uint64_t varint : values) {
+      dest += http3::varint::encode(dest, varint).value();
+    }
+
+    benchmark::DoNotOptimize(encoded.data());
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * COUNT));
+}
+
+BENCHMARK(varint_encode);
+
+static void
+varint_encode_bulk(benchmark::State &state)
+{
+  std::vector<uint64_t> values = varints();
+  base::buffer encoded(::encoded().size());
+
+  for (auto _ : state) {
+    http3::varint::encode(encoded.data(), values.data(), values.size())
+      .value();
+    benchmark::DoNotOptimize(encoded.data());
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * COUNT));
+}
+
+BENCHMARK(varint_encode_bulk);
+
+static void
+varint_decode(benchmark::State &state)
+{
+  base::buffer encoded = ::encoded();
+
+  for (auto _ : state) {
+    base::buffer::lookahead lookahead(encoded);
+
+    for (size_t i = 0; i < COUNT; i++) {
+      benchmark::DoNotOptimize(http3::varint::decode(lookahead).value());
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * COUNT));
+}
+
+BENCHMARK(varint_decode);
+
+static void
+varint_decode_cursor(benchmark::State &state)
+{
+  base::buffer encoded = ::encoded();
+
+  for (auto _ : state) {
+    base::cursor cursor(encoded);
+
+    for (size_t i = 0; i < COUNT; i++) {
+      benchmark::DoNotOptimize(http3::varint::decode(cursor).value());
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * COUNT));
+}
+
+BENCHMARK(varint_decode_cursor);
+
+// Every byte is stored in a separate buffer so all varints larger than a
+// single byte are decoded byte by byte.
+static void
+varint_decode_segmented(benchmark::State &state)
+{
+  for (auto _ : state) {
+    state.PauseTiming();
+
+    base::buffer encoded = ::encoded();
+    base::buffers buffers;
+
+    while (!encoded.empty()) {
+      buffers.push(encoded.slice(1));
+    }
+
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < COUNT; i++) {
+      benchmark::DoNotOptimize(http3::varint::decode(buffers).value());
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * COUNT));
+}
+
+BENCHMARK(varint_decode_segmented);
+
+static void
+varint_decode_bulk(benchmark::State &state)
+{
+  base::buffer encoded = ::encoded();
+  std::vector<uint64_t> decoded(COUNT);
+
+  for (auto _ : state) {
+    http3::varint::decode(encoded, decoded.data(), decoded.size()).value();
+    benchmark::DoNotOptimize(decoded.data());
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * COUNT));
+}
+
+BENCHMARK(varint_decode_bulk);
@@ -3,11 +3,15 @@
 #include <bnl/http3/client/stream/control.hpp>
 #include <bnl/http3/client/stream/request.hpp>
 #include <bnl/http3/endpoint/generator.hpp>
+#include <bnl/http3/endpoint/scheduler.hpp>
+#include <bnl/http3/endpoint/stream/decoder.hpp>
+#include <bnl/http3/endpoint/stream/encoder.hpp>
 #include <bnl/http3/event.hpp>
 #include <bnl/http3/export.hpp>
 #include <bnl/quic/event.hpp>
 
-#include <map>
+#include <memory>
+#include <unordered_map>
 
 namespace bnl {
 namespace http3 {
@@ -24,7 +28,7 @@ using generator = endpoint::generator<connection>;
 
 class BNL_HTTP3_EXPORT connection {
 public:
-  connection() = default;
+  connection();
 
   connection(connection &&) = default;
   connection &operator=(connection &&) = default;
@@ -40,6 +44,10 @@ private:
 
   result<event> process(uint64_t id);
 
+  // Processes the request streams whose header blocks were unblocked by the
+  // peer's encoder stream instructions.
+  result<event> unblocked();
+
   result<void> recv(quic::data data);
 
 private:
@@ -48,6 +56,10 @@ private:
                               client::stream::control::receiver>;
   using request_t = std::pair<client::stream::request::sender,
                               client::stream::request::receiver>;
+  using encoder_t = std::pair<endpoint::stream::encoder::sender,
+                              endpoint::stream::decoder::receiver>;
+  using decoder_t = std::pair<endpoint::stream::decoder::sender,
+                              endpoint::stream::encoder::receiver>;
 
   struct {
     settings local;
@@ -56,7 +68,20 @@ private:
 
   control_t control_;
 
-  std::map<uint64_t, request_t> requests_;
+  // Streams keep pointers to the QPACK encoder and decoder and the scheduler so
+  // their addresses can't change when the connection is moved.
+  struct {
+    std::unique_ptr<qpack::stream::encoder> encoder;
+    std::unique_ptr<qpack::stream::decoder> decoder;
+  } qpack_;
+  std::unique_ptr<endpoint::scheduler> scheduler_;
+  encoder_t encoder_;
+  decoder_t decoder_;
+
+  // Request stream that is currently being processed by `unblocked`.
+  uint64_t unblocked_ = UINT64_MAX;
+
+  std::unordered_map<uint64_t, request_t> requests_;
   uint64_t next_stream_id_ = 0;
 };
 
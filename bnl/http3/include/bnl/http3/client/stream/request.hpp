@@ -16,7 +16,7 @@ public:
 
 class BNL_HTTP3_EXPORT receiver : public endpoint::stream::request::receiver {
 public:
-  explicit receiver(uint64_t id) noexcept;
+  receiver(uint64_t id, qpack::stream::decoder *qpack) noexcept;
 
   using endpoint::stream::request::receiver::process;
 
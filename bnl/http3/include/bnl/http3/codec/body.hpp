@@ -1,16 +1,32 @@
 #pragma once
 
 #include <bnl/base/buffer.hpp>
+#include <bnl/base/buffer_builder.hpp>
 #include <bnl/base/buffers.hpp>
+#include <bnl/base/file.hpp>
 #include <bnl/base/template.hpp>
 #include <bnl/http3/codec/frame.hpp>
 #include <bnl/http3/export.hpp>
 #include <bnl/http3/result.hpp>
 
+#include <deque>
+
 namespace bnl {
 namespace http3 {
 namespace body {
 
+// Controls how the body is split into DATA frames.
+struct policy {
+  // Buffers are held back until at least `coalesce` bytes are queued (or
+  // until `flush` or `fin` is called) so many small writes are sent as a
+  // single DATA frame. Zero sends every buffer as soon as possible.
+  size_t coalesce = 0;
+  // Maximum payload size of a single DATA frame. Larger buffers and files are
+  // split into multiple frames. The default matches the stream flow control
+  // window we advertise by default.
+  size_t max_frame_size = 256 * 1024;
+};
+
 class BNL_HTTP3_EXPORT encoder {
 public:
   encoder() = default;
@@ -19,18 +35,49 @@ public:
   encoder &operator=(encoder &&) = default;
 
   result<void> add(base::buffer body);
+
+  // Sends the contents of `file` as the next part of the body. The file is
+  // memory mapped and sent one chunk at a time so it is never loaded into
+  // memory at once.
+  result<void> add(base::file body);
+
+  result<void> configure(policy policy) noexcept;
+
+  // Sends the queued buffers even if fewer than `policy::coalesce` bytes are
+  // queued.
+  result<void> flush() noexcept;
+
   result<void> fin() noexcept;
 
   bool finished() const noexcept;
 
   result<base::buffer> encode() noexcept;
 
+private:
+  struct part {
+    base::buffer buffer;
+    base::file file;
+    // Amount of bytes of `file` that have already been mapped.
+    uint64_t offset;
+  };
+
+  bool hold() const noexcept;
+
+  result<base::buffer> coalesced() noexcept;
+  result<base::buffer> next() noexcept;
+
 private:
   enum class state : uint8_t { frame, data, fin };
 
   state state_ = state::frame;
   bool fin_ = false;
-  base::buffers buffers_;
+  bool flush_ = false;
+  policy policy_;
+  std::deque<part> parts_;
+  // Amount of bytes queued in buffers (files are not included).
+  size_t buffered_ = 0;
+  base::buffer data_;
+  base::buffer_builder builder_;
 };
 
 class BNL_HTTP3_EXPORT decoder {
@@ -42,21 +89,39 @@ public:
 
   bool in_progress() const noexcept;
 
+  // Header of the frame that made `decode` return `error::delegate` because
+  // it isn't a DATA frame. Its payload is left in the sequence.
+  frame::header delegated() const noexcept;
+
+  template<typename Sequence>
+  result<base::buffers> decode(Sequence &encoded);
+
+  // Returns a view of the body part in the memory of `encoded` instead of
+  // copying it into a buffer.
+  result<base::buffer_view> decode(base::cursor &encoded);
+
+private:
+  // Returns the size of the next body part in `encoded`. The caller has to
+  // consume it.
   template<typename Sequence>
-  result<base::buffer> decode(Sequence &encoded);
+  result<size_t> next(Sequence &encoded);
 
 private:
   enum class state : uint8_t { frame, data };
 
   state state_ = state::frame;
   uint64_t remaining_ = 0;
+
+  frame::parser parser_;
+  frame::header delegated_ = {};
 };
 
 #define BNL_HTTP3_BODY_DECODE_IMPL(T)                                          \
-  template BNL_HTTP3_EXPORT result<base::buffer> decoder::decode<T>(           \
+  template BNL_HTTP3_EXPORT result<base::buffers> decoder::decode<T>(          \
     T &) // NOLINT
 
-BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_BODY_DECODE_IMPL);
+extern BNL_HTTP3_BODY_DECODE_IMPL(base::buffer);
+extern BNL_HTTP3_BODY_DECODE_IMPL(base::buffers);
 
 }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bnl/base/buffer.hpp>
+#include <bnl/base/buffer_builder.hpp>
 #include <bnl/base/buffers.hpp>
 #include <bnl/base/template.hpp>
 #include <bnl/http3/codec/varint.hpp>
@@ -82,6 +83,14 @@ public:
     };
   };
 
+  // Type and payload size of a frame. The payload follows the frame header.
+  struct header {
+    frame::type type;
+    uint64_t size;
+  };
+
+  class parser;
+
   // We allow implicit conversions from a frame payload into a frame.
 
   frame() noexcept;
@@ -104,13 +113,17 @@ public:
 
   static result<size_t> encode(uint8_t *dest, const frame &frame) noexcept;
 
+  static result<size_t> encode(base::buffer_builder &encoded,
+                               const frame &frame);
+
   static result<base::buffer> encode(const frame &frame);
 
   template<typename Sequence>
-  static result<frame::type> peek(const Sequence &encoded) noexcept;
+  static result<frame> decode(Sequence &encoded) noexcept;
 
+  // Decodes the payload of a frame whose header was decoded by `parser`.
   template<typename Sequence>
-  static result<frame> decode(Sequence &encoded) noexcept;
+  static result<frame> decode(Sequence &encoded, header header) noexcept;
 
 private:
   const type type_;
@@ -131,6 +144,41 @@ public:
   };
 };
 
+// Decodes frame headers incrementally. Bytes are consumed as soon as they're
+// parsed and a partially received varint is kept until the next call so every
+// byte of a frame header is parsed exactly once, no matter how the frame header
+// is split. Frames of unknown types are skipped.
+class BNL_HTTP3_EXPORT frame::parser {
+public:
+  parser() = default;
+
+  parser(parser &&) = default;
+  parser &operator=(parser &&) = default;
+
+  // True while a frame header has been partially decoded.
+  bool in_progress() const noexcept;
+
+  template<typename Sequence>
+  result<frame::header> decode(Sequence &encoded) noexcept;
+
+private:
+  template<typename Sequence>
+  result<uint64_t> varint(Sequence &encoded) noexcept;
+
+private:
+  enum class state : uint8_t { type, size, skip };
+
+  state state_ = state::type;
+  uint64_t type_ = 0;
+  // Payload bytes left to skip while in `state::skip`.
+  uint64_t skip_ = 0;
+
+  // Partially decoded varint and the amount of its bytes that haven't been
+  // received yet.
+  uint64_t varint_ = 0;
+  size_t missing_ = 0;
+};
+
 BNL_HTTP3_EXPORT bool
 operator==(const frame &lhs, const frame &rhs);
 BNL_HTTP3_EXPORT bool
@@ -140,19 +188,23 @@ BNL_HTTP3_EXPORT
 std::ostream &
 operator<<(std::ostream &os, const frame &frame);
 
-#define BNL_HTTP3_FRAME_PEEK_IMPL(T)                                           \
-  template BNL_HTTP3_EXPORT result<frame::type> frame::peek<T>(                \
-    const T &) noexcept // NOLINT
-
 #define BNL_HTTP3_FRAME_DECODE_IMPL(T)                                         \
   template BNL_HTTP3_EXPORT result<frame> frame::decode<T>(                    \
     T &) /* NOLINT */ noexcept
 
-BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_FRAME_PEEK_IMPL);
-BNL_BASE_LOOKAHEAD_DECL(BNL_HTTP3_FRAME_PEEK_IMPL);
-
 BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_FRAME_DECODE_IMPL);
 BNL_BASE_LOOKAHEAD_DECL(BNL_HTTP3_FRAME_DECODE_IMPL);
 
+#define BNL_HTTP3_FRAME_DECODE_PAYLOAD_IMPL(T)                                 \
+  template BNL_HTTP3_EXPORT result<frame> frame::decode<T>(                    \
+    T &, frame::header) /* NOLINT */ noexcept
+
+#define BNL_HTTP3_FRAME_PARSER_DECODE_IMPL(T)                                  \
+  template BNL_HTTP3_EXPORT result<frame::header> frame::parser::decode<T>(    \
+    T &) /* NOLINT */ noexcept
+
+BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_FRAME_DECODE_PAYLOAD_IMPL);
+BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_FRAME_PARSER_DECODE_IMPL);
+
 }
 }
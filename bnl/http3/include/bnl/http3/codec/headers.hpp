@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bnl/base/buffer.hpp>
+#include <bnl/base/buffer_builder.hpp>
 #include <bnl/base/buffers.hpp>
 #include <bnl/base/template.hpp>
 #include <bnl/http3/codec/frame.hpp>
@@ -9,18 +10,47 @@
 #include <bnl/http3/header.hpp>
 #include <bnl/http3/result.hpp>
 
+#include <vector>
+
 namespace bnl {
 namespace http3 {
 namespace headers {
 
+// Headers that are sent with (almost) every request or response, encoded once
+// up front. Only the static table and literals are used so the encoded field
+// lines don't depend on the dynamic table and can be copied into any header
+// block by `encoder::add` without encoding the headers again. Headers that
+// differ between header blocks should be added to the encoder separately.
+class BNL_HTTP3_EXPORT prototype {
+public:
+  prototype() = default;
+
+  prototype(prototype &&) = default;
+  prototype &operator=(prototype &&) = default;
+
+  result<void> add(header_view header);
+
+  // Amount of headers in the prototype.
+  size_t size() const noexcept;
+
+  base::buffer_view encoded() const noexcept;
+
+private:
+  base::buffer encoded_;
+  size_t size_ = 0;
+};
+
 class BNL_HTTP3_EXPORT encoder {
 public:
-  encoder() = default;
+  // See `qpack::encoder` for the meaning of the arguments.
+  encoder(uint64_t id, qpack::stream::encoder *qpack) noexcept;
 
   encoder(encoder &&) = default;
   encoder &operator=(encoder &&) = default;
 
   result<void> add(header_view header);
+  result<void> add(const qpack::static_header &header);
+  result<void> add(const prototype &prototype);
   result<void> fin() noexcept;
 
   bool finished() const noexcept;
@@ -28,17 +58,21 @@ public:
   result<base::buffer> encode() noexcept;
 
 private:
-  enum class state : uint8_t { idle, frame, qpack, fin };
+  enum class state : uint8_t { idle, frame, fin };
 
   state state_ = state::idle;
-  base::buffers buffers_;
+  // The QPACK encoded headers are written right after space reserved for the
+  // largest possible frame header and header block prefix which are filled in
+  // by `encode`. This way, the full HEADERS frame ends up in a single buffer.
+  base::buffer_builder encoded_;
 
   qpack::encoder qpack_;
 };
 
 class BNL_HTTP3_EXPORT decoder {
 public:
-  decoder() = default;
+  // See `qpack::decoder` for the meaning of the arguments.
+  decoder(uint64_t id, qpack::stream::decoder *qpack) noexcept;
 
   decoder(decoder &&) = default;
   decoder &operator=(decoder &&) = default;
@@ -47,23 +81,61 @@ public:
 
   bool finished() const noexcept;
 
+  bool blocked() const noexcept;
+
+  // Header of the frame that made `decode` return `error::delegate` because
+  // it isn't a HEADERS frame. Its payload is left in the sequence.
+  frame::header delegated() const noexcept;
+
+  // Waits for the full header block before decoding the first header. The
+  // returned views refer to the header block or to memory owned by the
+  // decoder so they stay valid until the decoder is destroyed.
+  template<typename Sequence>
+  result<header_view> decode(Sequence &encoded);
+
+  // Decodes the full header block in a single call and replaces the contents
+  // of `headers` with its headers. Reusing the same list for every header
+  // block avoids reallocating it.
   template<typename Sequence>
-  result<header> decode(Sequence &encoded);
+  result<void> decode(Sequence &encoded, std::vector<header_view> &headers);
 
 private:
-  enum class state : uint8_t { frame, qpack, fin };
+  template<typename Sequence>
+  void block(Sequence &encoded, size_t size);
+
+  void block(base::cursor &encoded, size_t size) noexcept;
+
+private:
+  enum class state : uint8_t { frame, block, qpack, fin };
 
   state state_ = state::frame;
   uint64_t headers_size_ = 0;
 
+  frame::parser parser_;
+  frame::header delegated_ = {};
+
+  // Slice of the received stream data. Small header blocks are stored inline
+  // so the decoder shouldn't be moved while its headers are in use.
+  base::buffer block_;
+  // Header block in the memory of a `base::cursor`. Headers decoded from a
+  // cursor refer to its memory instead of a copy in `block_`.
+  base::cursor view_;
+
   qpack::decoder qpack_;
 };
 
 #define BNL_HTTP3_HEADERS_DECODE_IMPL(T)                                       \
-  template BNL_HTTP3_EXPORT result<header> decoder::decode<T>(T &) // NOLINT
+  template BNL_HTTP3_EXPORT result<header_view> decoder::decode<T>(            \
+    T &) // NOLINT
 
 BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_HEADERS_DECODE_IMPL);
 
+#define BNL_HTTP3_HEADERS_DECODE_LIST_IMPL(T)                                  \
+  template BNL_HTTP3_EXPORT result<void> decoder::decode<T>(                   \
+    T &, std::vector<header_view> &) // NOLINT
+
+BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_HEADERS_DECODE_LIST_IMPL);
+
 }
 }
 }
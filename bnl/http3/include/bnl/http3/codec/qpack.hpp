@@ -1,19 +1,24 @@
 #pragma once
 
+#include <bnl/base/arena.hpp>
 #include <bnl/base/buffer.hpp>
+#include <bnl/base/buffer_builder.hpp>
 #include <bnl/base/buffers.hpp>
 #include <bnl/base/template.hpp>
 #include <bnl/http3/codec/qpack/literal.hpp>
 #include <bnl/http3/codec/qpack/prefix_int.hpp>
+#include <bnl/http3/codec/qpack/static_header.hpp>
+#include <bnl/http3/codec/qpack/stream.hpp>
 #include <bnl/http3/export.hpp>
 #include <bnl/http3/header.hpp>
 #include <bnl/http3/result.hpp>
 
 // https://quicwg.org/base-drafts/draft-ietf-quic-qpack.html
 
-// This QPACK implementation only uses the static table to keep the
-// implementation and usage simple. Users should advertise
-// `SETTINGS_QPACK_MAX_TABLE_CAPACITY` as zero when using this implementation.
+// The encoder and decoder use the dynamic table when they're given a
+// `stream::encoder` or `stream::decoder` respectively. Without one, only the
+// static table is used and `SETTINGS_QPACK_MAX_TABLE_CAPACITY` should be
+// advertised as zero.
 
 namespace bnl {
 namespace http3 {
@@ -21,8 +26,16 @@ namespace qpack {
 
 class BNL_HTTP3_EXPORT encoder {
 public:
+  // Only uses the static table. The header block prefix is written by the
+  // first call to `encode`.
   encoder() = default;
 
+  // Encodes a header block of stream `id` which may reference the dynamic
+  // table of `stream`. `stream` may be `nullptr` in which case only the static
+  // table is used. The header block prefix depends on the referenced dynamic
+  // table entries so it's written by `fin` after all headers are encoded.
+  encoder(uint64_t id, stream::encoder *stream) noexcept;
+
   encoder(encoder &&) = default;
   encoder &operator=(encoder &&) = default;
 
@@ -32,32 +45,122 @@ public:
 
   result<size_t> encode(uint8_t *dest, header_view header) noexcept;
 
+  result<size_t> encode(base::buffer_builder &encoded, header_view header);
+
   result<base::buffer> encode(header_view header);
 
+  // Copies the representation of `header` which was computed at compile time.
+  result<size_t> encode(base::buffer_builder &encoded,
+                        const static_header &header);
+
+  // Appends field lines that were encoded without referencing the dynamic
+  // table (see `headers::prototype`). Such field lines don't depend on the
+  // state of the header block so they can be copied as is.
+  size_t append(base::buffer_builder &encoded, base::buffer_view lines);
+
+  size_t prefix_encoded_size() const noexcept;
+
+  // Writes the header block prefix to `dest`. Only used when encoding for a
+  // `stream::encoder`.
+  size_t fin(uint8_t *dest) noexcept;
+
+private:
+  using representation = stream::encoder::representation;
+
+  representation find(header_view header) const noexcept;
+
+  uint64_t base() const noexcept;
+
+  size_t encoded_size(const representation &representation,
+                      header_view header) const noexcept;
+
+  void reference(const representation &representation, header_view header);
+
+  // Writes the header block prefix (if not deferred) before the first header.
+  void start(base::buffer_builder &encoded);
+
 private:
   enum class state { prefix, header };
 
   state state_ = state::prefix;
   uint64_t count_ = 0;
+
+  bool deferred_ = false;
+  uint64_t id_ = 0;
+  stream::encoder *stream_ = nullptr;
+
+  // Base and Required Insert Count of the header block.
+  uint64_t base_ = 0;
+  uint64_t required_ = 0;
 };
 
 class BNL_HTTP3_EXPORT decoder {
 public:
+  // Only supports the static table.
   decoder() = default;
 
+  // Decodes a header block of stream `id` which may reference the dynamic
+  // table of `stream`. While the header block references entries that haven't
+  // been inserted yet, `decode` returns `error::incomplete` and the stream is
+  // reported by `stream::decoder::unblocked` once it can make progress again.
+  decoder(uint64_t id, stream::decoder *stream) noexcept;
+
   decoder(decoder &&) = default;
   decoder &operator=(decoder &&) = default;
 
   uint64_t count() const noexcept;
 
+  // True while the header block waits for dynamic table inserts.
+  bool blocked() const noexcept;
+
   template<typename Lookahead>
   result<header> decode(Lookahead &encoded);
 
+  // Decodes a header without copying it where possible. Static table entries
+  // refer to constant storage and literals that aren't huffman encoded refer
+  // to the memory of `encoded`. Huffman encoded literals and dynamic table
+  // entries are copied into an arena owned by the decoder. The view stays
+  // valid as long as both the decoder and the memory of `encoded` are alive.
+  // Consuming a `base::buffer` or a `base::cursor` doesn't release its memory
+  // so only those are supported.
+  result<header_view> decode_view(base::buffer &encoded);
+  result<header_view> decode_view(base::cursor &encoded);
+
+  // Acknowledges the header block if it referenced the dynamic table. Should
+  // be called once all headers of the header block have been decoded.
+  void fin();
+
 private:
-  enum class state { prefix, header };
+  // Decodes the header block prefix and waits until the header block isn't
+  // blocked anymore.
+  template<typename Sequence>
+  result<void> start(Sequence &encoded);
+
+  template<typename Sequence>
+  result<header_view> view(Sequence &encoded);
+
+  template<typename Lookahead>
+  result<void> prefix(Lookahead &encoded);
+
+  template<typename Lookahead>
+  result<header_view> line(Lookahead &encoded);
+
+  result<header_view> entry(uint64_t index);
+
+private:
+  enum class state { prefix, blocked, header };
 
   state state_ = state::prefix;
   uint64_t count_ = 0;
+
+  uint64_t id_ = 0;
+  stream::decoder *stream_ = nullptr;
+
+  // Base and Required Insert Count of the header block.
+  uint64_t base_ = 0;
+  uint64_t required_ = 0;
+
+  base::arena arena_;
 };
 
 #define BNL_HTTP3_QPACK_DECODE_IMPL(T)                                         \
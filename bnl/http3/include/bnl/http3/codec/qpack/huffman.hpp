@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bnl/base/buffer.hpp>
+#include <bnl/base/buffer_builder.hpp>
 #include <bnl/base/buffers.hpp>
 #include <bnl/base/string_view.hpp>
 #include <bnl/base/template.hpp>
@@ -21,13 +22,33 @@ encoded_size(base::string_view string) noexcept;
 BNL_HTTP3_EXPORT size_t
 encode(uint8_t *dest, base::string_view string) noexcept;
 
+// Encodes `string` into `dest` as long as the encoded string fits in
+// `max_size` bytes. Returns `SIZE_MAX` as soon as it becomes clear that it
+// doesn't fit in which case the contents of `dest` are unspecified. This
+// allows trying huffman encoding without computing the encoded size first.
+BNL_HTTP3_EXPORT size_t
+encode(uint8_t *dest, base::string_view string, size_t max_size) noexcept;
+
+BNL_HTTP3_EXPORT size_t
+encode(base::buffer_builder &encoded, base::string_view string);
+
 BNL_HTTP3_EXPORT base::buffer
 encode(base::string_view string);
 
+// Upper bound of the size of `encoded_size` bytes of decoded huffman data.
+BNL_HTTP3_EXPORT size_t
+decoded_max_size(size_t encoded_size) noexcept;
+
 template<typename Sequence>
 BNL_HTTP3_EXPORT result<base::string>
 decode(Sequence &encoded, size_t encoded_size);
 
+// Decodes into `dest` which should have room for
+// `decoded_max_size(encoded_size)` bytes. Returns the decoded size.
+template<typename Sequence>
+BNL_HTTP3_EXPORT result<size_t>
+decode(Sequence &encoded, size_t encoded_size, char *dest);
+
 #define BNL_HTTP3_QPACK_HUFFMAN_DECODE_IMPL(T)                                 \
   template BNL_HTTP3_EXPORT result<base::string> decode<T>(T &, /* NOLINT */   \
                                                            size_t)
@@ -35,6 +56,32 @@ decode(Sequence &encoded, size_t encoded_size);
 BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_QPACK_HUFFMAN_DECODE_IMPL);
 BNL_BASE_LOOKAHEAD_DECL(BNL_HTTP3_QPACK_HUFFMAN_DECODE_IMPL);
 
+#define BNL_HTTP3_QPACK_HUFFMAN_DECODE_DEST_IMPL(T)                            \
+  template BNL_HTTP3_EXPORT result<size_t> decode<T>(T &, /* NOLINT */         \
+                                                     size_t,                   \
+                                                     char *)
+
+BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_QPACK_HUFFMAN_DECODE_DEST_IMPL);
+BNL_BASE_LOOKAHEAD_DECL(BNL_HTTP3_QPACK_HUFFMAN_DECODE_DEST_IMPL);
+
+namespace reference {
+
+// Decodes one nibble at a time using a state machine and makes two passes over
+// the input (one to compute the decoded size and one to decode). Much slower
+// than `huffman::decode` but kept around to test it against.
+template<typename Sequence>
+BNL_HTTP3_EXPORT result<base::string>
+decode(Sequence &encoded, size_t encoded_size);
+
+#define BNL_HTTP3_QPACK_HUFFMAN_REFERENCE_DECODE_IMPL(T)                       \
+  template BNL_HTTP3_EXPORT result<base::string> decode<T>(T &, /* NOLINT */   \
+                                                           size_t)
+
+BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_QPACK_HUFFMAN_REFERENCE_DECODE_IMPL);
+BNL_BASE_LOOKAHEAD_DECL(BNL_HTTP3_QPACK_HUFFMAN_REFERENCE_DECODE_IMPL);
+
+}
+
 }
 }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <bnl/base/arena.hpp>
 #include <bnl/base/buffer.hpp>
 #include <bnl/base/buffers.hpp>
 #include <bnl/base/template.hpp>
@@ -22,6 +23,13 @@ encoded_size(base::string_view literal, uint8_t prefix) noexcept;
 BNL_HTTP3_EXPORT size_t
 encode(uint8_t *dest, base::string_view literal, uint8_t prefix) noexcept;
 
+// Bits of the first byte in front of the huffman flag are set to zero. Use
+// `operator[]` to set them after encoding.
+BNL_HTTP3_EXPORT size_t
+encode(base::buffer_builder &encoded,
+       base::string_view literal,
+       uint8_t prefix);
+
 BNL_HTTP3_EXPORT base::buffer
 encode(base::string_view literal, uint8_t prefix);
 
@@ -29,6 +37,14 @@ template<typename Sequence>
 BNL_HTTP3_EXPORT result<base::string>
 decode(Sequence &encoded, uint8_t prefix);
 
+// Avoids copying the literal when possible. Literals that aren't huffman
+// encoded and are stored contiguously in `encoded` refer to its memory which
+// should outlive the returned view. All other literals are decoded into
+// `arena`.
+template<typename Sequence>
+BNL_HTTP3_EXPORT result<base::string_view>
+decode(Sequence &encoded, uint8_t prefix, base::arena &arena);
+
 #define BNL_HTTP3_QPACK_LITERAL_DECODE_IMPL(T)                                 \
   template BNL_HTTP3_EXPORT result<base::string> decode<T>(T &, /* NOLINT */   \
                                                            uint8_t)
@@ -36,6 +52,15 @@ decode(Sequence &encoded, uint8_t prefix);
 BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_QPACK_LITERAL_DECODE_IMPL);
 BNL_BASE_LOOKAHEAD_DECL(BNL_HTTP3_QPACK_LITERAL_DECODE_IMPL);
 
+#define BNL_HTTP3_QPACK_LITERAL_DECODE_VIEW_IMPL(T)                            \
+  template BNL_HTTP3_EXPORT result<base::string_view> decode<T>(               \
+    T &, /* NOLINT */                                                          \
+    uint8_t,                                                                   \
+    base::arena &)
+
+BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_QPACK_LITERAL_DECODE_VIEW_IMPL);
+BNL_BASE_LOOKAHEAD_DECL(BNL_HTTP3_QPACK_LITERAL_DECODE_VIEW_IMPL);
+
 }
 }
 }
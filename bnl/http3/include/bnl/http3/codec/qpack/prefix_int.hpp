@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bnl/base/buffer.hpp>
+#include <bnl/base/buffer_builder.hpp>
 #include <bnl/base/buffers.hpp>
 #include <bnl/base/template.hpp>
 #include <bnl/http3/export.hpp>
@@ -19,6 +20,11 @@ encoded_size(uint64_t value, uint8_t prefix) noexcept;
 BNL_HTTP3_EXPORT size_t
 encode(uint8_t *dest, uint64_t value, uint8_t prefix) noexcept;
 
+// Bits of the first byte in front of the prefix are set to zero. Use
+// `operator[]` to set them after encoding.
+BNL_HTTP3_EXPORT size_t
+encode(base::buffer_builder &encoded, uint64_t value, uint8_t prefix);
+
 BNL_HTTP3_EXPORT base::buffer
 encode(uint64_t value, uint8_t prefix);
 
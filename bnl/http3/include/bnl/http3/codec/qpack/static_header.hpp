@@ -0,0 +1,202 @@
+#pragma once
+
+#include <bnl/base/string_view.hpp>
+#include <bnl/http3/codec/qpack/static_table_generated.hpp>
+#include <bnl/http3/header.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace bnl {
+namespace http3 {
+namespace qpack {
+
+class encoder;
+
+// A header whose QPACK representation is computed at compile time:
+//
+//   constexpr auto METHOD_GET = qpack::static_header::make(":method", "GET");
+//
+// The static table index is resolved and the prefix integers are encoded when
+// the constant is created so `qpack::encoder` only has to copy bytes. The
+// dynamic table is never used which doesn't matter for headers that are in the
+// static table but makes other headers larger than necessary.
+class static_header {
+public:
+  template<size_t N, size_t M>
+  static constexpr static_header make(const char (&name)[N],
+                                      const char (&value)[M]) noexcept
+  {
+    return static_header(name, N - 1, value, M - 1);
+  }
+
+  header_view header() const noexcept
+  {
+    return { { name_, name_size_ }, { value_, value_size_ } };
+  }
+
+  constexpr bool lowercase() const noexcept { return lowercase_; }
+
+  constexpr size_t encoded_size() const noexcept
+  {
+    if (indexed_) {
+      return index_size_;
+    }
+
+    return index_size_ + (literal_ ? name_size_ : 0) +
+           value_size_prefix_size_ + value_size_;
+  }
+
+private:
+  friend class encoder;
+
+  static constexpr uint8_t INDEXED_HEADER_FIELD_PREFIX = 0xc0;
+  static constexpr uint8_t LITERAL_WITH_NAME_REFERENCE_PREFIX = 0x50;
+  static constexpr uint8_t LITERAL_WITHOUT_NAME_REFERENCE_PREFIX = 0x20;
+
+  // Prefix integers smaller than 2^64 take at most 10 bytes after the prefix.
+  static constexpr size_t PREFIX_INT_MAX_ENCODED_SIZE = 1 + 10;
+
+  static constexpr bool equal(const char *first,
+                              size_t size,
+                              const char *second) noexcept
+  {
+    for (size_t i = 0; i < size; i++) {
+      if (second[i] != first[i]) {
+        return false;
+      }
+    }
+
+    return second[size] == '\0';
+  }
+
+  static constexpr size_t encode(uint8_t *dest,
+                                 uint64_t value,
+                                 uint8_t prefix,
+                                 uint8_t instruction) noexcept
+  {
+    uint8_t max = static_cast<uint8_t>((1U << prefix) - 1);
+
+    if (value < max) {
+      dest[0] = static_cast<uint8_t>(instruction | value);
+      return 1;
+    }
+
+    dest[0] = static_cast<uint8_t>(instruction | max);
+    value -= max;
+
+    size_t size = 1;
+
+    for (; value >= 0x80; value >>= 7U) {
+      dest[size++] = static_cast<uint8_t>((value & 0x7fU) | 0x80U);
+    }
+
+    dest[size++] = static_cast<uint8_t>(value);
+
+    return size;
+  }
+
+  constexpr static_header(const char *name,
+                          size_t name_size,
+                          const char *value,
+                          size_t value_size) noexcept
+    : name_(name)
+    , name_size_(name_size)
+    , value_(value)
+    , value_size_(value_size)
+  {
+    for (size_t i = 0; i < name_size; i++) {
+      if (name[i] >= 'A' && name[i] <= 'Z') {
+        lowercase_ = false;
+      }
+    }
+
+    size_t found = SIZE_MAX;
+
+    for (size_t i = 0; i < sizeof(table::fixed::ENTRIES) /
+                             sizeof(table::fixed::ENTRIES[0]);
+         i++) {
+      const table::fixed::entry &entry = table::fixed::ENTRIES[i];
+
+      if (!equal(name, name_size, entry.name)) {
+        continue;
+      }
+
+      if (entry.value != nullptr && equal(value, value_size, entry.value)) {
+        indexed_ = true;
+        found = i;
+        break;
+      }
+
+      found = found == SIZE_MAX ? i : found;
+    }
+
+    if (indexed_) {
+      index_size_ = encode(index_, found, 6, INDEXED_HEADER_FIELD_PREFIX);
+      return;
+    }
+
+    if (found != SIZE_MAX) {
+      index_size_ =
+        encode(index_, found, 4, LITERAL_WITH_NAME_REFERENCE_PREFIX);
+    } else {
+      literal_ = true;
+      index_size_ =
+        encode(index_, name_size, 3, LITERAL_WITHOUT_NAME_REFERENCE_PREFIX);
+    }
+
+    // Values are never huffman encoded.
+    value_size_prefix_size_ = encode(value_size_prefix_, value_size, 7, 0);
+  }
+
+  // Writes the header to `dest` which should have room for `encoded_size()`
+  // bytes.
+  size_t encode(uint8_t *dest) const noexcept
+  {
+    uint8_t *begin = dest;
+
+    std::memcpy(dest, index_, index_size_);
+    dest += index_size_;
+
+    if (indexed_) {
+      return index_size_;
+    }
+
+    if (literal_) {
+      std::memcpy(dest, name_, name_size_);
+      dest += name_size_;
+    }
+
+    std::memcpy(dest, value_size_prefix_, value_size_prefix_size_);
+    dest += value_size_prefix_size_;
+
+    std::memcpy(dest, value_, value_size_);
+    dest += value_size_;
+
+    return static_cast<size_t>(dest - begin);
+  }
+
+private:
+  const char *name_;
+  size_t name_size_;
+  const char *value_;
+  size_t value_size_;
+
+  bool lowercase_ = true;
+  // True if the header is in the static table.
+  bool indexed_ = false;
+  // True if the name isn't in the static table either.
+  bool literal_ = false;
+
+  // Static table index (or the length of the name if it isn't in the static
+  // table) and the length of the value encoded as prefix integers.
+  uint8_t index_[PREFIX_INT_MAX_ENCODED_SIZE] = {};
+  size_t index_size_ = 0;
+  uint8_t value_size_prefix_[PREFIX_INT_MAX_ENCODED_SIZE] = {};
+  size_t value_size_prefix_size_ = 0;
+};
+
+}
+}
+}
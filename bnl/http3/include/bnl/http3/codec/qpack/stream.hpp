@@ -0,0 +1,205 @@
+#pragma once
+
+#include <bnl/base/buffer.hpp>
+#include <bnl/base/buffer_builder.hpp>
+#include <bnl/base/buffers.hpp>
+#include <bnl/base/template.hpp>
+#include <bnl/http3/codec/qpack/table.hpp>
+#include <bnl/http3/export.hpp>
+#include <bnl/http3/header.hpp>
+#include <bnl/http3/result.hpp>
+#include <bnl/http3/settings.hpp>
+
+#include <deque>
+#include <map>
+
+// https://quicwg.org/base-drafts/draft-ietf-quic-qpack.html#encoder-and-decoder-streams
+
+namespace bnl {
+namespace http3 {
+namespace qpack {
+
+class encoder;
+class decoder;
+
+namespace stream {
+
+// Connection wide state of the QPACK encoder. `qpack::encoder` inserts headers
+// into the dynamic table while encoding header blocks. The resulting encoder
+// stream instructions are retrieved with `encode` and the peer's decoder
+// stream instructions are processed by `decode`.
+class BNL_HTTP3_EXPORT encoder {
+public:
+  // Upper bound for the dynamic table capacity. The actual capacity is also
+  // limited by the peer's `SETTINGS_QPACK_MAX_TABLE_CAPACITY`.
+  static constexpr uint64_t DEFAULT_CAPACITY = 4096;
+
+  explicit encoder(uint64_t capacity = DEFAULT_CAPACITY) noexcept;
+
+  encoder(encoder &&) = default;
+  encoder &operator=(encoder &&) = default;
+
+  const qpack::table::dynamic &table() const noexcept;
+
+  // Amount of inserts the peer has acknowledged.
+  uint64_t known_received_count() const noexcept;
+
+  // Amount of streams with header blocks referencing unacknowledged inserts.
+  uint64_t blocked_streams() const noexcept;
+
+  // Applies the peer's QPACK settings. The dynamic table isn't used until the
+  // peer's settings have been received.
+  result<void> configure(const settings &peer);
+
+  // Returns the encoder stream instructions written since the last call or
+  // `error::idle` if there are none.
+  result<base::buffer> encode() noexcept;
+
+  // Processes all complete decoder stream instructions in `encoded`.
+  template<typename Sequence>
+  result<void> decode(Sequence &encoded);
+
+private:
+  friend class qpack::encoder;
+
+  // How a header is written to a header block and, optionally, how it is
+  // inserted into the dynamic table before writing it.
+  struct representation {
+    enum class type : uint8_t {
+      none,
+      static_value,
+      static_name,
+      dynamic_value,
+      dynamic_name,
+      literal
+    };
+
+    type insert;
+    uint64_t insert_index;
+
+    type line;
+    uint64_t index;
+  };
+
+  struct block {
+    // Required Insert Count of the header block.
+    uint64_t required;
+    // Smallest absolute index referenced by the header block.
+    uint64_t smallest;
+    // True while the header block is still being encoded.
+    bool open;
+  };
+
+  template<typename Lookahead>
+  result<void> instruction(Lookahead &encoded);
+
+  void insert(const representation &representation, header_view header);
+
+  void reference(uint64_t id, uint64_t index);
+
+  void close(uint64_t id) noexcept;
+
+  bool blocking(uint64_t id) const noexcept;
+
+  // Drops the streams from `blocked_` whose header blocks only reference
+  // acknowledged inserts. Called whenever `known_received_count_` increases.
+  void unblock() noexcept;
+
+  // Returns the absolute index of the first entry that is not evicted when
+  // inserting `size` bytes or `UINT64_MAX` if not enough entries can be
+  // evicted.
+  uint64_t evict(uint64_t size) const noexcept;
+
+private:
+  qpack::table::dynamic table_;
+  base::buffer_builder instructions_;
+
+  // Unacknowledged header blocks that reference the dynamic table by stream.
+  std::map<uint64_t, std::deque<block>> blocks_;
+  // Largest Required Insert Count of the unacknowledged header blocks by
+  // stream, for the streams where it exceeds `known_received_count_`. Kept up
+  // to date so checking the blocked streams limit doesn't walk `blocks_`.
+  std::map<uint64_t, uint64_t> blocked_;
+
+  settings peer_;
+
+  uint64_t capacity_;
+  uint64_t known_received_count_ = 0;
+};
+
+// Connection wide state of the QPACK decoder. The peer's encoder stream
+// instructions are processed by `decode` and the resulting decoder stream
+// instructions are retrieved with `encode`. `qpack::decoder` decodes header
+// blocks that reference the dynamic table.
+class BNL_HTTP3_EXPORT decoder {
+public:
+  // Advertised as `SETTINGS_QPACK_MAX_TABLE_CAPACITY` and
+  // `SETTINGS_QPACK_BLOCKED_STREAMS` by default.
+  static constexpr uint64_t DEFAULT_CAPACITY = 4096;
+  static constexpr uint64_t DEFAULT_BLOCKED_STREAMS = 16;
+
+  explicit decoder(
+    uint64_t capacity = DEFAULT_CAPACITY,
+    uint64_t blocked_streams = DEFAULT_BLOCKED_STREAMS) noexcept;
+
+  decoder(decoder &&) = default;
+  decoder &operator=(decoder &&) = default;
+
+  const qpack::table::dynamic &table() const noexcept;
+
+  // Amount of streams with header blocks waiting for inserts.
+  uint64_t blocked_streams() const noexcept;
+
+  // Returns the id of a stream whose header block was unblocked by processed
+  // inserts or `error::idle` if there are none.
+  result<uint64_t> unblocked() noexcept;
+
+  // Returns the decoder stream instructions written since the last call or
+  // `error::idle` if there are none.
+  result<base::buffer> encode() noexcept;
+
+  // Processes all complete encoder stream instructions in `encoded`.
+  template<typename Sequence>
+  result<void> decode(Sequence &encoded);
+
+private:
+  friend class qpack::decoder;
+
+  template<typename Lookahead>
+  result<void> instruction(Lookahead &encoded);
+
+  // Parks the header block of stream `id` until `required` entries have been
+  // inserted.
+  result<void> block(uint64_t id, uint64_t required);
+
+  void acknowledge(uint64_t id);
+
+private:
+  qpack::table::dynamic table_;
+  base::buffer_builder instructions_;
+
+  // Required Insert Count of blocked header blocks by stream.
+  std::map<uint64_t, uint64_t> blocked_;
+  std::deque<uint64_t> unblocked_;
+
+  uint64_t capacity_;
+  uint64_t max_blocked_streams_;
+
+  // Amount of inserts the peer knows we've received.
+  uint64_t known_received_count_ = 0;
+};
+
+#define BNL_HTTP3_QPACK_STREAM_ENCODER_DECODE_IMPL(T)                          \
+  template BNL_HTTP3_EXPORT result<void> encoder::decode<T>(T &) // NOLINT
+
+BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_QPACK_STREAM_ENCODER_DECODE_IMPL);
+
+#define BNL_HTTP3_QPACK_STREAM_DECODER_DECODE_IMPL(T)                          \
+  template BNL_HTTP3_EXPORT result<void> decoder::decode<T>(T &) // NOLINT
+
+BNL_BASE_SEQUENCE_DECL(BNL_HTTP3_QPACK_STREAM_DECODER_DECODE_IMPL);
+
+}
+}
+}
+}
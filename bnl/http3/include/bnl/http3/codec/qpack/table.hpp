@@ -0,0 +1,64 @@
+#pragma once
+
+#include <bnl/http3/export.hpp>
+#include <bnl/http3/header.hpp>
+
+#include <cstdint>
+#include <deque>
+
+// https://quicwg.org/base-drafts/draft-ietf-quic-qpack.html#header-table
+
+namespace bnl {
+namespace http3 {
+namespace qpack {
+namespace table {
+
+// Entries are identified by their absolute index which starts at zero for the
+// first inserted entry and increments by one for every insertion.
+class BNL_HTTP3_EXPORT dynamic {
+public:
+  // Bytes added to the size of the name and value of each entry.
+  static constexpr uint64_t ENTRY_OVERHEAD = 32;
+
+  static uint64_t entry_size(header_view header) noexcept;
+
+  dynamic() = default;
+
+  dynamic(dynamic &&) = default;
+  dynamic &operator=(dynamic &&) = default;
+
+  uint64_t capacity() const noexcept;
+  uint64_t size() const noexcept;
+
+  // Amount of entries inserted since the table was created. This is also the
+  // absolute index of the next inserted entry.
+  uint64_t inserted() const noexcept;
+  // Absolute index of the oldest entry in the table.
+  uint64_t dropped() const noexcept;
+
+  bool contains(uint64_t index) const noexcept;
+
+  header_view at(uint64_t index) const noexcept;
+
+  // Evicts entries until the table fits in `capacity`.
+  void capacity(uint64_t capacity) noexcept;
+
+  // Evicts entries until `header` fits in the table. `header` should not be
+  // larger than the table's capacity.
+  void insert(header_view header);
+
+private:
+  void evict() noexcept;
+
+private:
+  std::deque<header> entries_;
+
+  uint64_t capacity_ = 0;
+  uint64_t size_ = 0;
+  uint64_t dropped_ = 0;
+};
+
+}
+}
+}
+}
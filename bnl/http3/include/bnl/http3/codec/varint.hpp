@@ -1,6 +1,8 @@
 #pragma once
 
 #include <bnl/base/buffer.hpp>
+#include <bnl/base/buffer_builder.hpp>
+#include <bnl/base/buffer_view.hpp>
 #include <bnl/base/buffers.hpp>
 #include <bnl/base/template.hpp>
 #include <bnl/http3/export.hpp>
@@ -23,13 +25,35 @@ encoded_size(uint64_t varint) noexcept;
 BNL_HTTP3_EXPORT result<size_t>
 encode(uint8_t *dest, uint64_t varint) noexcept;
 
+BNL_HTTP3_EXPORT result<size_t>
+encode(base::buffer_builder &encoded, uint64_t varint);
+
 BNL_HTTP3_EXPORT result<base::buffer>
 encode(uint64_t varint);
 
+// Bulk variants for encoding or decoding multiple varints in one call (e.g.
+// frame headers and settings).
+
+BNL_HTTP3_EXPORT result<size_t>
+encoded_size(const uint64_t *varints, size_t count) noexcept;
+
+// `dest` should have room for `encoded_size(varints, count)` bytes.
+BNL_HTTP3_EXPORT result<size_t>
+encode(uint8_t *dest, const uint64_t *varints, size_t count) noexcept;
+
+BNL_HTTP3_EXPORT result<size_t>
+encode(base::buffer_builder &encoded, const uint64_t *varints, size_t count);
+
 template<typename Sequence>
 BNL_HTTP3_EXPORT result<uint64_t>
 decode(Sequence &encoded) noexcept;
 
+// Decodes `count` varints from `encoded` into `dest` and returns the amount of
+// decoded bytes. Returns `error::incomplete` if `encoded` doesn't contain
+// `count` complete varints.
+BNL_HTTP3_EXPORT result<size_t>
+decode(base::buffer_view encoded, uint64_t *dest, size_t count) noexcept;
+
 #define BNL_HTTP3_VARINT_DECODE_IMPL(T)                                        \
   template BNL_HTTP3_EXPORT result<uint64_t> decode<T>(                        \
     T &) /* NOLINT */ noexcept
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <bnl/http3/export.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <unordered_set>
+
+namespace bnl {
+namespace http3 {
+namespace endpoint {
+
+// Queue of request streams that have something to send. Streams schedule
+// themselves when data is added to them so a connection only visits streams
+// that can make progress instead of polling every open stream. Connections
+// move a stream to the back of the queue after each send so streams are
+// served round-robin.
+class BNL_HTTP3_EXPORT scheduler {
+public:
+  scheduler() = default;
+
+  scheduler(scheduler &&) = default;
+  scheduler &operator=(scheduler &&) = default;
+
+  // Does nothing if `id` is already scheduled.
+  void schedule(uint64_t id);
+
+  bool empty() const noexcept;
+
+  uint64_t front() const noexcept;
+
+  void pop() noexcept;
+
+private:
+  std::deque<uint64_t> ready_;
+  std::unordered_set<uint64_t> scheduled_;
+};
+
+}
+}
+}
@@ -17,7 +17,7 @@ static constexpr uint64_t type = 0x0;
 
 class BNL_HTTP3_EXPORT sender {
 public:
-  explicit sender(uint64_t id) noexcept;
+  sender(uint64_t id, settings settings) noexcept;
 
   sender(sender &&) = default;
   sender &operator=(sender &&) = default;
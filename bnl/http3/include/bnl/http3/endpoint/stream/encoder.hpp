@@ -0,0 +1,64 @@
+#pragma once
+
+#include <bnl/base/buffers.hpp>
+#include <bnl/http3/codec/qpack/stream.hpp>
+#include <bnl/http3/export.hpp>
+#include <bnl/http3/result.hpp>
+#include <bnl/quic/event.hpp>
+
+namespace bnl {
+namespace http3 {
+namespace endpoint {
+namespace stream {
+namespace encoder {
+
+static constexpr uint64_t type = 0x2;
+
+class BNL_HTTP3_EXPORT sender {
+public:
+  sender(uint64_t id, qpack::stream::encoder *qpack) noexcept;
+
+  sender(sender &&) = default;
+  sender &operator=(sender &&) = default;
+
+  result<quic::event> send() noexcept;
+
+private:
+  enum class state : uint8_t { type, instructions };
+
+  state state_ = state::type;
+  qpack::stream::encoder *qpack_;
+
+  uint64_t id_;
+};
+
+// Receives the peer's encoder stream whose instructions update the dynamic
+// table of our QPACK decoder.
+class BNL_HTTP3_EXPORT receiver {
+public:
+  receiver(uint64_t id, qpack::stream::decoder *qpack) noexcept;
+
+  receiver(receiver &&) = default;
+  receiver &operator=(receiver &&) = default;
+
+  uint64_t id() const noexcept;
+
+  result<void> recv(quic::data data);
+
+  result<void> process();
+
+private:
+  enum class state : uint8_t { type, instructions };
+
+  state state_ = state::type;
+  base::buffers buffers_;
+  qpack::stream::decoder *qpack_;
+
+  uint64_t id_;
+};
+
+}
+}
+}
+}
+}
@@ -5,12 +5,15 @@
 #include <bnl/http3/codec/body.hpp>
 #include <bnl/http3/codec/frame.hpp>
 #include <bnl/http3/codec/headers.hpp>
+#include <bnl/http3/endpoint/scheduler.hpp>
 #include <bnl/http3/event.hpp>
 #include <bnl/http3/export.hpp>
 #include <bnl/http3/header.hpp>
 #include <bnl/http3/result.hpp>
 #include <bnl/quic/event.hpp>
 
+#include <vector>
+
 namespace bnl {
 namespace http3 {
 namespace endpoint {
@@ -19,7 +22,9 @@ namespace request {
 
 class BNL_HTTP3_EXPORT sender {
 public:
-  explicit sender(uint64_t id) noexcept;
+  sender(uint64_t id,
+         qpack::stream::encoder *qpack,
+         endpoint::scheduler *scheduler) noexcept;
 
   sender(sender &&other) noexcept;
   sender &operator=(sender &&other) noexcept;
@@ -31,7 +36,13 @@ public:
   result<quic::event> send() noexcept;
 
   result<void> header(header_view header);
+  result<void> header(const qpack::static_header &header);
+  result<void> header(const headers::prototype &prototype);
   result<void> body(base::buffer body);
+  result<void> body(base::file body);
+
+  result<void> configure(body::policy policy) noexcept;
+  result<void> flush() noexcept;
 
   result<void> start() noexcept;
   result<void> fin() noexcept;
@@ -49,7 +60,13 @@ public:
     uint64_t id() const noexcept;
 
     result<void> header(header_view header);
+    result<void> header(const qpack::static_header &header);
+    result<void> header(const headers::prototype &prototype);
     result<void> body(base::buffer body);
+    result<void> body(base::file body);
+
+    result<void> configure(body::policy policy) noexcept;
+    result<void> flush() noexcept;
 
     result<void> start() noexcept;
     result<void> fin() noexcept;
@@ -61,10 +78,15 @@ public:
     stream::request::sender *sender_ = nullptr;
   };
 
+private:
+  // Adds the stream to the scheduler's ready queue after data was added.
+  result<void> schedule(result<void> r);
+
 private:
   enum class state : uint8_t { headers, body, fin };
 
   class handle *handle_ = nullptr;
+  endpoint::scheduler *scheduler_;
 
   state state_ = state::headers;
 
@@ -76,7 +98,7 @@ private:
 
 class BNL_HTTP3_EXPORT receiver {
 public:
-  explicit receiver(uint64_t id) noexcept;
+  receiver(uint64_t id, qpack::stream::decoder *qpack) noexcept;
 
   receiver(receiver &&) = default;
   receiver &operator=(receiver &&) = default;
@@ -98,6 +120,10 @@ protected:
 
   const headers::decoder &headers() const noexcept;
 
+private:
+  // Handles a frame that isn't handled by the headers or body decoder.
+  result<event> delegate() noexcept;
+
 private:
   enum class state : uint8_t { closed, headers, body, fin };
 
@@ -106,8 +132,15 @@ private:
   bool fin_received_ = false;
 
   headers::decoder headers_;
+  // Reused for every header block received on the stream.
+  std::vector<header_view> list_;
   body::decoder body_;
 
+  // Header of the frame handed over by the headers or body decoder while its
+  // payload is being received.
+  frame::header frame_ = {};
+  bool delegated_ = false;
+
   uint64_t id_;
 };
 
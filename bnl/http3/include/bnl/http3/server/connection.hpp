@@ -1,13 +1,17 @@
 #pragma once
 
 #include <bnl/http3/endpoint/generator.hpp>
+#include <bnl/http3/endpoint/scheduler.hpp>
+#include <bnl/http3/endpoint/stream/decoder.hpp>
+#include <bnl/http3/endpoint/stream/encoder.hpp>
 #include <bnl/http3/event.hpp>
 #include <bnl/http3/export.hpp>
 #include <bnl/http3/server/stream/control.hpp>
 #include <bnl/http3/server/stream/request.hpp>
 #include <bnl/quic/event.hpp>
 
-#include <map>
+#include <memory>
+#include <unordered_map>
 
 namespace bnl {
 namespace http3 {
@@ -24,7 +28,7 @@ using generator = endpoint::generator<connection>;
 
 class BNL_HTTP3_EXPORT connection {
 public:
-  connection() = default;
+  connection();
 
   connection(connection &&) = default;
   connection &operator=(connection &&) = default;
@@ -42,11 +46,19 @@ private:
 
   result<event> process(uint64_t id);
 
+  // Processes the request streams whose header blocks were unblocked by the
+  // peer's encoder stream instructions.
+  result<event> unblocked();
+
 private:
   using control = std::pair<server::stream::control::sender,
                             server::stream::control::receiver>;
   using request = std::pair<server::stream::request::sender,
                             server::stream::request::receiver>;
+  using encoder = std::pair<endpoint::stream::encoder::sender,
+                            endpoint::stream::decoder::receiver>;
+  using decoder = std::pair<endpoint::stream::decoder::sender,
+                            endpoint::stream::encoder::receiver>;
 
   struct {
     settings local;
@@ -54,7 +66,21 @@ private:
   } settings_;
 
   control control_;
-  std::map<uint64_t, request> requests_;
+
+  // Streams keep pointers to the QPACK encoder and decoder and the scheduler so
+  // their addresses can't change when the connection is moved.
+  struct {
+    std::unique_ptr<qpack::stream::encoder> encoder;
+    std::unique_ptr<qpack::stream::decoder> decoder;
+  } qpack_;
+  std::unique_ptr<endpoint::scheduler> scheduler_;
+  encoder encoder_;
+  decoder decoder_;
+
+  // Request stream that is currently being processed by `unblocked`.
+  uint64_t unblocked_ = UINT64_MAX;
+
+  std::unordered_map<uint64_t, request> requests_;
 };
 
 }
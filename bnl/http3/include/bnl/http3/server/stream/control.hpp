@@ -11,7 +11,7 @@ namespace control {
 
 class BNL_HTTP3_EXPORT sender : public endpoint::stream::control::sender {
 public:
-  explicit sender() noexcept;
+  explicit sender(settings settings) noexcept;
 };
 
 class BNL_HTTP3_EXPORT receiver : public endpoint::stream::control::receiver {
@@ -2,10 +2,47 @@
 
 #include <bnl/base/log.hpp>
 
+static constexpr uint64_t CLIENT_STREAM_ENCODER_ID = 0x06;
+static constexpr uint64_t SERVER_STREAM_ENCODER_ID = 0x07;
+static constexpr uint64_t CLIENT_STREAM_DECODER_ID = 0x0a;
+static constexpr uint64_t SERVER_STREAM_DECODER_ID = 0x0b;
+
 namespace bnl {
 namespace http3 {
 namespace client {
 
+// Settings advertised by default. The dynamic table capacity and amount of
+// blocked streams match the defaults of `qpack::stream::decoder`.
+static settings
+local_settings() noexcept
+{
+  settings settings;
+  settings.qpack_max_table_capacity = qpack::stream::decoder::DEFAULT_CAPACITY;
+  settings.qpack_blocked_streams =
+    qpack::stream::decoder::DEFAULT_BLOCKED_STREAMS;
+  return settings;
+}
+
+connection::connection()
+  : settings_{ local_settings(), {} }
+  , control_(client::stream::control::sender(settings_.local),
+             client::stream::control::receiver())
+  , qpack_{ std::unique_ptr<qpack::stream::encoder>(
+               new qpack::stream::encoder()),
+             std::unique_ptr<qpack::stream::decoder>(new qpack::stream::decoder(
+               settings_.local.qpack_max_table_capacity,
+               settings_.local.qpack_blocked_streams)) }
+  , scheduler_(new endpoint::scheduler())
+  , encoder_(endpoint::stream::encoder::sender(CLIENT_STREAM_ENCODER_ID,
+                                               qpack_.encoder.get()),
+             endpoint::stream::decoder::receiver(SERVER_STREAM_DECODER_ID,
+                                                 qpack_.encoder.get()))
+  , decoder_(endpoint::stream::decoder::sender(CLIENT_STREAM_DECODER_ID,
+                                               qpack_.decoder.get()),
+             endpoint::stream::encoder::receiver(SERVER_STREAM_ENCODER_ID,
+                                                 qpack_.decoder.get()))
+{}
+
 result<quic::event>
 connection::send() noexcept
 {
@@ -22,16 +59,59 @@ connection::send() noexcept
     }
   }
 
-  for (auto &entry : requests_) {
-    client::stream::request::sender &sender = entry.second.first;
+  // Send the encoder stream instructions before the header blocks that
+  // reference them.
+  {
+    result<quic::event> r = encoder_.first.send();
+    if (r) {
+      return r;
+    }
+
+    if (r.error() != error::idle) {
+      return r.error();
+    }
+  }
+
+  {
+    result<quic::event> r = decoder_.first.send();
+    if (r) {
+      return r;
+    }
+
+    if (r.error() != error::idle) {
+      return r.error();
+    }
+  }
+
+  while (!scheduler_->empty()) {
+    uint64_t id = scheduler_->front();
+
+    auto match = requests_.find(id);
+    // The request might have been closed after it was scheduled.
+    if (match == requests_.end()) {
+      scheduler_->pop();
+      continue;
+    }
+
+    client::stream::request::sender &sender = match->second.first;
 
     if (sender.finished()) {
+      scheduler_->pop();
       continue;
     }
 
+    // Streams take turns: a stream that sent something goes to the back of
+    // the queue. A stream that has nothing left to send is dropped from the
+    // queue and is scheduled again when more data is added.
     result<quic::event> r = sender.send();
     if (r) {
-      client::stream::request::receiver &receiver = entry.second.second;
+      scheduler_->pop();
+
+      if (!sender.finished()) {
+        scheduler_->schedule(id);
+      }
+
+      client::stream::request::receiver &receiver = match->second.second;
 
       if (receiver.closed()) {
         BNL_TRY(receiver.start());
@@ -43,6 +123,8 @@ connection::send() noexcept
     if (r.error() != error::idle) {
       return r.error();
     }
+
+    scheduler_->pop();
   }
 
   return error::idle;
@@ -76,6 +158,18 @@ connection::recv(quic::data data)
     return control.recv(std::move(data));
   }
 
+  endpoint::stream::decoder::receiver &decoder = encoder_.second;
+
+  if (id == decoder.id()) {
+    return decoder.recv(std::move(data));
+  }
+
+  endpoint::stream::encoder::receiver &encoder = decoder_.second;
+
+  if (id == encoder.id()) {
+    return encoder.recv(std::move(data));
+  }
+
   // TODO: Actually handle unidirectional streams.
   if ((data.id & 0x2U) != 0) {
     return base::success();
@@ -103,6 +197,7 @@ connection::process(uint64_t id)
     switch (event) {
       case event::type::settings:
         settings_.peer = event.settings;
+        BNL_TRY(qpack_.encoder->configure(settings_.peer));
         break;
       default:
         break;
@@ -111,6 +206,21 @@ connection::process(uint64_t id)
     return event;
   }
 
+  endpoint::stream::decoder::receiver &decoder = encoder_.second;
+
+  if (id == decoder.id()) {
+    BNL_TRY(decoder.process());
+    // Decoder stream instructions don't produce any events.
+    return error::incomplete;
+  }
+
+  endpoint::stream::encoder::receiver &encoder = decoder_.second;
+
+  if (id == encoder.id()) {
+    BNL_TRY(encoder.process());
+    return unblocked();
+  }
+
   // TODO: Actually handle unidirectional streams.
   if ((id & 0x2U) != 0) {
     return error::incomplete;
@@ -133,13 +243,46 @@ connection::process(uint64_t id)
   return event;
 }
 
+result<event>
+connection::unblocked()
+{
+  while (true) {
+    if (unblocked_ == UINT64_MAX) {
+      result<uint64_t> r = qpack_.decoder->unblocked();
+      if (!r) {
+        if (r.error() == error::idle) {
+          return error::incomplete;
+        }
+
+        return r.error();
+      }
+
+      unblocked_ = r.value();
+    }
+
+    // The request might have been closed while it was blocked.
+    if (requests_.find(unblocked_) == requests_.end()) {
+      unblocked_ = UINT64_MAX;
+      continue;
+    }
+
+    result<event> r = process(unblocked_);
+    if (r || r.error() != error::incomplete) {
+      return r;
+    }
+
+    unblocked_ = UINT64_MAX;
+  }
+}
+
 result<request::handle>
 connection::request()
 {
   uint64_t id = next_stream_id_;
 
-  client::stream::request::sender sender(id);
-  client::stream::request::receiver receiver(id);
+  client::stream::request::sender sender(
+    id, qpack_.encoder.get(), scheduler_.get());
+  client::stream::request::receiver receiver(id, qpack_.decoder.get());
 
   request_t request = std::make_pair(std::move(sender), std::move(receiver));
   requests_.insert(std::make_pair(id, std::move(request)));
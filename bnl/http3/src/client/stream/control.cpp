@@ -9,8 +9,8 @@ namespace client {
 namespace stream {
 namespace control {
 
-sender::sender() noexcept
-  : endpoint::stream::control::sender(CLIENT_STREAM_CONTROL_ID)
+sender::sender(settings settings) noexcept
+  : endpoint::stream::control::sender(CLIENT_STREAM_CONTROL_ID, settings)
 {}
 
 receiver::receiver() noexcept
@@ -6,8 +6,8 @@ namespace client {
 namespace stream {
 namespace request {
 
-receiver::receiver(uint64_t id) noexcept
-  : endpoint::stream::request::receiver(id)
+receiver::receiver(uint64_t id, qpack::stream::decoder *qpack) noexcept
+  : endpoint::stream::request::receiver(id, qpack)
 {}
 
 result<event>
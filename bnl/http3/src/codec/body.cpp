@@ -1,9 +1,18 @@
 #include <bnl/http3/codec/body.hpp>
 
+#include <bnl/base/log.hpp>
+
+#include <algorithm>
+
 namespace bnl {
 namespace http3 {
 namespace body {
 
+// Buffers smaller than this are copied behind their DATA frame header so the
+// header and the payload are sent as a single stream write. Larger buffers
+// are sent without copying them.
+static constexpr size_t COPY_SIZE = 16 * 1024;
+
 result<void>
 encoder::add(base::buffer body)
 {
@@ -11,7 +20,52 @@ encoder::add(base::buffer body)
     return error::internal;
   }
 
-  buffers_.push(std::move(body));
+  if (body.empty()) {
+    return base::success();
+  }
+
+  buffered_ += body.size();
+  parts_.push_back(part{ std::move(body), base::file(), 0 });
+
+  return base::success();
+}
+
+result<void>
+encoder::add(base::file body)
+{
+  if (fin_) {
+    return error::internal;
+  }
+
+  if (body.size() == 0) {
+    return base::success();
+  }
+
+  parts_.push_back(part{ base::buffer(), std::move(body), 0 });
+
+  return base::success();
+}
+
+result<void>
+encoder::configure(policy policy) noexcept
+{
+  if (policy.max_frame_size == 0) {
+    return error::internal;
+  }
+
+  policy_ = policy;
+
+  return base::success();
+}
+
+result<void>
+encoder::flush() noexcept
+{
+  if (fin_) {
+    return error::internal;
+  }
+
+  flush_ = !parts_.empty();
 
   return base::success();
 }
@@ -25,7 +79,9 @@ encoder::fin() noexcept
 
   fin_ = true;
 
-  if (buffers_.empty()) {
+  // The payload of a frame whose header was already encoded still has to be
+  // sent.
+  if (parts_.empty() && state_ != state::data) {
     state_ = state::fin;
   }
 
@@ -46,11 +102,25 @@ encoder::encode() noexcept
   switch (state_) {
 
     case state::frame: {
-      if (buffers_.empty()) {
+      if (parts_.empty() || hold()) {
         return error::idle;
       }
 
-      frame frame = frame::payload::data{ buffers_.front().size() };
+      const part &front = parts_.front();
+
+      if (!front.file.valid() && front.buffer.size() < COPY_SIZE &&
+          front.buffer.size() <= policy_.max_frame_size) {
+        base::buffer encoded = BNL_TRY(coalesced());
+
+        flush_ = flush_ && !parts_.empty();
+        state_ = fin_ && parts_.empty() ? state::fin : state::frame;
+
+        return encoded;
+      }
+
+      data_ = BNL_TRY(next());
+
+      frame frame = frame::payload::data{ data_.size() };
       base::buffer encoded = BNL_TRY(frame::encode(frame));
 
       state_ = state::data;
@@ -59,8 +129,10 @@ encoder::encode() noexcept
     }
 
     case state::data: {
-      base::buffer body = buffers_.pop();
-      state_ = fin_ && buffers_.empty() ? state::fin : state::frame;
+      base::buffer body = std::move(data_);
+
+      flush_ = flush_ && !parts_.empty();
+      state_ = fin_ && parts_.empty() ? state::fin : state::frame;
 
       return body;
     }
@@ -72,29 +144,123 @@ encoder::encode() noexcept
   return error::internal;
 }
 
+bool
+encoder::hold() const noexcept
+{
+  // Files are always large enough to be sent immediately.
+  return !fin_ && !flush_ && buffered_ < policy_.coalesce &&
+         !parts_.front().file.valid();
+}
+
+// Copies consecutive small buffers into a single DATA frame directly behind
+// its header.
+result<base::buffer>
+encoder::coalesced() noexcept
+{
+  size_t size = 0;
+  size_t count = 0;
+
+  for (const part &part : parts_) {
+    if (part.file.valid() || part.buffer.size() >= COPY_SIZE ||
+        size + part.buffer.size() > policy_.max_frame_size) {
+      break;
+    }
+
+    size += part.buffer.size();
+    count++;
+  }
+
+  BNL_TRY(frame::encode(builder_, frame::payload::data{ size }));
+
+  for (size_t i = 0; i < count; i++) {
+    builder_.append(parts_.front().buffer);
+    parts_.pop_front();
+  }
+
+  buffered_ -= size;
+
+  return builder_.finish();
+}
+
+static base::buffers
+split(base::buffer &encoded, size_t size)
+{
+  base::buffers result;
+  result.push(encoded.slice(size));
+  return result;
+}
+
+static base::buffers
+split(base::buffers &encoded, size_t size)
+{
+  return encoded.split(size);
+}
+
+result<base::buffer>
+encoder::next() noexcept
+{
+  part &front = parts_.front();
+
+  if (!front.file.valid()) {
+    size_t size = std::min(front.buffer.size(), policy_.max_frame_size);
+    base::buffer buffer = front.buffer.slice(size);
+    buffered_ -= size;
+
+    if (front.buffer.empty()) {
+      parts_.pop_front();
+    }
+
+    return buffer;
+  }
+
+  uint64_t left = front.file.size() - front.offset;
+  size_t size = static_cast<size_t>(
+    std::min<uint64_t>(left, policy_.max_frame_size));
+
+  base::result<base::buffer, std::error_code> r =
+    front.file.map(front.offset, size);
+  if (!r) {
+    BNL_LOG_E("Failed to map file: {}", r.error().message());
+    return error::internal;
+  }
+
+  front.offset += size;
+
+  if (front.offset == front.file.size()) {
+    parts_.pop_front();
+  }
+
+  return std::move(r).value();
+}
+
 bool
 decoder::in_progress() const noexcept
 {
-  return state_ == decoder::state::data;
+  return state_ == decoder::state::data || parser_.in_progress();
+}
+
+frame::header
+decoder::delegated() const noexcept
+{
+  return delegated_;
 }
 
 template<typename Sequence>
-result<base::buffer>
-decoder::decode(Sequence &encoded)
+result<size_t>
+decoder::next(Sequence &encoded)
 {
   switch (state_) {
 
     case state::frame: {
-      frame::type type = BNL_TRY(frame::peek(encoded));
+      frame::header header = BNL_TRY(parser_.decode(encoded));
 
-      if (type != frame::type::data) {
+      if (header.type != frame::type::data) {
+        delegated_ = header;
         return error::delegate;
       }
 
-      frame frame = BNL_TRY(frame::decode(encoded));
-
       state_ = state::data;
-      remaining_ = frame.data.size;
+      remaining_ = header.size;
     }
     /* FALLTHRU */
     case state::data: {
@@ -105,22 +271,42 @@ decoder::decode(Sequence &encoded)
       size_t body_part_size = encoded.size() < remaining_
                                 ? encoded.size()
                                 : static_cast<size_t>(remaining_);
-      base::buffer body_part = encoded.slice(body_part_size);
 
       remaining_ -= body_part_size;
-
-      assert(encoded.empty() || remaining_ == 0);
-
       state_ = remaining_ == 0 ? state::frame : state_;
 
-      return body_part;
+      return body_part_size;
     }
   }
 
   return error::internal;
 }
 
-BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_BODY_DECODE_IMPL);
+template<typename Sequence>
+result<base::buffers>
+decoder::decode(Sequence &encoded)
+{
+  size_t body_part_size = BNL_TRY(next(encoded));
+  base::buffers body_part = split(encoded, body_part_size);
+
+  assert(encoded.empty() || remaining_ == 0);
+
+  return body_part;
+}
+
+result<base::buffer_view>
+decoder::decode(base::cursor &encoded)
+{
+  size_t body_part_size = BNL_TRY(next(encoded));
+  base::buffer_view body_part(encoded.contiguous().data(), body_part_size);
+
+  encoded.consume(body_part_size);
+
+  return body_part;
+}
+
+BNL_HTTP3_BODY_DECODE_IMPL(base::buffer);
+BNL_HTTP3_BODY_DECODE_IMPL(base::buffers);
 
 }
 }
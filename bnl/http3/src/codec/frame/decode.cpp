@@ -2,38 +2,11 @@
 
 #include <bnl/base/log.hpp>
 
+#include <algorithm>
+
 namespace bnl {
 namespace http3 {
 
-template<typename Sequence>
-result<frame::type>
-frame::peek(const Sequence &encoded) noexcept
-{
-  typename Sequence::lookahead_type lookahead(encoded);
-
-  while (true) {
-    uint64_t type = BNL_TRY(varint::decode(lookahead));
-
-    switch (static_cast<frame::type>(type)) {
-      case frame::type::data:
-      case frame::type::headers:
-      case frame::type::priority:
-      case frame::type::cancel_push:
-      case frame::type::settings:
-      case frame::type::push_promise:
-      case frame::type::goaway:
-      case frame::type::max_push_id:
-      case frame::type::duplicate_push:
-        return static_cast<frame::type>(type);
-      default:
-        continue;
-    }
-  }
-
-  assert(false);
-  return base::success();
-}
-
 template<typename Lookahead>
 result<uint8_t>
 uint8_decode(Lookahead &lookahead) noexcept
@@ -49,13 +22,38 @@ uint8_decode(Lookahead &lookahead) noexcept
   return result;
 }
 
+// Decodes `count` varints into `dest`. Varints in contiguous memory are
+// decoded with a single bulk call. Only varints that span multiple buffers
+// are decoded one at a time.
 template<typename Lookahead>
-result<frame>
-decode_single(Lookahead &lookahead) noexcept
+result<void>
+varints_decode(Lookahead &lookahead, uint64_t *dest, size_t count) noexcept
 {
-  uint64_t type = BNL_TRY(varint::decode(lookahead));
-  uint64_t payload_encoded_size = BNL_TRY(varint::decode(lookahead));
+  base::buffer_view contiguous = lookahead.contiguous();
+
+  result<size_t> r = varint::decode(contiguous, dest, count);
+  if (r) {
+    lookahead.consume(r.value());
+    return base::success();
+  }
+
+  if (contiguous.size() == lookahead.size()) {
+    return r.error();
+  }
 
+  for (size_t i = 0; i < count; i++) {
+    dest[i] = BNL_TRY(varint::decode(lookahead));
+  }
+
+  return base::success();
+}
+
+template<typename Lookahead>
+result<frame>
+decode_payload(Lookahead &lookahead,
+               uint64_t type,
+               uint64_t payload_encoded_size) noexcept
+{
   // Use lambda to get around lack of copy assignment operator on `frame`.
   auto payload_decode = [&]() -> result<frame> {
     switch (static_cast<frame::type>(type)) {
@@ -110,8 +108,12 @@ decode_single(Lookahead &lookahead) noexcept
 
         while (settings_encoded_size < payload_encoded_size) {
           size_t before = lookahead.consumed();
-          uint64_t id = BNL_TRY(varint::decode(lookahead));
-          uint64_t value = BNL_TRY(varint::decode(lookahead));
+
+          uint64_t setting[2];
+          BNL_TRY(varints_decode(lookahead, setting, 2));
+
+          uint64_t id = setting[0];
+          uint64_t value = setting[1];
 
           settings_encoded_size += lookahead.consumed() - before;
 
@@ -211,6 +213,16 @@ decode_single(Lookahead &lookahead) noexcept
   return frame;
 }
 
+template<typename Lookahead>
+result<frame>
+decode_single(Lookahead &lookahead) noexcept
+{
+  uint64_t header[2];
+  BNL_TRY(varints_decode(lookahead, header, 2));
+
+  return decode_payload(lookahead, header[0], header[1]);
+}
+
 template<typename Sequence>
 result<frame>
 frame::decode(Sequence &encoded) noexcept
@@ -233,11 +245,128 @@ frame::decode(Sequence &encoded) noexcept
   }
 }
 
-BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_FRAME_PEEK_IMPL);
-BNL_BASE_LOOKAHEAD_IMPL(BNL_HTTP3_FRAME_PEEK_IMPL);
+template<typename Sequence>
+result<frame>
+frame::decode(Sequence &encoded, header header) noexcept
+{
+  typename Sequence::lookahead_type lookahead(encoded);
+
+  frame frame = BNL_TRY(decode_payload(
+    lookahead, static_cast<uint64_t>(header.type), header.size));
+
+  encoded.consume(lookahead.consumed());
+
+  return frame;
+}
+
+static bool
+known(uint64_t type) noexcept
+{
+  switch (static_cast<frame::type>(type)) {
+    case frame::type::data:
+    case frame::type::headers:
+    case frame::type::priority:
+    case frame::type::cancel_push:
+    case frame::type::settings:
+    case frame::type::push_promise:
+    case frame::type::goaway:
+    case frame::type::max_push_id:
+    case frame::type::duplicate_push:
+      return true;
+  }
+
+  return false;
+}
+
+bool
+frame::parser::in_progress() const noexcept
+{
+  return state_ != state::type || missing_ > 0;
+}
+
+template<typename Sequence>
+result<uint64_t>
+frame::parser::varint(Sequence &encoded) noexcept
+{
+  if (missing_ == 0) {
+    if (encoded.empty()) {
+      return error::incomplete;
+    }
+
+    // The two most significant bits of the first byte encode the varint size.
+    uint8_t first = encoded[0];
+    size_t size = static_cast<size_t>(1U) << static_cast<uint8_t>(first >> 6U);
+
+    varint_ = first & 0x3fU;
+    missing_ = size - 1;
+
+    encoded.consume(1);
+  }
+
+  size_t available = std::min(missing_, encoded.size());
+
+  for (size_t i = 0; i < available; i++) {
+    varint_ = varint_ << 8U | encoded[i];
+  }
+
+  encoded.consume(available);
+  missing_ -= available;
+
+  if (missing_ > 0) {
+    return error::incomplete;
+  }
+
+  return varint_;
+}
+
+template<typename Sequence>
+result<frame::header>
+frame::parser::decode(Sequence &encoded) noexcept
+{
+  while (true) {
+    switch (state_) {
+
+      case state::type:
+        type_ = BNL_TRY(varint(encoded));
+        state_ = state::size;
+        /* FALLTHRU */
+
+      case state::size: {
+        uint64_t size = BNL_TRY(varint(encoded));
+
+        if (known(type_)) {
+          state_ = state::type;
+          return frame::header{ static_cast<frame::type>(type_), size };
+        }
+
+        // https://quicwg.org/base-drafts/draft-ietf-quic-http.html#extensions
+        state_ = state::skip;
+        skip_ = size;
+      }
+        /* FALLTHRU */
+
+      case state::skip: {
+        size_t skipped = encoded.size() < skip_ ? encoded.size()
+                                                : static_cast<size_t>(skip_);
+        encoded.consume(skipped);
+        skip_ -= skipped;
+
+        if (skip_ > 0) {
+          return error::incomplete;
+        }
+
+        state_ = state::type;
+        break;
+      }
+    }
+  }
+}
 
 BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_FRAME_DECODE_IMPL);
 BNL_BASE_LOOKAHEAD_IMPL(BNL_HTTP3_FRAME_DECODE_IMPL);
 
+BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_FRAME_DECODE_PAYLOAD_IMPL);
+BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_FRAME_PARSER_DECODE_IMPL);
+
 }
 }
@@ -5,6 +5,26 @@
 namespace bnl {
 namespace http3 {
 
+// Stores the id and value of each setting that has to be sent in `dest` so
+// they can be encoded with a single bulk varint call. Returns the amount of
+// varints stored in `dest`.
+static size_t
+settings_flatten(const settings &settings, uint64_t *dest) noexcept
+{
+  size_t count = 0;
+
+  for (auto setting : settings.array()) {
+    if (setting.first == setting::num_placeholders && setting.second == 0) {
+      continue;
+    }
+
+    dest[count++] = setting.first;
+    dest[count++] = setting.second;
+  }
+
+  return count;
+}
+
 result<uint64_t>
 payload_size(const frame &frame) noexcept
 {
@@ -39,16 +59,12 @@ payload_size(const frame &frame) noexcept
       break;
     }
 
-    case frame::type::settings:
-      for (auto setting : frame.settings.array()) {
-        if (setting.first == setting::num_placeholders && setting.second == 0) {
-          continue;
-        }
-
-        payload_size += BNL_TRY(varint::encoded_size(setting.first));
-        payload_size += BNL_TRY(varint::encoded_size(setting.second));
-      }
+    case frame::type::settings: {
+      uint64_t varints[2 * settings::size];
+      size_t count = settings_flatten(frame.settings, varints);
+      payload_size += BNL_TRY(varint::encoded_size(varints, count));
       break;
+    }
 
     case frame::type::push_promise: {
       uint64_t push_id = frame.push_promise.push_id;
@@ -109,9 +125,8 @@ frame::encoded_size(const frame &frame) noexcept
 
   size_t encoded_size = 0;
 
-  uint64_t type = enumeration::value(frame.type_);
-  encoded_size += BNL_TRY(varint::encoded_size(type));
-  encoded_size += BNL_TRY(varint::encoded_size(payload_size));
+  uint64_t header[] = { enumeration::value(frame.type_), payload_size };
+  encoded_size += BNL_TRY(varint::encoded_size(header, 2));
   encoded_size += payload_encoded_size;
 
   return encoded_size;
@@ -126,8 +141,8 @@ frame::encode(uint8_t *dest, const frame &frame) noexcept
 
   uint64_t payload_size = BNL_TRY(http3::payload_size(frame));
 
-  dest += BNL_TRY(varint::encode(dest, enumeration::value(frame.type_)));
-  dest += BNL_TRY(varint::encode(dest, payload_size));
+  uint64_t header[] = { enumeration::value(frame.type_), payload_size };
+  dest += BNL_TRY(varint::encode(dest, header, 2));
 
   switch (frame) {
     case frame::type::data:
@@ -161,16 +176,12 @@ frame::encode(uint8_t *dest, const frame &frame) noexcept
     case frame::type::cancel_push:
       dest += BNL_TRY(varint::encode(dest, frame.cancel_push.push_id));
       break;
-    case frame::type::settings:
-      for (auto setting : frame.settings.array()) {
-        if (setting.first == setting::num_placeholders && setting.second == 0) {
-          continue;
-        }
-
-        dest += BNL_TRY(varint::encode(dest, setting.first));
-        dest += BNL_TRY(varint::encode(dest, setting.second));
-      }
+    case frame::type::settings: {
+      uint64_t varints[2 * settings::size];
+      size_t count = settings_flatten(frame.settings, varints);
+      dest += BNL_TRY(varint::encode(dest, varints, count));
       break;
+    }
     case frame::type::push_promise:
       dest += BNL_TRY(varint::encode(dest, frame.push_promise.push_id));
       break;
@@ -188,6 +199,17 @@ frame::encode(uint8_t *dest, const frame &frame) noexcept
   return static_cast<size_t>(dest - begin);
 }
 
+result<size_t>
+frame::encode(base::buffer_builder &encoded, const frame &frame)
+{
+  size_t encoded_size = BNL_TRY(frame::encoded_size(frame));
+
+  BNL_TRY(encode(encoded.reserve(encoded_size), frame));
+  encoded.advance(encoded_size);
+
+  return encoded_size;
+}
+
 result<base::buffer>
 frame::encode(const frame &frame)
 {
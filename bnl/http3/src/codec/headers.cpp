@@ -4,6 +4,46 @@ namespace bnl {
 namespace http3 {
 namespace headers {
 
+// Frame type (HEADERS fits in a single byte) + maximum varint size.
+static constexpr size_t FRAME_HEADER_MAX_ENCODED_SIZE = 1 + sizeof(uint64_t);
+
+// Required Insert Count (8-bit prefix) + Delta Base (7-bit prefix). Both are
+// smaller than 2^64 which takes at most 10 bytes after the prefix.
+static constexpr size_t QPACK_PREFIX_MAX_ENCODED_SIZE = 2 * (1 + 10);
+
+static constexpr size_t RESERVED_ENCODED_SIZE =
+  FRAME_HEADER_MAX_ENCODED_SIZE + QPACK_PREFIX_MAX_ENCODED_SIZE;
+
+result<void>
+prototype::add(header_view header)
+{
+  // Without a `qpack::stream::encoder`, the QPACK encoder only uses the static
+  // table and the header block prefix is left to `fin`.
+  qpack::encoder qpack(0, nullptr);
+  base::buffer encoded = BNL_TRY(qpack.encode(header));
+
+  encoded_ = base::buffer::concat(encoded_, encoded);
+  size_++;
+
+  return base::success();
+}
+
+size_t
+prototype::size() const noexcept
+{
+  return size_;
+}
+
+base::buffer_view
+prototype::encoded() const noexcept
+{
+  return encoded_;
+}
+
+encoder::encoder(uint64_t id, qpack::stream::encoder *qpack) noexcept
+  : qpack_(id, qpack)
+{}
+
 result<void>
 encoder::add(header_view header)
 {
@@ -11,8 +51,50 @@ encoder::add(header_view header)
     return error::internal;
   }
 
-  base::buffer encoded = BNL_TRY(qpack_.encode(header));
-  buffers_.push(std::move(encoded));
+  if (encoded_.empty()) {
+    encoded_.reserve(RESERVED_ENCODED_SIZE);
+    encoded_.advance(RESERVED_ENCODED_SIZE);
+  }
+
+  BNL_TRY(qpack_.encode(encoded_, header));
+
+  return base::success();
+}
+
+result<void>
+encoder::add(const qpack::static_header &header)
+{
+  if (state_ != state::idle) {
+    return error::internal;
+  }
+
+  if (encoded_.empty()) {
+    encoded_.reserve(RESERVED_ENCODED_SIZE);
+    encoded_.advance(RESERVED_ENCODED_SIZE);
+  }
+
+  BNL_TRY(qpack_.encode(encoded_, header));
+
+  return base::success();
+}
+
+result<void>
+encoder::add(const prototype &prototype)
+{
+  if (state_ != state::idle) {
+    return error::internal;
+  }
+
+  if (prototype.size() == 0) {
+    return base::success();
+  }
+
+  if (encoded_.empty()) {
+    encoded_.reserve(RESERVED_ENCODED_SIZE);
+    encoded_.advance(RESERVED_ENCODED_SIZE);
+  }
+
+  qpack_.append(encoded_, prototype.encoded());
 
   return base::success();
 }
@@ -24,6 +106,11 @@ encoder::fin() noexcept
     return error::internal;
   }
 
+  // HEADERS frames without any headers are malformed.
+  if (encoded_.empty()) {
+    return error::internal;
+  }
+
   state_ = state::frame;
 
   return base::success();
@@ -44,18 +131,27 @@ encoder::encode() noexcept
       return error::idle;
 
     case state::frame: {
+      // Encode the header block prefix and the frame header right in front of
+      // the QPACK encoded headers and skip the unused part of the reserved
+      // space.
+      size_t prefix_encoded_size = qpack_.prefix_encoded_size();
+      assert(prefix_encoded_size <= QPACK_PREFIX_MAX_ENCODED_SIZE);
+
+      size_t offset = RESERVED_ENCODED_SIZE - prefix_encoded_size;
+      qpack_.fin(&encoded_[offset]);
+
       frame frame = frame::payload::headers{ qpack_.count() };
 
-      base::buffer encoded = BNL_TRY(frame::encode(frame));
+      size_t frame_encoded_size = BNL_TRY(frame::encoded_size(frame));
+      assert(frame_encoded_size <= FRAME_HEADER_MAX_ENCODED_SIZE);
 
-      state_ = state::qpack;
+      offset -= frame_encoded_size;
+      BNL_TRY(frame::encode(&encoded_[offset], frame));
 
-      return encoded;
-    }
+      base::buffer encoded = encoded_.finish();
+      encoded.consume(offset);
 
-    case state::qpack: {
-      base::buffer encoded = buffers_.pop();
-      state_ = buffers_.empty() ? state::fin : state_;
+      state_ = state::fin;
 
       return encoded;
     }
@@ -67,6 +163,10 @@ encoder::encode() noexcept
   return error::internal;
 }
 
+decoder::decoder(uint64_t id, qpack::stream::decoder *qpack) noexcept
+  : qpack_(id, qpack)
+{}
+
 bool
 decoder::started() const noexcept
 {
@@ -79,40 +179,82 @@ decoder::finished() const noexcept
   return state_ == state::fin;
 }
 
+bool
+decoder::blocked() const noexcept
+{
+  return qpack_.blocked();
+}
+
+frame::header
+decoder::delegated() const noexcept
+{
+  return delegated_;
+}
+
 template<typename Sequence>
-result<header>
+void
+decoder::block(Sequence &encoded, size_t size)
+{
+  block_ = encoded.slice(size);
+}
+
+void
+decoder::block(base::cursor &encoded, size_t size) noexcept
+{
+  view_ = base::cursor(encoded.contiguous().data(), size);
+  encoded.consume(size);
+}
+
+template<typename Sequence>
+result<header_view>
 decoder::decode(Sequence &encoded)
 {
   switch (state_) {
 
     case state::frame: {
-      frame::type type = BNL_TRY(frame::peek(encoded));
+      frame::header header = BNL_TRY(parser_.decode(encoded));
 
-      if (type != frame::type::headers) {
+      if (header.type != frame::type::headers) {
+        delegated_ = header;
         return error::delegate;
       }
 
-      frame frame = BNL_TRY(frame::decode(encoded));
-
-      state_ = state::qpack;
-      headers_size_ = frame.headers.size;
+      state_ = state::block;
+      headers_size_ = header.size;
 
       if (headers_size_ == 0) {
         return error::malformed_frame;
       }
     }
     /* FALLTHRU */
-    case state::qpack: {
-      header header = BNL_TRY(qpack_.decode(encoded));
+    case state::block: {
+      if (encoded.size() < headers_size_) {
+        return error::incomplete;
+      }
 
-      if (qpack_.count() > headers_size_) {
-        return error::malformed_frame;
+      block(encoded, static_cast<size_t>(headers_size_));
+      state_ = state::qpack;
+    }
+    /* FALLTHRU */
+    case state::qpack: {
+      result<header_view> r = view_.empty() ? qpack_.decode_view(block_)
+                                            : qpack_.decode_view(view_);
+      if (!r) {
+        // The full header block is available so it can only be incomplete if
+        // it's waiting for dynamic table inserts.
+        if (r.error() == error::incomplete && !qpack_.blocked()) {
+          return error::malformed_frame;
+        }
+
+        return r.error();
       }
 
-      bool fin = qpack_.count() == headers_size_;
-      state_ = fin ? state::fin : state_;
+      if (block_.empty() && view_.empty()) {
+        qpack_.fin();
+        state_ = state::fin;
+      }
 
-      return header;
+      return r.value();
     }
 
     case state::fin:
@@ -122,7 +264,24 @@ decoder::decode(Sequence &encoded)
   return error::internal;
 }
 
+template<typename Sequence>
+result<void>
+decoder::decode(Sequence &encoded, std::vector<header_view> &headers)
+{
+  headers.clear();
+
+  // The first header is only decoded once the full header block is available
+  // and not blocked so the remaining headers can't be incomplete.
+  do {
+    header_view header = BNL_TRY(decode(encoded));
+    headers.push_back(header);
+  } while (!finished());
+
+  return base::success();
+}
+
 BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_HEADERS_DECODE_IMPL);
+BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_HEADERS_DECODE_LIST_IMPL);
 
 }
 }
@@ -2,6 +2,7 @@
 
 #include <bnl/base/log.hpp>
 
+#include <algorithm>
 #include <tuple>
 
 #include "decode_generated.cpp"
@@ -10,107 +11,317 @@ namespace bnl {
 namespace http3 {
 namespace qpack {
 
+static constexpr uint8_t DELTA_BASE_SIGN = 0x80;
+
+static constexpr uint8_t INDEXED_HEADER_FIELD_STATIC = 0x40;
+static constexpr uint8_t LITERAL_WITH_NAME_REFERENCE_STATIC = 0x10;
+static constexpr uint8_t INDEXED_HEADER_FIELD_POST_BASE_PREFIX = 0x10;
+
+decoder::decoder(uint64_t id, stream::decoder *stream) noexcept
+  : id_(id)
+  , stream_(stream)
+{}
+
 uint64_t
 decoder::count() const noexcept
 {
   return count_;
 }
 
-static constexpr size_t QPACK_PREFIX_ENCODED_SIZE = 2;
+bool
+decoder::blocked() const noexcept
+{
+  return state_ == state::blocked && required_ > stream_->table_.inserted();
+}
+
+// Returns the absolute index of a dynamic table reference relative to `base`
+// or `UINT64_MAX` if it doesn't refer to a valid index.
+static uint64_t
+relative_to_absolute(uint64_t base, uint64_t relative) noexcept
+{
+  return relative < base ? base - 1 - relative : UINT64_MAX;
+}
+
+static uint64_t
+post_base_to_absolute(uint64_t base, uint64_t post_base) noexcept
+{
+  return post_base < UINT64_MAX - base ? base + post_base : UINT64_MAX;
+}
 
 template<typename Sequence>
 result<header>
 decoder::decode(Sequence &encoded)
+{
+  BNL_TRY(start(encoded));
+
+  typename Sequence::lookahead_type lookahead(encoded);
+
+  // The header is copied before consuming `encoded` so the arena can be
+  // reused for the next header.
+  base::arena::marker marker = arena_.mark();
+  result<header_view> r = line(lookahead);
+  header header = r ? http3::header(r.value()) : http3::header();
+  arena_.rewind(marker);
+
+  if (!r) {
+    return r.error();
+  }
+
+  count_ += lookahead.consumed();
+  encoded.consume(lookahead.consumed());
+
+  return header;
+}
+
+result<header_view>
+decoder::decode_view(base::buffer &encoded)
+{
+  return view(encoded);
+}
+
+result<header_view>
+decoder::decode_view(base::cursor &encoded)
+{
+  return view(encoded);
+}
+
+template<typename Sequence>
+result<header_view>
+decoder::view(Sequence &encoded)
+{
+  BNL_TRY(start(encoded));
+
+  typename Sequence::lookahead_type lookahead(encoded);
+
+  base::arena::marker marker = arena_.mark();
+  result<header_view> r = line(lookahead);
+
+  if (!r) {
+    arena_.rewind(marker);
+    return r.error();
+  }
+
+  count_ += lookahead.consumed();
+  encoded.consume(lookahead.consumed());
+
+  return r.value();
+}
+
+template<typename Sequence>
+result<void>
+decoder::start(Sequence &encoded)
 {
   if (state_ == state::prefix) {
-    if (encoded.size() < QPACK_PREFIX_ENCODED_SIZE) {
+    typename Sequence::lookahead_type lookahead(encoded);
+
+    BNL_TRY(prefix(lookahead));
+
+    count_ += lookahead.consumed();
+    encoded.consume(lookahead.consumed());
+
+    state_ = state::blocked;
+  }
+
+  if (state_ == state::blocked) {
+    if (required_ > 0 && required_ > stream_->table_.inserted()) {
+      BNL_TRY(stream_->block(id_, required_));
       return error::incomplete;
     }
 
-    encoded.consume(QPACK_PREFIX_ENCODED_SIZE);
-    count_ += QPACK_PREFIX_ENCODED_SIZE;
     state_ = state::header;
   }
 
-  header header;
-  typename Sequence::lookahead_type lookahead(encoded);
+  return base::success();
+}
 
-  if (lookahead.empty()) {
+template<typename Lookahead>
+result<header_view>
+decoder::line(Lookahead &encoded)
+{
+  if (encoded.empty()) {
     return error::incomplete;
   }
 
-  switch (table::fixed::find_type(*lookahead)) {
+  uint8_t byte = *encoded;
+
+  switch (table::fixed::find_type(byte)) {
 
     case table::fixed::type::header_value: {
-      if ((*lookahead & 0x40U) == 0) {
-        BNL_LOG_E("'S' (static table) bit not set in indexed header field");
-        return error::qpack_decompression_failed;
-      }
+      uint64_t index = BNL_TRY(prefix_int::decode(encoded, 6));
 
-      uint8_t index =
-        static_cast<uint8_t>(BNL_TRY(prefix_int::decode(lookahead, 6)));
+      if ((byte & INDEXED_HEADER_FIELD_STATIC) == 0) {
+        return entry(relative_to_absolute(base_, index));
+      }
 
       bool found = false;
-      std::tie(found, header) = table::fixed::find_header_value(index);
+      header_view header;
+
+      if (index <= UINT8_MAX) {
+        std::tie(found, header) =
+          table::fixed::find_header_value(static_cast<uint8_t>(index));
+      }
 
       if (!found) {
         BNL_LOG_E("Indexed header field ({}) not found in static table", index);
         return error::qpack_decompression_failed;
       }
 
-      break;
+      return header;
     }
 
     case table::fixed::type::header_only: {
-      if ((*lookahead & 0x10U) == 0) {
-        BNL_LOG_E(
-          "'S' (static table) bit not set in literal with name reference");
-        return error::qpack_decompression_failed;
-      }
-
-      uint8_t index =
-        static_cast<uint8_t>(BNL_TRY(prefix_int::decode(lookahead, 4)));
-
-      bool found = false;
-      base::string name;
-      std::tie(found, name) = table::fixed::find_header_only(index);
-
-      if (!found) {
-        BNL_LOG_E("Header name reference ({}) not found in static table",
-                  index);
-        return error::qpack_decompression_failed;
+      uint64_t index = BNL_TRY(prefix_int::decode(encoded, 4));
+      base::string_view name;
+
+      if ((byte & LITERAL_WITH_NAME_REFERENCE_STATIC) == 0) {
+        header_view entry =
+          BNL_TRY(this->entry(relative_to_absolute(base_, index)));
+        name = entry.name();
+      } else {
+        bool found = false;
+
+        if (index <= UINT8_MAX) {
+          std::tie(found, name) =
+            table::fixed::find_header_only(static_cast<uint8_t>(index));
+        }
+
+        if (!found) {
+          BNL_LOG_E("Header name reference ({}) not found in static table",
+                    index);
+          return error::qpack_decompression_failed;
+        }
       }
 
-      base::string value = BNL_TRY(literal::decode(lookahead, 7));
+      base::string_view value = BNL_TRY(literal::decode(encoded, 7, arena_));
 
-      header = http3::header(std::move(name), std::move(value));
-      break;
+      return header_view(name, value);
     }
 
     case table::fixed::type::missing: {
-      base::string name = BNL_TRY(literal::decode(lookahead, 3));
-      base::string value = BNL_TRY(literal::decode(lookahead, 7));
+      base::string_view name = BNL_TRY(literal::decode(encoded, 3, arena_));
+      base::string_view value = BNL_TRY(literal::decode(encoded, 7, arena_));
 
-      header = http3::header(std::move(name), std::move(value));
+      header_view header(name, value);
 
       if (!header_is_lowercase(header)) {
         BNL_LOG_E("Header ({}) is not lowercase", header);
         return error::malformed_header;
       }
 
-      break;
+      return header;
     }
 
     case table::fixed::type::unknown:
-      BNL_LOG_E("Unexpected header block instruction prefix ({})", *lookahead);
+      break;
+  }
+
+  // Post-base references to entries inserted while encoding the header block.
+  if ((byte & INDEXED_HEADER_FIELD_POST_BASE_PREFIX) != 0) {
+    uint64_t index = BNL_TRY(prefix_int::decode(encoded, 4));
+    return entry(post_base_to_absolute(base_, index));
+  }
+
+  uint64_t index = BNL_TRY(prefix_int::decode(encoded, 3));
+  header_view entry = BNL_TRY(this->entry(post_base_to_absolute(base_, index)));
+  base::string_view value = BNL_TRY(literal::decode(encoded, 7, arena_));
+
+  return header_view(entry.name(), value);
+}
+
+void
+decoder::fin()
+{
+  if (stream_ != nullptr && required_ > 0) {
+    stream_->acknowledge(id_);
+  }
+}
+
+template<typename Lookahead>
+result<void>
+decoder::prefix(Lookahead &encoded)
+{
+  uint64_t encoded_required = BNL_TRY(prefix_int::decode(encoded, 8));
+
+  if (encoded.empty()) {
+    return error::incomplete;
+  }
+
+  bool sign = (*encoded & DELTA_BASE_SIGN) != 0;
+  uint64_t delta = BNL_TRY(prefix_int::decode(encoded, 7));
+
+  if (encoded_required == 0) {
+    return base::success();
+  }
+
+  if (stream_ == nullptr) {
+    BNL_LOG_E("Header block references the dynamic table");
+    return error::qpack_decompression_failed;
+  }
+
+  // https://quicwg.org/base-drafts/draft-ietf-quic-qpack.html#ric
+  uint64_t max_entries = stream_->capacity_ / table::dynamic::ENTRY_OVERHEAD;
+  uint64_t full_range = 2 * max_entries;
+
+  if (encoded_required > full_range) {
+    BNL_LOG_E("Invalid encoded required insert count ({})", encoded_required);
+    return error::qpack_decompression_failed;
+  }
+
+  uint64_t max_value = stream_->table_.inserted() + max_entries;
+  uint64_t max_wrapped = (max_value / full_range) * full_range;
+  uint64_t required = max_wrapped + encoded_required - 1;
+
+  if (required > max_value) {
+    if (required <= full_range) {
+      BNL_LOG_E("Invalid required insert count ({})", required);
       return error::qpack_decompression_failed;
+    }
+
+    required -= full_range;
   }
 
-  count_ += lookahead.consumed();
+  if (required == 0) {
+    BNL_LOG_E("Invalid required insert count ({})", required);
+    return error::qpack_decompression_failed;
+  }
 
-  encoded.consume(lookahead.consumed());
+  if (sign && delta >= required) {
+    BNL_LOG_E("Invalid delta base ({})", delta);
+    return error::qpack_decompression_failed;
+  }
 
-  return header;
+  required_ = required;
+  base_ = sign ? required - delta - 1 : required + delta;
+
+  return base::success();
+}
+
+result<header_view>
+decoder::entry(uint64_t index)
+{
+  // Header blocks can't reference entries at or beyond their Required Insert
+  // Count.
+  if (stream_ == nullptr || index >= required_ ||
+      !stream_->table_.contains(index)) {
+    BNL_LOG_E("Dynamic table entry ({}) cannot be referenced", index);
+    return error::qpack_decompression_failed;
+  }
+
+  // Entries can be evicted once the header block has been acknowledged so
+  // they're copied into the arena.
+  header_view entry = stream_->table_.at(index);
+
+  size_t size = entry.name().size() + entry.value().size();
+  char *data = arena_.allocate(size);
+
+  std::copy_n(entry.name().data(), entry.name().size(), data);
+  std::copy_n(entry.value().data(),
+              entry.value().size(),
+              data + entry.name().size());
+
+  return header_view(base::string_view(data, entry.name().size()),
+                     base::string_view(data + entry.name().size(),
+                                       entry.value().size()));
 }
 
 BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_QPACK_DECODE_IMPL);
@@ -1,4 +1,4 @@
-#include <bnl/base/string.hpp>
+#include <bnl/base/string_view.hpp>
 #include <bnl/http3/header.hpp>
 
 #include <cstdint>
@@ -36,7 +36,7 @@ find_type(uint8_t byte)
   return type::unknown;
 }
 
-std::pair<bool, header>
+std::pair<bool, header_view>
 find_header_value(uint8_t index)
 {
   switch (index) {
@@ -207,7 +207,7 @@ find_header_value(uint8_t index)
   return { false, {} };
 }
 
-std::pair<bool, base::string>
+std::pair<bool, base::string_view>
 find_header_only(uint8_t index)
 {
   switch (index) {
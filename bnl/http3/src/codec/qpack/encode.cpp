@@ -12,91 +12,275 @@ namespace bnl {
 namespace http3 {
 namespace qpack {
 
+encoder::encoder(uint64_t id, stream::encoder *stream) noexcept
+  : deferred_(true)
+  , id_(id)
+  , stream_(stream)
+{}
+
 uint64_t
 encoder::count() const noexcept
 {
   return count_;
 }
 
-result<size_t>
-encoder::encoded_size(header_view header) const noexcept
+// Headers that are (almost) never repeated with the same value. Inserting them
+// into the dynamic table would only evict entries that are actually reused.
+static constexpr const char *NOT_INDEXED[] = { ":path",
+                                               "age",
+                                               "authorization",
+                                               "content-length",
+                                               "date",
+                                               "etag",
+                                               "last-modified",
+                                               "location",
+                                               "set-cookie" };
+
+static bool
+indexed(header_view header, uint64_t capacity) noexcept
 {
-  if (!header_is_lowercase(header)) {
-    BNL_LOG_E("Header ({}) is not lowercase", header);
-    return error::malformed_header;
+  for (const char *name : NOT_INDEXED) {
+    if (header.name() == name) {
+      return false;
+    }
   }
 
-  size_t encoded_size = 0;
+  // Large entries evict too many other entries.
+  return table::dynamic::entry_size(header) <= capacity / 4;
+}
 
-  if (state_ == state::prefix) {
-    encoded_size += QPACK_PREFIX_ENCODED_SIZE;
-  }
+encoder::representation
+encoder::find(header_view header) const noexcept
+{
+  using type = representation::type;
 
-  table::fixed::type type;
-  uint8_t index = 0;
-  std::tie(type, index) = table::fixed::find_index(header);
+  representation representation = { type::none, 0, type::literal, 0 };
 
-  switch (type) {
+  table::fixed::type fixed;
+  uint8_t index = 0;
+  std::tie(fixed, index) = table::fixed::find_index(header);
 
-    case table::fixed::type::header_value: {
-      encoded_size += prefix_int::encoded_size(index, 6);
+  switch (fixed) {
+    case table::fixed::type::header_value:
+      representation.line = type::static_value;
+      representation.index = index;
+      return representation;
+    case table::fixed::type::header_only:
+      representation.line = type::static_name;
+      representation.index = index;
+      break;
+    case table::fixed::type::missing:
       break;
+  }
+
+  if (stream_ == nullptr) {
+    return representation;
+  }
+
+  const table::dynamic &table = stream_->table_;
+
+  // Entries that haven't been acknowledged yet can only be referenced if
+  // doing so doesn't exceed the peer's blocked streams limit.
+  bool blockable = stream_->blocking(id_) ||
+                   stream_->blocked_streams() <
+                     stream_->peer_.qpack_blocked_streams;
+
+  uint64_t value = UINT64_MAX;
+  uint64_t name = UINT64_MAX;
+  uint64_t referenceable = UINT64_MAX;
+
+  // Search from newest to oldest so we find the entries that stay in the
+  // table the longest.
+  for (uint64_t i = table.inserted(); i > table.dropped(); i--) {
+    uint64_t entry = i - 1;
+    header_view candidate = table.at(entry);
+
+    if (candidate.name() != header.name()) {
+      continue;
     }
 
-    case table::fixed::type::header_only: {
-      encoded_size += prefix_int::encoded_size(index, 4);
+    bool usable = entry < stream_->known_received_count_ || blockable;
 
-      size_t value_encoded_size = literal::encoded_size(header.value(), 7);
-      encoded_size += value_encoded_size;
-      break;
+    if (candidate.value() == header.value()) {
+      if (usable) {
+        representation.line = type::dynamic_value;
+        representation.index = entry;
+        return representation;
+      }
+
+      value = std::min(value, entry);
     }
 
-    case table::fixed::type::missing: {
-      size_t name_encoded_size = literal::encoded_size(header.name(), 3);
-      encoded_size += name_encoded_size;
+    name = name == UINT64_MAX ? entry : name;
 
-      size_t value_encoded_size = literal::encoded_size(header.value(), 7);
-      encoded_size += value_encoded_size;
-      break;
+    if (usable && referenceable == UINT64_MAX) {
+      referenceable = entry;
+    }
+  }
+
+  // First entry that survives inserting `header`.
+  uint64_t first = table.dropped();
+
+  if (value == UINT64_MAX && indexed(header, table.capacity())) {
+    uint64_t evicted = stream_->evict(table::dynamic::entry_size(header));
+
+    if (evicted != UINT64_MAX) {
+      first = evicted;
+
+      if (representation.line == type::static_name) {
+        representation.insert = type::static_name;
+        representation.insert_index = index;
+      } else if (name != UINT64_MAX && name >= first) {
+        representation.insert = type::dynamic_name;
+        representation.insert_index = name;
+      } else {
+        representation.insert = type::literal;
+      }
+
+      if (blockable) {
+        representation.line = type::dynamic_value;
+        representation.index = table.inserted();
+        return representation;
+      }
     }
+  }
 
-    default:
-      assert(false);
+  if (representation.line == type::literal &&
+      referenceable != UINT64_MAX && referenceable >= first) {
+    representation.line = type::dynamic_name;
+    representation.index = referenceable;
+  }
+
+  return representation;
+}
+
+uint64_t
+encoder::base() const noexcept
+{
+  // The base is determined by the first encoded header.
+  if (state_ == state::prefix && stream_ != nullptr) {
+    return stream_->table_.inserted();
+  }
+
+  return base_;
+}
+
+size_t
+encoder::encoded_size(const representation &representation,
+                      header_view header) const noexcept
+{
+  using type = representation::type;
+
+  uint64_t index = representation.index;
+  uint64_t base = this->base();
+
+  switch (representation.line) {
+
+    case type::static_value:
+      return prefix_int::encoded_size(index, 6);
+
+    case type::static_name:
+      return prefix_int::encoded_size(index, 4) +
+             literal::encoded_size(header.value(), 7);
+
+    case type::dynamic_value:
+      return index < base ? prefix_int::encoded_size(base - 1 - index, 6)
+                          : prefix_int::encoded_size(index - base, 4);
+
+    case type::dynamic_name:
+      return (index < base ? prefix_int::encoded_size(base - 1 - index, 4)
+                           : prefix_int::encoded_size(index - base, 3)) +
+             literal::encoded_size(header.value(), 7);
+
+    case type::literal:
+      return literal::encoded_size(header.name(), 3) +
+             literal::encoded_size(header.value(), 7);
+
+    case type::none:
+      break;
   }
 
+  assert(false);
+  return 0;
+}
+
+result<size_t>
+encoder::encoded_size(header_view header) const noexcept
+{
+  if (!header_is_lowercase(header)) {
+    BNL_LOG_E("Header ({}) is not lowercase", header);
+    return error::malformed_header;
+  }
+
+  size_t encoded_size = 0;
+
+  if (state_ == state::prefix && !deferred_) {
+    encoded_size += QPACK_PREFIX_ENCODED_SIZE;
+  }
+
+  encoded_size += this->encoded_size(find(header), header);
+
   return encoded_size;
 }
 
+void
+encoder::reference(const representation &representation, header_view header)
+{
+  using type = representation::type;
+
+  if (state_ == state::prefix) {
+    base_ = base();
+  }
+
+  if (representation.insert != type::none) {
+    stream_->insert(representation, header);
+  }
+
+  if (representation.line == type::dynamic_value ||
+      representation.line == type::dynamic_name) {
+    stream_->reference(id_, representation.index);
+    required_ = std::max(required_, representation.index + 1);
+  }
+}
+
 static constexpr uint8_t INDEXED_HEADER_FIELD_PREFIX = 0xc0;
 static constexpr uint8_t LITERAL_WITH_NAME_REFERENCE_PREFIX = 0x50;
 static constexpr uint8_t LITERAL_WITHOUT_NAME_REFERENCE_PREFIX = 0x20;
 static constexpr uint8_t LITERAL_NO_PREFIX = 0x00;
 
+static constexpr uint8_t INDEXED_DYNAMIC_HEADER_FIELD_PREFIX = 0x80;
+static constexpr uint8_t INDEXED_POST_BASE_HEADER_FIELD_PREFIX = 0x10;
+static constexpr uint8_t LITERAL_WITH_DYNAMIC_NAME_REFERENCE_PREFIX = 0x40;
+static constexpr uint8_t LITERAL_WITH_POST_BASE_NAME_REFERENCE_PREFIX = 0x00;
+
 result<size_t>
 encoder::encode(uint8_t *dest, header_view header) noexcept
 {
+  using type = representation::type;
+
   assert(dest != nullptr);
 
   uint8_t *begin = dest;
 
-  if (state_ == state::prefix) {
+  if (state_ == state::prefix && !deferred_) {
     std::fill(dest, dest + QPACK_PREFIX_ENCODED_SIZE, static_cast<uint8_t>(0U));
     dest += QPACK_PREFIX_ENCODED_SIZE;
-    state_ = state::header;
   }
 
-  table::fixed::type type;
-  uint8_t index = 0;
-  std::tie(type, index) = table::fixed::find_index(header);
+  representation representation = find(header);
+  reference(representation, header);
+  state_ = state::header;
 
-  switch (type) {
+  uint64_t index = representation.index;
 
-    case table::fixed::type::header_value:
+  switch (representation.line) {
+
+    case type::static_value:
       *dest = INDEXED_HEADER_FIELD_PREFIX;
       dest += prefix_int::encode(dest, index, 6);
       break;
 
-    case table::fixed::type::header_only:
+    case type::static_name:
       *dest = LITERAL_WITH_NAME_REFERENCE_PREFIX;
       dest += prefix_int::encode(dest, index, 4);
 
@@ -104,7 +288,30 @@ encoder::encode(uint8_t *dest, header_view header) noexcept
       dest += literal::encode(dest, header.value(), 7);
       break;
 
-    case table::fixed::type::missing:
+    case type::dynamic_value:
+      if (index < base_) {
+        *dest = INDEXED_DYNAMIC_HEADER_FIELD_PREFIX;
+        dest += prefix_int::encode(dest, base_ - 1 - index, 6);
+      } else {
+        *dest = INDEXED_POST_BASE_HEADER_FIELD_PREFIX;
+        dest += prefix_int::encode(dest, index - base_, 4);
+      }
+      break;
+
+    case type::dynamic_name:
+      if (index < base_) {
+        *dest = LITERAL_WITH_DYNAMIC_NAME_REFERENCE_PREFIX;
+        dest += prefix_int::encode(dest, base_ - 1 - index, 4);
+      } else {
+        *dest = LITERAL_WITH_POST_BASE_NAME_REFERENCE_PREFIX;
+        dest += prefix_int::encode(dest, index - base_, 3);
+      }
+
+      *dest = LITERAL_NO_PREFIX;
+      dest += literal::encode(dest, header.value(), 7);
+      break;
+
+    case type::literal:
       *dest = LITERAL_WITHOUT_NAME_REFERENCE_PREFIX;
       dest += literal::encode(dest, header.name(), 3);
 
@@ -112,7 +319,7 @@ encoder::encode(uint8_t *dest, header_view header) noexcept
       dest += literal::encode(dest, header.value(), 7);
       break;
 
-    default:
+    case type::none:
       assert(false);
   }
 
@@ -122,6 +329,141 @@ encoder::encode(uint8_t *dest, header_view header) noexcept
   return encoded_size;
 }
 
+result<size_t>
+encoder::encode(base::buffer_builder &encoded, header_view header)
+{
+  using type = representation::type;
+
+  if (!header_is_lowercase(header)) {
+    BNL_LOG_E("Header ({}) is not lowercase", header);
+    return error::malformed_header;
+  }
+
+  size_t begin = encoded.size();
+
+  if (state_ == state::prefix && !deferred_) {
+    uint8_t *dest = encoded.reserve(QPACK_PREFIX_ENCODED_SIZE);
+    std::fill(dest, dest + QPACK_PREFIX_ENCODED_SIZE, static_cast<uint8_t>(0U));
+    encoded.advance(QPACK_PREFIX_ENCODED_SIZE);
+  }
+
+  representation representation = find(header);
+  reference(representation, header);
+  state_ = state::header;
+
+  uint64_t index = representation.index;
+
+  // The prefix integer and literal encoders leave the leading bits of their
+  // first byte empty so we set the instruction prefix afterwards.
+  size_t instruction = encoded.size();
+
+  switch (representation.line) {
+
+    case type::static_value:
+      prefix_int::encode(encoded, index, 6);
+      encoded[instruction] |= INDEXED_HEADER_FIELD_PREFIX;
+      break;
+
+    case type::static_name:
+      prefix_int::encode(encoded, index, 4);
+      encoded[instruction] |= LITERAL_WITH_NAME_REFERENCE_PREFIX;
+
+      literal::encode(encoded, header.value(), 7);
+      break;
+
+    case type::dynamic_value:
+      if (index < base_) {
+        prefix_int::encode(encoded, base_ - 1 - index, 6);
+        encoded[instruction] |= INDEXED_DYNAMIC_HEADER_FIELD_PREFIX;
+      } else {
+        prefix_int::encode(encoded, index - base_, 4);
+        encoded[instruction] |= INDEXED_POST_BASE_HEADER_FIELD_PREFIX;
+      }
+      break;
+
+    case type::dynamic_name:
+      if (index < base_) {
+        prefix_int::encode(encoded, base_ - 1 - index, 4);
+        encoded[instruction] |= LITERAL_WITH_DYNAMIC_NAME_REFERENCE_PREFIX;
+      } else {
+        prefix_int::encode(encoded, index - base_, 3);
+        encoded[instruction] |= LITERAL_WITH_POST_BASE_NAME_REFERENCE_PREFIX;
+      }
+
+      literal::encode(encoded, header.value(), 7);
+      break;
+
+    case type::literal:
+      literal::encode(encoded, header.name(), 3);
+      encoded[instruction] |= LITERAL_WITHOUT_NAME_REFERENCE_PREFIX;
+
+      literal::encode(encoded, header.value(), 7);
+      break;
+
+    case type::none:
+      assert(false);
+  }
+
+  size_t encoded_size = encoded.size() - begin;
+  count_ += encoded_size;
+
+  return encoded_size;
+}
+
+void
+encoder::start(base::buffer_builder &encoded)
+{
+  if (state_ != state::prefix) {
+    return;
+  }
+
+  base_ = base();
+
+  if (!deferred_) {
+    uint8_t *dest = encoded.reserve(QPACK_PREFIX_ENCODED_SIZE);
+    std::fill(dest, dest + QPACK_PREFIX_ENCODED_SIZE, static_cast<uint8_t>(0U));
+    encoded.advance(QPACK_PREFIX_ENCODED_SIZE);
+  }
+
+  state_ = state::header;
+}
+
+result<size_t>
+encoder::encode(base::buffer_builder &encoded, const static_header &header)
+{
+  if (!header.lowercase()) {
+    BNL_LOG_E("Header ({}) is not lowercase", header.header());
+    return error::malformed_header;
+  }
+
+  size_t begin = encoded.size();
+
+  start(encoded);
+
+  size_t encoded_size = header.encoded_size();
+  encoded.advance(header.encode(encoded.reserve(encoded_size)));
+
+  encoded_size = encoded.size() - begin;
+  count_ += encoded_size;
+
+  return encoded_size;
+}
+
+size_t
+encoder::append(base::buffer_builder &encoded, base::buffer_view lines)
+{
+  size_t begin = encoded.size();
+
+  start(encoded);
+
+  encoded.append(lines);
+
+  size_t encoded_size = encoded.size() - begin;
+  count_ += encoded_size;
+
+  return encoded_size;
+}
+
 result<base::buffer>
 encoder::encode(header_view header)
 {
@@ -133,6 +475,75 @@ encoder::encode(header_view header)
   return encoded;
 }
 
+// Required Insert Count and Base as they are encoded in the header block
+// prefix.
+struct prefix {
+  uint64_t required;
+  bool sign;
+  uint64_t delta;
+};
+
+static prefix
+make_prefix(uint64_t required, uint64_t base, uint64_t max_capacity) noexcept
+{
+  if (required == 0) {
+    return { 0, false, 0 };
+  }
+
+  uint64_t max_entries = max_capacity / table::dynamic::ENTRY_OVERHEAD;
+  uint64_t encoded = required % (2 * max_entries) + 1;
+
+  if (base >= required) {
+    return { encoded, false, base - required };
+  }
+
+  return { encoded, true, required - base - 1 };
+}
+
+size_t
+encoder::prefix_encoded_size() const noexcept
+{
+  if (!deferred_) {
+    return 0;
+  }
+
+  uint64_t max_capacity =
+    stream_ != nullptr ? stream_->peer_.qpack_max_table_capacity : 0;
+  prefix prefix = make_prefix(required_, base_, max_capacity);
+
+  return prefix_int::encoded_size(prefix.required, 8) +
+         prefix_int::encoded_size(prefix.delta, 7);
+}
+
+static constexpr uint8_t DELTA_BASE_SIGN = 0x80;
+
+size_t
+encoder::fin(uint8_t *dest) noexcept
+{
+  assert(deferred_);
+
+  uint64_t max_capacity =
+    stream_ != nullptr ? stream_->peer_.qpack_max_table_capacity : 0;
+  prefix prefix = make_prefix(required_, base_, max_capacity);
+
+  uint8_t *begin = dest;
+
+  *dest = 0;
+  dest += prefix_int::encode(dest, prefix.required, 8);
+
+  *dest = prefix.sign ? DELTA_BASE_SIGN : 0;
+  dest += prefix_int::encode(dest, prefix.delta, 7);
+
+  if (stream_ != nullptr && required_ > 0) {
+    stream_->close(id_);
+  }
+
+  size_t encoded_size = static_cast<size_t>(dest - begin);
+  count_ += encoded_size;
+
+  return encoded_size;
+}
+
 }
 }
 }
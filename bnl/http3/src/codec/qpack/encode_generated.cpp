@@ -1,8 +1,7 @@
 #include <bnl/http3/header.hpp>
 
-#include <xxhash.h>
-
 #include <cstdint>
+#include <cstring>
 #include <utility>
 
 namespace bnl {
@@ -13,368 +12,1087 @@ namespace fixed {
 
 enum class type { header_value, header_only, missing };
 
+// Static table entries are found by switching on the size and the first
+// character of the name and the value. Candidates are compared in full so
+// headers that aren't in the static table never match.
 static std::pair<type, uint8_t>
 find_index(header_view header)
 {
-  uint64_t name_hash = XXH64(header.name().data(), header.name().size(), 0);
-  uint64_t value_hash;
-
-  switch (name_hash) {
-    case 16895098521482341206U: // :authority
-      return { type::header_only, uint8_t(0) };
-    case 11800921616074793521U: // :method
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 1969084168692057419U: // CONNECT
-          return { type::header_value, uint8_t(15) };
-        case 3416820684017772195U: // DELETE
-          return { type::header_value, uint8_t(16) };
-        case 3137017853320178759U: // GET
-          return { type::header_value, uint8_t(17) };
-        case 5077457392360958184U: // HEAD
-          return { type::header_value, uint8_t(18) };
-        case 13449464674369688059U: // OPTIONS
-          return { type::header_value, uint8_t(19) };
-        case 1393561109570896241U: // POST
-          return { type::header_value, uint8_t(20) };
-        case 8278045464579020327U: // PUT
-          return { type::header_value, uint8_t(21) };
-      }
-      return { type::header_only, uint8_t(15) };
-    case 1432527143127418564U: // :path
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 16761507700594825962U: // /
-          return { type::header_value, uint8_t(1) };
-      }
-      return { type::header_only, uint8_t(1) };
-    case 16734001141632695329U: // :scheme
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 13730016396111666430U: // http
-          return { type::header_value, uint8_t(22) };
-        case 10742537861312705840U: // https
-          return { type::header_value, uint8_t(23) };
-      }
-      return { type::header_only, uint8_t(22) };
-    case 11145724770861396798U: // :status
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 2891813017576360282U: // 103
-          return { type::header_value, uint8_t(24) };
-        case 2685111111418367100U: // 200
-          return { type::header_value, uint8_t(25) };
-        case 2860949800888200221U: // 304
-          return { type::header_value, uint8_t(26) };
-        case 5957985645556640011U: // 404
-          return { type::header_value, uint8_t(27) };
-        case 12373623763172808772U: // 503
-          return { type::header_value, uint8_t(28) };
-        case 6146904730557115430U: // 100
-          return { type::header_value, uint8_t(63) };
-        case 11759795502426644276U: // 204
-          return { type::header_value, uint8_t(64) };
-        case 17033585193496081404U: // 206
-          return { type::header_value, uint8_t(65) };
-        case 1337354901647857481U: // 302
-          return { type::header_value, uint8_t(66) };
-        case 11111781720710347155U: // 400
-          return { type::header_value, uint8_t(67) };
-        case 14993518005534636743U: // 403
-          return { type::header_value, uint8_t(68) };
-        case 1128097706726417269U: // 421
-          return { type::header_value, uint8_t(69) };
-        case 17924379407345689140U: // 425
-          return { type::header_value, uint8_t(70) };
-        case 12667669577372699657U: // 500
-          return { type::header_value, uint8_t(71) };
-      }
-      return { type::header_only, uint8_t(24) };
-    case 14776963886974432617U: // accept
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 285960807216420690U: // */*
-          return { type::header_value, uint8_t(29) };
-        case 6373961066247414572U: // application/dns-message
-          return { type::header_value, uint8_t(30) };
-      }
-      return { type::header_only, uint8_t(29) };
-    case 14455144075924042224U: // accept-encoding
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 9032900040511447184U: // gzip, deflate, br
-          return { type::header_value, uint8_t(31) };
-      }
-      return { type::header_only, uint8_t(31) };
-    case 12586352021634702904U: // accept-language
-      return { type::header_only, uint8_t(72) };
-    case 14590555536192441974U: // accept-ranges
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 3279652670845457604U: // bytes
-          return { type::header_value, uint8_t(32) };
-      }
-      return { type::header_only, uint8_t(32) };
-    case 5881923794129529227U: // access-control-allow-credentials
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 13702020392090633634U: // FALSE
-          return { type::header_value, uint8_t(73) };
-        case 13992295306875567947U: // TRUE
-          return { type::header_value, uint8_t(74) };
-      }
-      return { type::header_only, uint8_t(73) };
-    case 3800686319607884068U: // access-control-allow-headers
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 6792126209451122079U: // cache-control
-          return { type::header_value, uint8_t(33) };
-        case 3910122139284074053U: // content-type
-          return { type::header_value, uint8_t(34) };
-        case 765293966243412708U: // *
-          return { type::header_value, uint8_t(75) };
+  base::string_view name = header.name();
+  base::string_view value = header.value();
+
+  switch (name.size()) {
+    case 3:
+      switch (name[0]) {
+        case 'a':
+          if (std::memcmp(name.data(), "age", 3) == 0) {
+            switch (value.size()) {
+              case 1:
+                switch (value[0]) {
+                  case '0':
+                    if (std::memcmp(value.data(), "0", 1) == 0) {
+                      return { type::header_value, uint8_t(2) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(2) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(33) };
-    case 10756748986426057606U: // access-control-allow-methods
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 2774841317834080824U: // get
-          return { type::header_value, uint8_t(76) };
-        case 13368036589511723433U: // get, post, options
-          return { type::header_value, uint8_t(77) };
-        case 16398749137410613924U: // options
-          return { type::header_value, uint8_t(78) };
+      break;
+    case 4:
+      switch (name[0]) {
+        case 'd':
+          if (std::memcmp(name.data(), "date", 4) == 0) {
+            return { type::header_only, uint8_t(6) };
+          }
+          break;
+        case 'e':
+          if (std::memcmp(name.data(), "etag", 4) == 0) {
+            return { type::header_only, uint8_t(7) };
+          }
+          break;
+        case 'l':
+          if (std::memcmp(name.data(), "link", 4) == 0) {
+            return { type::header_only, uint8_t(11) };
+          }
+          break;
+        case 'v':
+          if (std::memcmp(name.data(), "vary", 4) == 0) {
+            switch (value.size()) {
+              case 6:
+                switch (value[0]) {
+                  case 'o':
+                    if (std::memcmp(value.data(), "origin", 6) == 0) {
+                      return { type::header_value, uint8_t(60) };
+                    }
+                    break;
+                }
+                break;
+              case 15:
+                switch (value[0]) {
+                  case 'a':
+                    if (std::memcmp(value.data(), "accept-encoding", 15) == 0) {
+                      return { type::header_value, uint8_t(59) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(59) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(76) };
-    case 9436417403599124064U: // access-control-allow-origin
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 765293966243412708U: // *
-          return { type::header_value, uint8_t(35) };
+      break;
+    case 5:
+      switch (name[0]) {
+        case ':':
+          if (std::memcmp(name.data(), ":path", 5) == 0) {
+            switch (value.size()) {
+              case 1:
+                switch (value[0]) {
+                  case '/':
+                    if (std::memcmp(value.data(), "/", 1) == 0) {
+                      return { type::header_value, uint8_t(1) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(1) };
+          }
+          break;
+        case 'r':
+          if (std::memcmp(name.data(), "range", 5) == 0) {
+            switch (value.size()) {
+              case 8:
+                switch (value[0]) {
+                  case 'b':
+                    if (std::memcmp(value.data(), "bytes=0-", 8) == 0) {
+                      return { type::header_value, uint8_t(55) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(55) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(35) };
-    case 6796384088407939286U: // access-control-expose-headers
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 17031230962583399322U: // content-length
-          return { type::header_value, uint8_t(79) };
+      break;
+    case 6:
+      switch (name[0]) {
+        case 'a':
+          if (std::memcmp(name.data(), "accept", 6) == 0) {
+            switch (value.size()) {
+              case 3:
+                switch (value[0]) {
+                  case '*':
+                    if (std::memcmp(value.data(), "*/*", 3) == 0) {
+                      return { type::header_value, uint8_t(29) };
+                    }
+                    break;
+                }
+                break;
+              case 23:
+                switch (value[0]) {
+                  case 'a':
+                    if (std::memcmp(value.data(),
+                                    "application/dns-message",
+                                    23) == 0) {
+                      return { type::header_value, uint8_t(30) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(29) };
+          }
+          break;
+        case 'c':
+          if (std::memcmp(name.data(), "cookie", 6) == 0) {
+            return { type::header_only, uint8_t(5) };
+          }
+          break;
+        case 'o':
+          if (std::memcmp(name.data(), "origin", 6) == 0) {
+            return { type::header_only, uint8_t(90) };
+          }
+          break;
+        case 's':
+          if (std::memcmp(name.data(), "server", 6) == 0) {
+            return { type::header_only, uint8_t(92) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(79) };
-    case 4242818872217734295U: // access-control-request-headers
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 3910122139284074053U: // content-type
-          return { type::header_value, uint8_t(80) };
+      break;
+    case 7:
+      switch (name[0]) {
+        case ':':
+          if (std::memcmp(name.data(), ":method", 7) == 0) {
+            switch (value.size()) {
+              case 3:
+                switch (value[0]) {
+                  case 'G':
+                    if (std::memcmp(value.data(), "GET", 3) == 0) {
+                      return { type::header_value, uint8_t(17) };
+                    }
+                    break;
+                  case 'P':
+                    if (std::memcmp(value.data(), "PUT", 3) == 0) {
+                      return { type::header_value, uint8_t(21) };
+                    }
+                    break;
+                }
+                break;
+              case 4:
+                switch (value[0]) {
+                  case 'H':
+                    if (std::memcmp(value.data(), "HEAD", 4) == 0) {
+                      return { type::header_value, uint8_t(18) };
+                    }
+                    break;
+                  case 'P':
+                    if (std::memcmp(value.data(), "POST", 4) == 0) {
+                      return { type::header_value, uint8_t(20) };
+                    }
+                    break;
+                }
+                break;
+              case 6:
+                switch (value[0]) {
+                  case 'D':
+                    if (std::memcmp(value.data(), "DELETE", 6) == 0) {
+                      return { type::header_value, uint8_t(16) };
+                    }
+                    break;
+                }
+                break;
+              case 7:
+                switch (value[0]) {
+                  case 'C':
+                    if (std::memcmp(value.data(), "CONNECT", 7) == 0) {
+                      return { type::header_value, uint8_t(15) };
+                    }
+                    break;
+                  case 'O':
+                    if (std::memcmp(value.data(), "OPTIONS", 7) == 0) {
+                      return { type::header_value, uint8_t(19) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(15) };
+          }
+          if (std::memcmp(name.data(), ":scheme", 7) == 0) {
+            switch (value.size()) {
+              case 4:
+                switch (value[0]) {
+                  case 'h':
+                    if (std::memcmp(value.data(), "http", 4) == 0) {
+                      return { type::header_value, uint8_t(22) };
+                    }
+                    break;
+                }
+                break;
+              case 5:
+                switch (value[0]) {
+                  case 'h':
+                    if (std::memcmp(value.data(), "https", 5) == 0) {
+                      return { type::header_value, uint8_t(23) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(22) };
+          }
+          if (std::memcmp(name.data(), ":status", 7) == 0) {
+            switch (value.size()) {
+              case 3:
+                switch (value[0]) {
+                  case '1':
+                    if (std::memcmp(value.data(), "100", 3) == 0) {
+                      return { type::header_value, uint8_t(63) };
+                    }
+                    if (std::memcmp(value.data(), "103", 3) == 0) {
+                      return { type::header_value, uint8_t(24) };
+                    }
+                    break;
+                  case '2':
+                    if (std::memcmp(value.data(), "200", 3) == 0) {
+                      return { type::header_value, uint8_t(25) };
+                    }
+                    if (std::memcmp(value.data(), "204", 3) == 0) {
+                      return { type::header_value, uint8_t(64) };
+                    }
+                    if (std::memcmp(value.data(), "206", 3) == 0) {
+                      return { type::header_value, uint8_t(65) };
+                    }
+                    break;
+                  case '3':
+                    if (std::memcmp(value.data(), "302", 3) == 0) {
+                      return { type::header_value, uint8_t(66) };
+                    }
+                    if (std::memcmp(value.data(), "304", 3) == 0) {
+                      return { type::header_value, uint8_t(26) };
+                    }
+                    break;
+                  case '4':
+                    if (std::memcmp(value.data(), "400", 3) == 0) {
+                      return { type::header_value, uint8_t(67) };
+                    }
+                    if (std::memcmp(value.data(), "403", 3) == 0) {
+                      return { type::header_value, uint8_t(68) };
+                    }
+                    if (std::memcmp(value.data(), "404", 3) == 0) {
+                      return { type::header_value, uint8_t(27) };
+                    }
+                    if (std::memcmp(value.data(), "421", 3) == 0) {
+                      return { type::header_value, uint8_t(69) };
+                    }
+                    if (std::memcmp(value.data(), "425", 3) == 0) {
+                      return { type::header_value, uint8_t(70) };
+                    }
+                    break;
+                  case '5':
+                    if (std::memcmp(value.data(), "500", 3) == 0) {
+                      return { type::header_value, uint8_t(71) };
+                    }
+                    if (std::memcmp(value.data(), "503", 3) == 0) {
+                      return { type::header_value, uint8_t(28) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(24) };
+          }
+          break;
+        case 'a':
+          if (std::memcmp(name.data(), "alt-svc", 7) == 0) {
+            switch (value.size()) {
+              case 5:
+                switch (value[0]) {
+                  case 'c':
+                    if (std::memcmp(value.data(), "clear", 5) == 0) {
+                      return { type::header_value, uint8_t(83) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(83) };
+          }
+          break;
+        case 'p':
+          if (std::memcmp(name.data(), "purpose", 7) == 0) {
+            switch (value.size()) {
+              case 8:
+                switch (value[0]) {
+                  case 'p':
+                    if (std::memcmp(value.data(), "prefetch", 8) == 0) {
+                      return { type::header_value, uint8_t(91) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(91) };
+          }
+          break;
+        case 'r':
+          if (std::memcmp(name.data(), "referer", 7) == 0) {
+            return { type::header_only, uint8_t(13) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(80) };
-    case 14051338931492133901U: // access-control-request-method
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 2774841317834080824U: // get
-          return { type::header_value, uint8_t(81) };
-        case 3178169103122520677U: // post
-          return { type::header_value, uint8_t(82) };
+      break;
+    case 8:
+      switch (name[0]) {
+        case 'i':
+          if (std::memcmp(name.data(), "if-range", 8) == 0) {
+            return { type::header_only, uint8_t(89) };
+          }
+          break;
+        case 'l':
+          if (std::memcmp(name.data(), "location", 8) == 0) {
+            return { type::header_only, uint8_t(12) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(81) };
-    case 5092756294692198100U: // age
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 7148434200721666028U: // 0
-          return { type::header_value, uint8_t(2) };
+      break;
+    case 9:
+      switch (name[0]) {
+        case 'e':
+          if (std::memcmp(name.data(), "expect-ct", 9) == 0) {
+            return { type::header_only, uint8_t(87) };
+          }
+          break;
+        case 'f':
+          if (std::memcmp(name.data(), "forwarded", 9) == 0) {
+            return { type::header_only, uint8_t(88) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(2) };
-    case 12092656254601729054U: // alt-svc
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 9623284816163994036U: // clear
-          return { type::header_value, uint8_t(83) };
+      break;
+    case 10:
+      switch (name[0]) {
+        case ':':
+          if (std::memcmp(name.data(), ":authority", 10) == 0) {
+            return { type::header_only, uint8_t(0) };
+          }
+          break;
+        case 'e':
+          if (std::memcmp(name.data(), "early-data", 10) == 0) {
+            switch (value.size()) {
+              case 1:
+                switch (value[0]) {
+                  case '1':
+                    if (std::memcmp(value.data(), "1", 1) == 0) {
+                      return { type::header_value, uint8_t(86) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(86) };
+          }
+          break;
+        case 's':
+          if (std::memcmp(name.data(), "set-cookie", 10) == 0) {
+            return { type::header_only, uint8_t(14) };
+          }
+          break;
+        case 'u':
+          if (std::memcmp(name.data(), "user-agent", 10) == 0) {
+            return { type::header_only, uint8_t(95) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(83) };
-    case 8846816503791876372U: // authorization
-      return { type::header_only, uint8_t(84) };
-    case 6792126209451122079U: // cache-control
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 10032073942971583664U: // max-age=0
-          return { type::header_value, uint8_t(36) };
-        case 3044507098168884424U: // max-age=2592000
-          return { type::header_value, uint8_t(37) };
-        case 441477139842840241U: // max-age=604800
-          return { type::header_value, uint8_t(38) };
-        case 8897988708233174624U: // no-cache
-          return { type::header_value, uint8_t(39) };
-        case 3660001317594812985U: // no-store
-          return { type::header_value, uint8_t(40) };
-        case 9509473917879564042U: // public, max-age=31536000
-          return { type::header_value, uint8_t(41) };
+      break;
+    case 12:
+      switch (name[0]) {
+        case 'c':
+          if (std::memcmp(name.data(), "content-type", 12) == 0) {
+            switch (value.size()) {
+              case 8:
+                switch (value[0]) {
+                  case 't':
+                    if (std::memcmp(value.data(), "text/css", 8) == 0) {
+                      return { type::header_value, uint8_t(51) };
+                    }
+                    break;
+                }
+                break;
+              case 9:
+                switch (value[0]) {
+                  case 'i':
+                    if (std::memcmp(value.data(), "image/gif", 9) == 0) {
+                      return { type::header_value, uint8_t(48) };
+                    }
+                    if (std::memcmp(value.data(), "image/png", 9) == 0) {
+                      return { type::header_value, uint8_t(50) };
+                    }
+                    break;
+                }
+                break;
+              case 10:
+                switch (value[0]) {
+                  case 'i':
+                    if (std::memcmp(value.data(), "image/jpeg", 10) == 0) {
+                      return { type::header_value, uint8_t(49) };
+                    }
+                    break;
+                  case 't':
+                    if (std::memcmp(value.data(), "text/plain", 10) == 0) {
+                      return { type::header_value, uint8_t(53) };
+                    }
+                    break;
+                }
+                break;
+              case 16:
+                switch (value[0]) {
+                  case 'a':
+                    if (std::memcmp(value.data(),
+                                    "application/json",
+                                    16) == 0) {
+                      return { type::header_value, uint8_t(46) };
+                    }
+                    break;
+                }
+                break;
+              case 22:
+                switch (value[0]) {
+                  case 'a':
+                    if (std::memcmp(value.data(),
+                                    "application/javascript",
+                                    22) == 0) {
+                      return { type::header_value, uint8_t(45) };
+                    }
+                    break;
+                }
+                break;
+              case 23:
+                switch (value[0]) {
+                  case 'a':
+                    if (std::memcmp(value.data(),
+                                    "application/dns-message",
+                                    23) == 0) {
+                      return { type::header_value, uint8_t(44) };
+                    }
+                    break;
+                }
+                break;
+              case 24:
+                switch (value[0]) {
+                  case 't':
+                    if (std::memcmp(value.data(),
+                                    "text/html; charset=utf-8",
+                                    24) == 0) {
+                      return { type::header_value, uint8_t(52) };
+                    }
+                    if (std::memcmp(value.data(),
+                                    "text/plain;charset=utf-8",
+                                    24) == 0) {
+                      return { type::header_value, uint8_t(54) };
+                    }
+                    break;
+                }
+                break;
+              case 33:
+                switch (value[0]) {
+                  case 'a':
+                    if (std::memcmp(value.data(),
+                                    "application/x-www-form-urlencoded",
+                                    33) == 0) {
+                      return { type::header_value, uint8_t(47) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(44) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(36) };
-    case 17156266451297603303U: // content-disposition
-      return { type::header_only, uint8_t(3) };
-    case 11860813331948357247U: // content-encoding
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 12202383188974104177U: // br
-          return { type::header_value, uint8_t(42) };
-        case 12621183860903199653U: // gzip
-          return { type::header_value, uint8_t(43) };
+      break;
+    case 13:
+      switch (name[0]) {
+        case 'a':
+          if (std::memcmp(name.data(), "accept-ranges", 13) == 0) {
+            switch (value.size()) {
+              case 5:
+                switch (value[0]) {
+                  case 'b':
+                    if (std::memcmp(value.data(), "bytes", 5) == 0) {
+                      return { type::header_value, uint8_t(32) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(32) };
+          }
+          if (std::memcmp(name.data(), "authorization", 13) == 0) {
+            return { type::header_only, uint8_t(84) };
+          }
+          break;
+        case 'c':
+          if (std::memcmp(name.data(), "cache-control", 13) == 0) {
+            switch (value.size()) {
+              case 8:
+                switch (value[0]) {
+                  case 'n':
+                    if (std::memcmp(value.data(), "no-cache", 8) == 0) {
+                      return { type::header_value, uint8_t(39) };
+                    }
+                    if (std::memcmp(value.data(), "no-store", 8) == 0) {
+                      return { type::header_value, uint8_t(40) };
+                    }
+                    break;
+                }
+                break;
+              case 9:
+                switch (value[0]) {
+                  case 'm':
+                    if (std::memcmp(value.data(), "max-age=0", 9) == 0) {
+                      return { type::header_value, uint8_t(36) };
+                    }
+                    break;
+                }
+                break;
+              case 14:
+                switch (value[0]) {
+                  case 'm':
+                    if (std::memcmp(value.data(), "max-age=604800", 14) == 0) {
+                      return { type::header_value, uint8_t(38) };
+                    }
+                    break;
+                }
+                break;
+              case 15:
+                switch (value[0]) {
+                  case 'm':
+                    if (std::memcmp(value.data(), "max-age=2592000", 15) == 0) {
+                      return { type::header_value, uint8_t(37) };
+                    }
+                    break;
+                }
+                break;
+              case 24:
+                switch (value[0]) {
+                  case 'p':
+                    if (std::memcmp(value.data(),
+                                    "public, max-age=31536000",
+                                    24) == 0) {
+                      return { type::header_value, uint8_t(41) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(36) };
+          }
+          break;
+        case 'i':
+          if (std::memcmp(name.data(), "if-none-match", 13) == 0) {
+            return { type::header_only, uint8_t(9) };
+          }
+          break;
+        case 'l':
+          if (std::memcmp(name.data(), "last-modified", 13) == 0) {
+            return { type::header_only, uint8_t(10) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(42) };
-    case 17031230962583399322U: // content-length
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 7148434200721666028U: // 0
-          return { type::header_value, uint8_t(4) };
+      break;
+    case 14:
+      switch (name[0]) {
+        case 'c':
+          if (std::memcmp(name.data(), "content-length", 14) == 0) {
+            switch (value.size()) {
+              case 1:
+                switch (value[0]) {
+                  case '0':
+                    if (std::memcmp(value.data(), "0", 1) == 0) {
+                      return { type::header_value, uint8_t(4) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(4) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(4) };
-    case 18043880115709070015U: // content-security-policy
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 165232284275397264U: // script-src 'none'; object-src 'none';
-                                  // base-uri 'none'
-          return { type::header_value, uint8_t(85) };
+      break;
+    case 15:
+      switch (name[0]) {
+        case 'a':
+          if (std::memcmp(name.data(), "accept-encoding", 15) == 0) {
+            switch (value.size()) {
+              case 17:
+                switch (value[0]) {
+                  case 'g':
+                    if (std::memcmp(value.data(),
+                                    "gzip, deflate, br",
+                                    17) == 0) {
+                      return { type::header_value, uint8_t(31) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(31) };
+          }
+          if (std::memcmp(name.data(), "accept-language", 15) == 0) {
+            return { type::header_only, uint8_t(72) };
+          }
+          break;
+        case 'x':
+          if (std::memcmp(name.data(), "x-forwarded-for", 15) == 0) {
+            return { type::header_only, uint8_t(96) };
+          }
+          if (std::memcmp(name.data(), "x-frame-options", 15) == 0) {
+            switch (value.size()) {
+              case 4:
+                switch (value[0]) {
+                  case 'd':
+                    if (std::memcmp(value.data(), "deny", 4) == 0) {
+                      return { type::header_value, uint8_t(97) };
+                    }
+                    break;
+                }
+                break;
+              case 10:
+                switch (value[0]) {
+                  case 's':
+                    if (std::memcmp(value.data(), "sameorigin", 10) == 0) {
+                      return { type::header_value, uint8_t(98) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(97) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(85) };
-    case 3910122139284074053U: // content-type
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 6373961066247414572U: // application/dns-message
-          return { type::header_value, uint8_t(44) };
-        case 9423039217905102597U: // application/javascript
-          return { type::header_value, uint8_t(45) };
-        case 116355269824119741U: // application/json
-          return { type::header_value, uint8_t(46) };
-        case 15711274223642436716U: // application/x-www-form-urlencoded
-          return { type::header_value, uint8_t(47) };
-        case 12727226202374957143U: // image/gif
-          return { type::header_value, uint8_t(48) };
-        case 12200045138720289141U: // image/jpeg
-          return { type::header_value, uint8_t(49) };
-        case 12092489581388341001U: // image/png
-          return { type::header_value, uint8_t(50) };
-        case 6791077934204364231U: // text/css
-          return { type::header_value, uint8_t(51) };
-        case 8886412932112875563U: // text/html; charset=utf-8
-          return { type::header_value, uint8_t(52) };
-        case 16588200704567877914U: // text/plain
-          return { type::header_value, uint8_t(53) };
-        case 9119350762400467667U: // text/plain;charset=utf-8
-          return { type::header_value, uint8_t(54) };
+      break;
+    case 16:
+      switch (name[0]) {
+        case 'c':
+          if (std::memcmp(name.data(), "content-encoding", 16) == 0) {
+            switch (value.size()) {
+              case 2:
+                switch (value[0]) {
+                  case 'b':
+                    if (std::memcmp(value.data(), "br", 2) == 0) {
+                      return { type::header_value, uint8_t(42) };
+                    }
+                    break;
+                }
+                break;
+              case 4:
+                switch (value[0]) {
+                  case 'g':
+                    if (std::memcmp(value.data(), "gzip", 4) == 0) {
+                      return { type::header_value, uint8_t(43) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(42) };
+          }
+          break;
+        case 'x':
+          if (std::memcmp(name.data(), "x-xss-protection", 16) == 0) {
+            switch (value.size()) {
+              case 13:
+                switch (value[0]) {
+                  case '1':
+                    if (std::memcmp(value.data(), "1; mode=block", 13) == 0) {
+                      return { type::header_value, uint8_t(62) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(62) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(44) };
-    case 905780767293800022U: // cookie
-      return { type::header_only, uint8_t(5) };
-    case 9202271988582577219U: // date
-      return { type::header_only, uint8_t(6) };
-    case 12326157660028381149U: // early-data
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 13237225503670494420U: // 1
-          return { type::header_value, uint8_t(86) };
+      break;
+    case 17:
+      switch (name[0]) {
+        case 'i':
+          if (std::memcmp(name.data(), "if-modified-since", 17) == 0) {
+            return { type::header_only, uint8_t(8) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(86) };
-    case 6439525432329186999U: // etag
-      return { type::header_only, uint8_t(7) };
-    case 9568944059520352163U: // expect-ct
-      return { type::header_only, uint8_t(87) };
-    case 5644212460638603090U: // forwarded
-      return { type::header_only, uint8_t(88) };
-    case 12678664253902784264U: // if-modified-since
-      return { type::header_only, uint8_t(8) };
-    case 8836338662272140136U: // if-none-match
-      return { type::header_only, uint8_t(9) };
-    case 10086758965902305572U: // if-range
-      return { type::header_only, uint8_t(89) };
-    case 5803729767262815818U: // last-modified
-      return { type::header_only, uint8_t(10) };
-    case 17841021884467483934U: // link
-      return { type::header_only, uint8_t(11) };
-    case 14592406158319853782U: // location
-      return { type::header_only, uint8_t(12) };
-    case 7034821444952201446U: // origin
-      return { type::header_only, uint8_t(90) };
-    case 4274379369960325767U: // purpose
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 15048569516378897441U: // prefetch
-          return { type::header_value, uint8_t(91) };
+      break;
+    case 19:
+      switch (name[0]) {
+        case 'c':
+          if (std::memcmp(name.data(), "content-disposition", 19) == 0) {
+            return { type::header_only, uint8_t(3) };
+          }
+          break;
+        case 't':
+          if (std::memcmp(name.data(), "timing-allow-origin", 19) == 0) {
+            switch (value.size()) {
+              case 1:
+                switch (value[0]) {
+                  case '*':
+                    if (std::memcmp(value.data(), "*", 1) == 0) {
+                      return { type::header_value, uint8_t(93) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(93) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(91) };
-    case 12715602975004390753U: // range
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 6181996873389341388U: // bytes=0-
-          return { type::header_value, uint8_t(55) };
+      break;
+    case 22:
+      switch (name[0]) {
+        case 'x':
+          if (std::memcmp(name.data(), "x-content-type-options", 22) == 0) {
+            switch (value.size()) {
+              case 7:
+                switch (value[0]) {
+                  case 'n':
+                    if (std::memcmp(value.data(), "nosniff", 7) == 0) {
+                      return { type::header_value, uint8_t(61) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(61) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(55) };
-    case 14154313121195327909U: // referer
-      return { type::header_only, uint8_t(13) };
-    case 16290507850670895904U: // server
-      return { type::header_only, uint8_t(92) };
-    case 666465872145128107U: // set-cookie
-      return { type::header_only, uint8_t(14) };
-    case 4179674550753269761U: // strict-transport-security
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 13034728143243030830U: // max-age=31536000
-          return { type::header_value, uint8_t(56) };
-        case 11632417432576482556U: // max-age=31536000; includesubdomains
-          return { type::header_value, uint8_t(57) };
-        case 16736049223785386895U: // max-age=31536000; includesubdomains;
-                                    // preload
-          return { type::header_value, uint8_t(58) };
+      break;
+    case 23:
+      switch (name[0]) {
+        case 'c':
+          if (std::memcmp(name.data(), "content-security-policy", 23) == 0) {
+            switch (value.size()) {
+              case 53:
+                switch (value[0]) {
+                  case 's':
+                    if (std::memcmp(value.data(),
+                                    "script-src 'none'; object-src 'none'; base-uri 'none'",
+                                    53) == 0) {
+                      return { type::header_value, uint8_t(85) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(85) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(56) };
-    case 5374862646944647126U: // timing-allow-origin
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 765293966243412708U: // *
-          return { type::header_value, uint8_t(93) };
+      break;
+    case 25:
+      switch (name[0]) {
+        case 's':
+          if (std::memcmp(name.data(), "strict-transport-security", 25) == 0) {
+            switch (value.size()) {
+              case 16:
+                switch (value[0]) {
+                  case 'm':
+                    if (std::memcmp(value.data(),
+                                    "max-age=31536000",
+                                    16) == 0) {
+                      return { type::header_value, uint8_t(56) };
+                    }
+                    break;
+                }
+                break;
+              case 35:
+                switch (value[0]) {
+                  case 'm':
+                    if (std::memcmp(value.data(),
+                                    "max-age=31536000; includesubdomains",
+                                    35) == 0) {
+                      return { type::header_value, uint8_t(57) };
+                    }
+                    break;
+                }
+                break;
+              case 44:
+                switch (value[0]) {
+                  case 'm':
+                    if (std::memcmp(value.data(),
+                                    "max-age=31536000; includesubdomains; preload",
+                                    44) == 0) {
+                      return { type::header_value, uint8_t(58) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(56) };
+          }
+          break;
+        case 'u':
+          if (std::memcmp(name.data(), "upgrade-insecure-requests", 25) == 0) {
+            switch (value.size()) {
+              case 1:
+                switch (value[0]) {
+                  case '1':
+                    if (std::memcmp(value.data(), "1", 1) == 0) {
+                      return { type::header_value, uint8_t(94) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(94) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(93) };
-    case 18069291607417813553U: // upgrade-insecure-requests
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 13237225503670494420U: // 1
-          return { type::header_value, uint8_t(94) };
+      break;
+    case 27:
+      switch (name[0]) {
+        case 'a':
+          if (std::memcmp(name.data(),
+                          "access-control-allow-origin",
+                          27) == 0) {
+            switch (value.size()) {
+              case 1:
+                switch (value[0]) {
+                  case '*':
+                    if (std::memcmp(value.data(), "*", 1) == 0) {
+                      return { type::header_value, uint8_t(35) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(35) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(94) };
-    case 16625730634708209664U: // user-agent
-      return { type::header_only, uint8_t(95) };
-    case 8816542506507529547U: // vary
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 14455144075924042224U: // accept-encoding
-          return { type::header_value, uint8_t(59) };
-        case 7034821444952201446U: // origin
-          return { type::header_value, uint8_t(60) };
+      break;
+    case 28:
+      switch (name[0]) {
+        case 'a':
+          if (std::memcmp(name.data(),
+                          "access-control-allow-headers",
+                          28) == 0) {
+            switch (value.size()) {
+              case 1:
+                switch (value[0]) {
+                  case '*':
+                    if (std::memcmp(value.data(), "*", 1) == 0) {
+                      return { type::header_value, uint8_t(75) };
+                    }
+                    break;
+                }
+                break;
+              case 12:
+                switch (value[0]) {
+                  case 'c':
+                    if (std::memcmp(value.data(), "content-type", 12) == 0) {
+                      return { type::header_value, uint8_t(34) };
+                    }
+                    break;
+                }
+                break;
+              case 13:
+                switch (value[0]) {
+                  case 'c':
+                    if (std::memcmp(value.data(), "cache-control", 13) == 0) {
+                      return { type::header_value, uint8_t(33) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(33) };
+          }
+          if (std::memcmp(name.data(),
+                          "access-control-allow-methods",
+                          28) == 0) {
+            switch (value.size()) {
+              case 3:
+                switch (value[0]) {
+                  case 'g':
+                    if (std::memcmp(value.data(), "get", 3) == 0) {
+                      return { type::header_value, uint8_t(76) };
+                    }
+                    break;
+                }
+                break;
+              case 7:
+                switch (value[0]) {
+                  case 'o':
+                    if (std::memcmp(value.data(), "options", 7) == 0) {
+                      return { type::header_value, uint8_t(78) };
+                    }
+                    break;
+                }
+                break;
+              case 18:
+                switch (value[0]) {
+                  case 'g':
+                    if (std::memcmp(value.data(),
+                                    "get, post, options",
+                                    18) == 0) {
+                      return { type::header_value, uint8_t(77) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(76) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(59) };
-    case 6196956168349306122U: // x-content-type-options
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 4306527442339074562U: // nosniff
-          return { type::header_value, uint8_t(61) };
+      break;
+    case 29:
+      switch (name[0]) {
+        case 'a':
+          if (std::memcmp(name.data(),
+                          "access-control-expose-headers",
+                          29) == 0) {
+            switch (value.size()) {
+              case 14:
+                switch (value[0]) {
+                  case 'c':
+                    if (std::memcmp(value.data(), "content-length", 14) == 0) {
+                      return { type::header_value, uint8_t(79) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(79) };
+          }
+          if (std::memcmp(name.data(),
+                          "access-control-request-method",
+                          29) == 0) {
+            switch (value.size()) {
+              case 3:
+                switch (value[0]) {
+                  case 'g':
+                    if (std::memcmp(value.data(), "get", 3) == 0) {
+                      return { type::header_value, uint8_t(81) };
+                    }
+                    break;
+                }
+                break;
+              case 4:
+                switch (value[0]) {
+                  case 'p':
+                    if (std::memcmp(value.data(), "post", 4) == 0) {
+                      return { type::header_value, uint8_t(82) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(81) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(61) };
-    case 1042837635865018085U: // x-forwarded-for
-      return { type::header_only, uint8_t(96) };
-    case 8598773544412918900U: // x-frame-options
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 6492545016868164575U: // deny
-          return { type::header_value, uint8_t(97) };
-        case 13303836962186157521U: // sameorigin
-          return { type::header_value, uint8_t(98) };
+      break;
+    case 30:
+      switch (name[0]) {
+        case 'a':
+          if (std::memcmp(name.data(),
+                          "access-control-request-headers",
+                          30) == 0) {
+            switch (value.size()) {
+              case 12:
+                switch (value[0]) {
+                  case 'c':
+                    if (std::memcmp(value.data(), "content-type", 12) == 0) {
+                      return { type::header_value, uint8_t(80) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(80) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(97) };
-    case 15732293358711069708U: // x-xss-protection
-      value_hash = XXH64(header.value().data(), header.value().size(), 0);
-      switch (value_hash) {
-        case 7412498726110841680U: // 1; mode=block
-          return { type::header_value, uint8_t(62) };
+      break;
+    case 32:
+      switch (name[0]) {
+        case 'a':
+          if (std::memcmp(name.data(),
+                          "access-control-allow-credentials",
+                          32) == 0) {
+            switch (value.size()) {
+              case 4:
+                switch (value[0]) {
+                  case 'T':
+                    if (std::memcmp(value.data(), "TRUE", 4) == 0) {
+                      return { type::header_value, uint8_t(74) };
+                    }
+                    break;
+                }
+                break;
+              case 5:
+                switch (value[0]) {
+                  case 'F':
+                    if (std::memcmp(value.data(), "FALSE", 5) == 0) {
+                      return { type::header_value, uint8_t(73) };
+                    }
+                    break;
+                }
+                break;
+            }
+
+            return { type::header_only, uint8_t(73) };
+          }
+          break;
       }
-      return { type::header_only, uint8_t(62) };
+      break;
   }
 
   return { type::missing, {} };
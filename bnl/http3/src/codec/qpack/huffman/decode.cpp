@@ -1,120 +1,192 @@
-/*
- * nghttp3
- *
- * Copyright (c) 2019 nghttp3 contributors
- * Copyright (c) 2013 nghttp2 contributors
- *
- * Permission is hereby granted, free of charge, to any person obtaining
- * a copy of this software and associated documentation files (the
- * "Software"), to deal in the Software without restriction, including
- * without limitation the rights to use, copy, modify, merge, publish,
- * distribute, sublicense, and/or sell copies of the Software, and to
- * permit persons to whom the Software is furnished to do so, subject to
- * the following conditions:
- *
- * The above copyright notice and this permission notice shall be
- * included in all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
- * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
- * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
- * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
- * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
- * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
- * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
- */
-
 #include <bnl/http3/codec/qpack/huffman.hpp>
 
-#include "decode_generated.cpp"
+#include "lookup_generated.cpp"
+
+#include <algorithm>
+#include <cassert>
 
 namespace bnl {
 namespace http3 {
 namespace qpack {
 namespace huffman {
 
-template<typename Lookahead>
-result<size_t>
-decoded_size(const Lookahead &encoded, size_t encoded_size) noexcept
-{
-  if (encoded.size() < encoded_size) {
-    return error::incomplete;
+// Feeds `size` bytes of `encoded` into a 64-bit accumulator, one contiguous
+// span at a time. Bytes are consumed from `encoded` once their span has been
+// loaded into the accumulator.
+template<typename Sequence>
+class reader {
+public:
+  reader(Sequence &encoded, size_t size) noexcept
+    : encoded_(encoded)
+    , left_(size)
+  {}
+
+  // Loads bytes until more than 56 bits are buffered or the input is
+  // exhausted.
+  void refill() noexcept
+  {
+    while (count_ <= 56) {
+      if (byte_ == end_ && !next()) {
+        return;
+      }
+
+      bits_ = bits_ << 8U | *byte_++;
+      count_ += 8;
+    }
   }
 
-  size_t decoded_size = 0;
-  uint8_t state = 0;
-  bool accept = false;
-
-  for (size_t i = 0; i < encoded_size; i++) {
-    const decoding::node &first = decoding::table[state][encoded[i] >> 4U];
+  size_t count() const noexcept
+  {
+    return count_;
+  }
 
-    bool failed = (first.flags & decoding::flag::failed) != 0;
-    if (failed) {
-      return error::qpack_decompression_failed;
-    }
+  uint32_t peek(size_t size) const noexcept
+  {
+    assert(size <= count_ && size <= 32);
+    return static_cast<uint32_t>(bits_ >> (count_ - size)) &
+           static_cast<uint32_t>((uint64_t(1) << size) - 1);
+  }
 
-    if ((first.flags & decoding::flag::symbol) != 0) {
-      decoded_size++;
-    }
+  void skip(size_t size) noexcept
+  {
+    assert(size <= count_);
+    count_ -= size;
+  }
 
-    const decoding::node &second =
-      decoding::table[first.state][encoded[i] & 0xfU];
+private:
+  bool next() noexcept
+  {
+    encoded_.consume(static_cast<size_t>(end_ - begin_));
+    begin_ = end_ = byte_ = nullptr;
 
-    failed = (second.flags & decoding::flag::failed) != 0;
-    if (failed) {
-      return error::qpack_decompression_failed;
+    if (left_ == 0) {
+      return false;
     }
 
-    if ((second.flags & decoding::flag::symbol) != 0) {
-      decoded_size++;
-    }
+    base::buffer_view contiguous = encoded_.contiguous();
+    size_t size = std::min(contiguous.size(), left_);
+
+    begin_ = byte_ = contiguous.data();
+    end_ = begin_ + size;
+    left_ -= size;
 
-    state = second.state;
-    accept = (second.flags & decoding::flag::accepted) != 0;
+    return true;
   }
 
-  if (!accept) {
-    return error::qpack_decompression_failed;
+private:
+  Sequence &encoded_;
+  size_t left_;
+
+  const uint8_t *begin_ = nullptr;
+  const uint8_t *byte_ = nullptr;
+  const uint8_t *end_ = nullptr;
+
+  uint64_t bits_ = 0;
+  size_t count_ = 0;
+};
+
+// Decodes a single symbol using the canonical code tables. Returns false if
+// none of the codes that fit in the buffered bits match.
+template<typename Sequence>
+static bool
+decode_symbol(const reader<Sequence> &input,
+              uint16_t &symbol,
+              size_t &length) noexcept
+{
+  size_t max_length = std::min(input.count(), lookup::max_code_length);
+
+  for (length = lookup::min_code_length; length <= max_length; length++) {
+    const lookup::canonical &codes = lookup::codes[length];
+    uint32_t index = input.peek(length) - codes.first;
+
+    // Codes smaller than `first` wrap around and fail the check as well.
+    if (index < codes.count) {
+      symbol = lookup::symbols[codes.offset + index];
+      return true;
+    }
   }
 
-  return decoded_size;
+  return false;
+}
+
+size_t
+decoded_max_size(size_t encoded_size) noexcept
+{
+  // Every code is at least 5 bits long which bounds the decoded size. The
+  // extra byte allows always storing both symbols of a lookup table entry.
+  return encoded_size * 8 / lookup::min_code_length + 1;
 }
 
 template<typename Sequence>
 result<base::string>
 decode(Sequence &encoded, size_t encoded_size)
 {
-  size_t decoded_size = BNL_TRY(huffman::decoded_size(encoded, encoded_size));
   base::string decoded;
+  decoded.resize(decoded_max_size(encoded_size));
+
+  size_t decoded_size = BNL_TRY(decode(encoded, encoded_size, &decoded[0]));
   decoded.resize(decoded_size);
 
-  char *dest = &decoded[0];
-  uint8_t state = 0;
+  return decoded;
+}
+
+template<typename Sequence>
+result<size_t>
+decode(Sequence &encoded, size_t encoded_size, char *dest)
+{
+  if (encoded.size() < encoded_size) {
+    return error::incomplete;
+  }
+
+  char *begin = dest;
+  reader<Sequence> input(encoded, encoded_size);
+
+  while (true) {
+    input.refill();
+
+    if (input.count() >= lookup::bits) {
+      const lookup::entry &entry = lookup::table[input.peek(lookup::bits)];
 
-  for (size_t i = 0; i < encoded_size; ++i) {
-    const decoding::node &first = decoding::table[state][encoded[i] >> 4U];
+      if (entry.count != 0) {
+        dest[0] = static_cast<char>(entry.symbols[0]);
+        dest[1] = static_cast<char>(entry.symbols[1]);
+        dest += entry.count;
 
-    if ((first.flags & decoding::flag::symbol) != 0) {
-      *dest++ = static_cast<char>(first.symbol);
+        input.skip(entry.length);
+        continue;
+      }
     }
 
-    const decoding::node &second =
-      decoding::table[first.state][encoded[i] & 0xfU];
+    // Codes longer than `lookup::bits` and the last few bits of the input.
+    uint16_t symbol = 0;
+    size_t length = 0;
 
-    if ((second.flags & decoding::flag::symbol) != 0) {
-      *dest++ = static_cast<char>(second.symbol);
+    if (!decode_symbol(input, symbol, length)) {
+      break;
     }
 
-    state = second.state;
+    if (symbol == lookup::eos) {
+      return error::qpack_decompression_failed;
+    }
+
+    *dest++ = static_cast<char>(symbol);
+    input.skip(length);
   }
 
-  encoded.consume(encoded_size);
+  // The remaining bits are padding which has to be the most significant bits
+  // of EOS (all ones) and strictly shorter than 8 bits.
+  size_t padding = input.count();
+  if (padding > 7 || input.peek(padding) != (1U << padding) - 1) {
+    return error::qpack_decompression_failed;
+  }
 
-  return decoded;
+  return static_cast<size_t>(dest - begin);
 }
 
 BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_QPACK_HUFFMAN_DECODE_IMPL);
 BNL_BASE_LOOKAHEAD_IMPL(BNL_HTTP3_QPACK_HUFFMAN_DECODE_IMPL);
+BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_QPACK_HUFFMAN_DECODE_DEST_IMPL);
+BNL_BASE_LOOKAHEAD_IMPL(BNL_HTTP3_QPACK_HUFFMAN_DECODE_DEST_IMPL);
 
 }
 }
@@ -47,76 +47,78 @@ encoded_size(base::string_view string) noexcept
   return (num_bits + 7) / 8;
 }
 
-static size_t
-symbol_encode(uint8_t *dest, size_t *rem_bits, const encoding::symbol &symbol)
+// Stores `word` in big-endian byte order.
+static void
+store(uint8_t *dest, uint32_t word) noexcept
 {
-  uint8_t *begin = dest;
+  dest[0] = static_cast<uint8_t>(word >> 24U);
+  dest[1] = static_cast<uint8_t>(word >> 16U);
+  dest[2] = static_cast<uint8_t>(word >> 8U);
+  dest[3] = static_cast<uint8_t>(word);
+}
 
-  uint32_t code = symbol.code;
-  size_t num_bits = symbol.num_bits;
+size_t
+encode(uint8_t *dest, base::string_view string, size_t max_size) noexcept
+{
+  // Codes are appended to the least significant bits of `bits`. Whenever 32
+  // or more bits are buffered, the oldest 32 bits are written out as a single
+  // word. At most 31 bits stay buffered and codes are at most 30 bits long so
+  // `bits` never overflows.
+  uint64_t bits = 0;
+  size_t count = 0;
+  size_t size = 0;
 
-  if (*rem_bits == 8) {
-    *dest = 0;
-  }
+  for (char character : string) {
+    uint8_t byte = static_cast<uint8_t>(character);
+    const encoding::symbol &symbol = encoding::table[byte];
 
-  if (num_bits <= *rem_bits) {
-    *dest = static_cast<uint8_t>(
-      *dest | static_cast<uint8_t>(code << (*rem_bits - num_bits)));
-    *rem_bits -= num_bits;
+    bits = bits << symbol.num_bits | symbol.code;
+    count += symbol.num_bits;
 
-  } else /* num_bits > *rem_bits */ {
-    *dest = static_cast<uint8_t>(
-      *dest | static_cast<uint8_t>(code >> (num_bits - *rem_bits)));
-    dest++;
-    num_bits -= *rem_bits;
+    if (count >= 32) {
+      if (max_size - size < 4) {
+        return SIZE_MAX;
+      }
 
-    if ((num_bits & 0x7U) != 0U) {
-      // Align code to MSB byte boundary.
-      code <<= 8 - (num_bits & 0x7U);
+      count -= 32;
+      store(dest + size, static_cast<uint32_t>(bits >> count));
+      size += 4;
     }
+  }
 
-    while (num_bits > 8) {
-      *dest = static_cast<uint8_t>(code >> (num_bits - (num_bits % 8)));
-
-      dest++;
-      num_bits -= 8;
-    }
+  // Pad to a byte boundary with the most significant bits of EOS (256) which
+  // are all ones.
+  size_t padding = (8 - count % 8) % 8;
+  bits = bits << padding | ((1U << padding) - 1);
+  count += padding;
 
-    *dest = static_cast<uint8_t>(code);
-    *rem_bits = 8 - num_bits;
+  if (max_size - size < count / 8) {
+    return SIZE_MAX;
   }
 
-  if (*rem_bits == 0) {
-    dest++;
-    *rem_bits = 8;
+  while (count > 0) {
+    count -= 8;
+    dest[size++] = static_cast<uint8_t>(bits >> count);
   }
 
-  return static_cast<size_t>(dest - begin);
+  return size;
 }
 
 size_t
 encode(uint8_t *dest, base::string_view string) noexcept
 {
-  uint8_t *begin = dest;
-  size_t rem_bits = 8;
+  return encode(dest, string, SIZE_MAX);
+}
 
-  for (char character : string) {
-    uint8_t byte = static_cast<uint8_t>(character);
-    const encoding::symbol &symbol = encoding::table[byte];
-    dest += symbol_encode(dest, &rem_bits, symbol);
-  }
+size_t
+encode(base::buffer_builder &encoded, base::string_view string)
+{
+  size_t encoded_size = huffman::encoded_size(string);
 
-  // 256 is special terminal symbol, pad with its prefix.
-  if (rem_bits < 8) {
-    // If rem_bits < 8, we should have at least 1 buffer space available.
-    const encoding::symbol &symbol = encoding::table[256];
-    *dest = static_cast<uint8_t>(
-      *dest |
-      static_cast<uint8_t>(symbol.code >> (symbol.num_bits - rem_bits)));
-    dest++;
-  }
+  encode(encoded.reserve(encoded_size), string);
+  encoded.advance(encoded_size);
 
-  return static_cast<size_t>(dest - begin);
+  return encoded_size;
 }
 
 base::buffer
@@ -0,0 +1,1444 @@
+#include <cstddef>
+#include <cstdint>
+
+namespace bnl {
+namespace http3 {
+namespace qpack {
+namespace huffman {
+namespace lookup {
+
+// Amount of bits used to index `table`.
+constexpr size_t bits = 12;
+
+constexpr size_t min_code_length = 5;
+constexpr size_t max_code_length = 30;
+
+constexpr uint16_t eos = 256;
+
+// Symbols of the codes that fit in the next `bits` bits of the input. `count`
+// is zero if the first code is longer than `bits` bits.
+struct entry {
+  uint8_t symbols[2];
+  uint8_t count;
+  // Amount of bits taken up by the decoded symbols.
+  uint8_t length;
+};
+
+const entry table[] = {
+  { { 48, 48 }, 2, 10 },   { { 48, 48 }, 2, 10 },   { { 48, 48 }, 2, 10 },
+  { { 48, 48 }, 2, 10 },   { { 48, 49 }, 2, 10 },   { { 48, 49 }, 2, 10 },
+  { { 48, 49 }, 2, 10 },   { { 48, 49 }, 2, 10 },   { { 48, 50 }, 2, 10 },
+  { { 48, 50 }, 2, 10 },   { { 48, 50 }, 2, 10 },   { { 48, 50 }, 2, 10 },
+  { { 48, 97 }, 2, 10 },   { { 48, 97 }, 2, 10 },   { { 48, 97 }, 2, 10 },
+  { { 48, 97 }, 2, 10 },   { { 48, 99 }, 2, 10 },   { { 48, 99 }, 2, 10 },
+  { { 48, 99 }, 2, 10 },   { { 48, 99 }, 2, 10 },   { { 48, 101 }, 2, 10 },
+  { { 48, 101 }, 2, 10 },  { { 48, 101 }, 2, 10 },  { { 48, 101 }, 2, 10 },
+  { { 48, 105 }, 2, 10 },  { { 48, 105 }, 2, 10 },  { { 48, 105 }, 2, 10 },
+  { { 48, 105 }, 2, 10 },  { { 48, 111 }, 2, 10 },  { { 48, 111 }, 2, 10 },
+  { { 48, 111 }, 2, 10 },  { { 48, 111 }, 2, 10 },  { { 48, 115 }, 2, 10 },
+  { { 48, 115 }, 2, 10 },  { { 48, 115 }, 2, 10 },  { { 48, 115 }, 2, 10 },
+  { { 48, 116 }, 2, 10 },  { { 48, 116 }, 2, 10 },  { { 48, 116 }, 2, 10 },
+  { { 48, 116 }, 2, 10 },  { { 48, 32 }, 2, 11 },   { { 48, 32 }, 2, 11 },
+  { { 48, 37 }, 2, 11 },   { { 48, 37 }, 2, 11 },   { { 48, 45 }, 2, 11 },
+  { { 48, 45 }, 2, 11 },   { { 48, 46 }, 2, 11 },   { { 48, 46 }, 2, 11 },
+  { { 48, 47 }, 2, 11 },   { { 48, 47 }, 2, 11 },   { { 48, 51 }, 2, 11 },
+  { { 48, 51 }, 2, 11 },   { { 48, 52 }, 2, 11 },   { { 48, 52 }, 2, 11 },
+  { { 48, 53 }, 2, 11 },   { { 48, 53 }, 2, 11 },   { { 48, 54 }, 2, 11 },
+  { { 48, 54 }, 2, 11 },   { { 48, 55 }, 2, 11 },   { { 48, 55 }, 2, 11 },
+  { { 48, 56 }, 2, 11 },   { { 48, 56 }, 2, 11 },   { { 48, 57 }, 2, 11 },
+  { { 48, 57 }, 2, 11 },   { { 48, 61 }, 2, 11 },   { { 48, 61 }, 2, 11 },
+  { { 48, 65 }, 2, 11 },   { { 48, 65 }, 2, 11 },   { { 48, 95 }, 2, 11 },
+  { { 48, 95 }, 2, 11 },   { { 48, 98 }, 2, 11 },   { { 48, 98 }, 2, 11 },
+  { { 48, 100 }, 2, 11 },  { { 48, 100 }, 2, 11 },  { { 48, 102 }, 2, 11 },
+  { { 48, 102 }, 2, 11 },  { { 48, 103 }, 2, 11 },  { { 48, 103 }, 2, 11 },
+  { { 48, 104 }, 2, 11 },  { { 48, 104 }, 2, 11 },  { { 48, 108 }, 2, 11 },
+  { { 48, 108 }, 2, 11 },  { { 48, 109 }, 2, 11 },  { { 48, 109 }, 2, 11 },
+  { { 48, 110 }, 2, 11 },  { { 48, 110 }, 2, 11 },  { { 48, 112 }, 2, 11 },
+  { { 48, 112 }, 2, 11 },  { { 48, 114 }, 2, 11 },  { { 48, 114 }, 2, 11 },
+  { { 48, 117 }, 2, 11 },  { { 48, 117 }, 2, 11 },  { { 48, 58 }, 2, 12 },
+  { { 48, 66 }, 2, 12 },   { { 48, 67 }, 2, 12 },   { { 48, 68 }, 2, 12 },
+  { { 48, 69 }, 2, 12 },   { { 48, 70 }, 2, 12 },   { { 48, 71 }, 2, 12 },
+  { { 48, 72 }, 2, 12 },   { { 48, 73 }, 2, 12 },   { { 48, 74 }, 2, 12 },
+  { { 48, 75 }, 2, 12 },   { { 48, 76 }, 2, 12 },   { { 48, 77 }, 2, 12 },
+  { { 48, 78 }, 2, 12 },   { { 48, 79 }, 2, 12 },   { { 48, 80 }, 2, 12 },
+  { { 48, 81 }, 2, 12 },   { { 48, 82 }, 2, 12 },   { { 48, 83 }, 2, 12 },
+  { { 48, 84 }, 2, 12 },   { { 48, 85 }, 2, 12 },   { { 48, 86 }, 2, 12 },
+  { { 48, 87 }, 2, 12 },   { { 48, 89 }, 2, 12 },   { { 48, 106 }, 2, 12 },
+  { { 48, 107 }, 2, 12 },  { { 48, 113 }, 2, 12 },  { { 48, 118 }, 2, 12 },
+  { { 48, 119 }, 2, 12 },  { { 48, 120 }, 2, 12 },  { { 48, 121 }, 2, 12 },
+  { { 48, 122 }, 2, 12 },  { { 48, 0 }, 1, 5 },     { { 48, 0 }, 1, 5 },
+  { { 48, 0 }, 1, 5 },     { { 48, 0 }, 1, 5 },     { { 49, 48 }, 2, 10 },
+  { { 49, 48 }, 2, 10 },   { { 49, 48 }, 2, 10 },   { { 49, 48 }, 2, 10 },
+  { { 49, 49 }, 2, 10 },   { { 49, 49 }, 2, 10 },   { { 49, 49 }, 2, 10 },
+  { { 49, 49 }, 2, 10 },   { { 49, 50 }, 2, 10 },   { { 49, 50 }, 2, 10 },
+  { { 49, 50 }, 2, 10 },   { { 49, 50 }, 2, 10 },   { { 49, 97 }, 2, 10 },
+  { { 49, 97 }, 2, 10 },   { { 49, 97 }, 2, 10 },   { { 49, 97 }, 2, 10 },
+  { { 49, 99 }, 2, 10 },   { { 49, 99 }, 2, 10 },   { { 49, 99 }, 2, 10 },
+  { { 49, 99 }, 2, 10 },   { { 49, 101 }, 2, 10 },  { { 49, 101 }, 2, 10 },
+  { { 49, 101 }, 2, 10 },  { { 49, 101 }, 2, 10 },  { { 49, 105 }, 2, 10 },
+  { { 49, 105 }, 2, 10 },  { { 49, 105 }, 2, 10 },  { { 49, 105 }, 2, 10 },
+  { { 49, 111 }, 2, 10 },  { { 49, 111 }, 2, 10 },  { { 49, 111 }, 2, 10 },
+  { { 49, 111 }, 2, 10 },  { { 49, 115 }, 2, 10 },  { { 49, 115 }, 2, 10 },
+  { { 49, 115 }, 2, 10 },  { { 49, 115 }, 2, 10 },  { { 49, 116 }, 2, 10 },
+  { { 49, 116 }, 2, 10 },  { { 49, 116 }, 2, 10 },  { { 49, 116 }, 2, 10 },
+  { { 49, 32 }, 2, 11 },   { { 49, 32 }, 2, 11 },   { { 49, 37 }, 2, 11 },
+  { { 49, 37 }, 2, 11 },   { { 49, 45 }, 2, 11 },   { { 49, 45 }, 2, 11 },
+  { { 49, 46 }, 2, 11 },   { { 49, 46 }, 2, 11 },   { { 49, 47 }, 2, 11 },
+  { { 49, 47 }, 2, 11 },   { { 49, 51 }, 2, 11 },   { { 49, 51 }, 2, 11 },
+  { { 49, 52 }, 2, 11 },   { { 49, 52 }, 2, 11 },   { { 49, 53 }, 2, 11 },
+  { { 49, 53 }, 2, 11 },   { { 49, 54 }, 2, 11 },   { { 49, 54 }, 2, 11 },
+  { { 49, 55 }, 2, 11 },   { { 49, 55 }, 2, 11 },   { { 49, 56 }, 2, 11 },
+  { { 49, 56 }, 2, 11 },   { { 49, 57 }, 2, 11 },   { { 49, 57 }, 2, 11 },
+  { { 49, 61 }, 2, 11 },   { { 49, 61 }, 2, 11 },   { { 49, 65 }, 2, 11 },
+  { { 49, 65 }, 2, 11 },   { { 49, 95 }, 2, 11 },   { { 49, 95 }, 2, 11 },
+  { { 49, 98 }, 2, 11 },   { { 49, 98 }, 2, 11 },   { { 49, 100 }, 2, 11 },
+  { { 49, 100 }, 2, 11 },  { { 49, 102 }, 2, 11 },  { { 49, 102 }, 2, 11 },
+  { { 49, 103 }, 2, 11 },  { { 49, 103 }, 2, 11 },  { { 49, 104 }, 2, 11 },
+  { { 49, 104 }, 2, 11 },  { { 49, 108 }, 2, 11 },  { { 49, 108 }, 2, 11 },
+  { { 49, 109 }, 2, 11 },  { { 49, 109 }, 2, 11 },  { { 49, 110 }, 2, 11 },
+  { { 49, 110 }, 2, 11 },  { { 49, 112 }, 2, 11 },  { { 49, 112 }, 2, 11 },
+  { { 49, 114 }, 2, 11 },  { { 49, 114 }, 2, 11 },  { { 49, 117 }, 2, 11 },
+  { { 49, 117 }, 2, 11 },  { { 49, 58 }, 2, 12 },   { { 49, 66 }, 2, 12 },
+  { { 49, 67 }, 2, 12 },   { { 49, 68 }, 2, 12 },   { { 49, 69 }, 2, 12 },
+  { { 49, 70 }, 2, 12 },   { { 49, 71 }, 2, 12 },   { { 49, 72 }, 2, 12 },
+  { { 49, 73 }, 2, 12 },   { { 49, 74 }, 2, 12 },   { { 49, 75 }, 2, 12 },
+  { { 49, 76 }, 2, 12 },   { { 49, 77 }, 2, 12 },   { { 49, 78 }, 2, 12 },
+  { { 49, 79 }, 2, 12 },   { { 49, 80 }, 2, 12 },   { { 49, 81 }, 2, 12 },
+  { { 49, 82 }, 2, 12 },   { { 49, 83 }, 2, 12 },   { { 49, 84 }, 2, 12 },
+  { { 49, 85 }, 2, 12 },   { { 49, 86 }, 2, 12 },   { { 49, 87 }, 2, 12 },
+  { { 49, 89 }, 2, 12 },   { { 49, 106 }, 2, 12 },  { { 49, 107 }, 2, 12 },
+  { { 49, 113 }, 2, 12 },  { { 49, 118 }, 2, 12 },  { { 49, 119 }, 2, 12 },
+  { { 49, 120 }, 2, 12 },  { { 49, 121 }, 2, 12 },  { { 49, 122 }, 2, 12 },
+  { { 49, 0 }, 1, 5 },     { { 49, 0 }, 1, 5 },     { { 49, 0 }, 1, 5 },
+  { { 49, 0 }, 1, 5 },     { { 50, 48 }, 2, 10 },   { { 50, 48 }, 2, 10 },
+  { { 50, 48 }, 2, 10 },   { { 50, 48 }, 2, 10 },   { { 50, 49 }, 2, 10 },
+  { { 50, 49 }, 2, 10 },   { { 50, 49 }, 2, 10 },   { { 50, 49 }, 2, 10 },
+  { { 50, 50 }, 2, 10 },   { { 50, 50 }, 2, 10 },   { { 50, 50 }, 2, 10 },
+  { { 50, 50 }, 2, 10 },   { { 50, 97 }, 2, 10 },   { { 50, 97 }, 2, 10 },
+  { { 50, 97 }, 2, 10 },   { { 50, 97 }, 2, 10 },   { { 50, 99 }, 2, 10 },
+  { { 50, 99 }, 2, 10 },   { { 50, 99 }, 2, 10 },   { { 50, 99 }, 2, 10 },
+  { { 50, 101 }, 2, 10 },  { { 50, 101 }, 2, 10 },  { { 50, 101 }, 2, 10 },
+  { { 50, 101 }, 2, 10 },  { { 50, 105 }, 2, 10 },  { { 50, 105 }, 2, 10 },
+  { { 50, 105 }, 2, 10 },  { { 50, 105 }, 2, 10 },  { { 50, 111 }, 2, 10 },
+  { { 50, 111 }, 2, 10 },  { { 50, 111 }, 2, 10 },  { { 50, 111 }, 2, 10 },
+  { { 50, 115 }, 2, 10 },  { { 50, 115 }, 2, 10 },  { { 50, 115 }, 2, 10 },
+  { { 50, 115 }, 2, 10 },  { { 50, 116 }, 2, 10 },  { { 50, 116 }, 2, 10 },
+  { { 50, 116 }, 2, 10 },  { { 50, 116 }, 2, 10 },  { { 50, 32 }, 2, 11 },
+  { { 50, 32 }, 2, 11 },   { { 50, 37 }, 2, 11 },   { { 50, 37 }, 2, 11 },
+  { { 50, 45 }, 2, 11 },   { { 50, 45 }, 2, 11 },   { { 50, 46 }, 2, 11 },
+  { { 50, 46 }, 2, 11 },   { { 50, 47 }, 2, 11 },   { { 50, 47 }, 2, 11 },
+  { { 50, 51 }, 2, 11 },   { { 50, 51 }, 2, 11 },   { { 50, 52 }, 2, 11 },
+  { { 50, 52 }, 2, 11 },   { { 50, 53 }, 2, 11 },   { { 50, 53 }, 2, 11 },
+  { { 50, 54 }, 2, 11 },   { { 50, 54 }, 2, 11 },   { { 50, 55 }, 2, 11 },
+  { { 50, 55 }, 2, 11 },   { { 50, 56 }, 2, 11 },   { { 50, 56 }, 2, 11 },
+  { { 50, 57 }, 2, 11 },   { { 50, 57 }, 2, 11 },   { { 50, 61 }, 2, 11 },
+  { { 50, 61 }, 2, 11 },   { { 50, 65 }, 2, 11 },   { { 50, 65 }, 2, 11 },
+  { { 50, 95 }, 2, 11 },   { { 50, 95 }, 2, 11 },   { { 50, 98 }, 2, 11 },
+  { { 50, 98 }, 2, 11 },   { { 50, 100 }, 2, 11 },  { { 50, 100 }, 2, 11 },
+  { { 50, 102 }, 2, 11 },  { { 50, 102 }, 2, 11 },  { { 50, 103 }, 2, 11 },
+  { { 50, 103 }, 2, 11 },  { { 50, 104 }, 2, 11 },  { { 50, 104 }, 2, 11 },
+  { { 50, 108 }, 2, 11 },  { { 50, 108 }, 2, 11 },  { { 50, 109 }, 2, 11 },
+  { { 50, 109 }, 2, 11 },  { { 50, 110 }, 2, 11 },  { { 50, 110 }, 2, 11 },
+  { { 50, 112 }, 2, 11 },  { { 50, 112 }, 2, 11 },  { { 50, 114 }, 2, 11 },
+  { { 50, 114 }, 2, 11 },  { { 50, 117 }, 2, 11 },  { { 50, 117 }, 2, 11 },
+  { { 50, 58 }, 2, 12 },   { { 50, 66 }, 2, 12 },   { { 50, 67 }, 2, 12 },
+  { { 50, 68 }, 2, 12 },   { { 50, 69 }, 2, 12 },   { { 50, 70 }, 2, 12 },
+  { { 50, 71 }, 2, 12 },   { { 50, 72 }, 2, 12 },   { { 50, 73 }, 2, 12 },
+  { { 50, 74 }, 2, 12 },   { { 50, 75 }, 2, 12 },   { { 50, 76 }, 2, 12 },
+  { { 50, 77 }, 2, 12 },   { { 50, 78 }, 2, 12 },   { { 50, 79 }, 2, 12 },
+  { { 50, 80 }, 2, 12 },   { { 50, 81 }, 2, 12 },   { { 50, 82 }, 2, 12 },
+  { { 50, 83 }, 2, 12 },   { { 50, 84 }, 2, 12 },   { { 50, 85 }, 2, 12 },
+  { { 50, 86 }, 2, 12 },   { { 50, 87 }, 2, 12 },   { { 50, 89 }, 2, 12 },
+  { { 50, 106 }, 2, 12 },  { { 50, 107 }, 2, 12 },  { { 50, 113 }, 2, 12 },
+  { { 50, 118 }, 2, 12 },  { { 50, 119 }, 2, 12 },  { { 50, 120 }, 2, 12 },
+  { { 50, 121 }, 2, 12 },  { { 50, 122 }, 2, 12 },  { { 50, 0 }, 1, 5 },
+  { { 50, 0 }, 1, 5 },     { { 50, 0 }, 1, 5 },     { { 50, 0 }, 1, 5 },
+  { { 97, 48 }, 2, 10 },   { { 97, 48 }, 2, 10 },   { { 97, 48 }, 2, 10 },
+  { { 97, 48 }, 2, 10 },   { { 97, 49 }, 2, 10 },   { { 97, 49 }, 2, 10 },
+  { { 97, 49 }, 2, 10 },   { { 97, 49 }, 2, 10 },   { { 97, 50 }, 2, 10 },
+  { { 97, 50 }, 2, 10 },   { { 97, 50 }, 2, 10 },   { { 97, 50 }, 2, 10 },
+  { { 97, 97 }, 2, 10 },   { { 97, 97 }, 2, 10 },   { { 97, 97 }, 2, 10 },
+  { { 97, 97 }, 2, 10 },   { { 97, 99 }, 2, 10 },   { { 97, 99 }, 2, 10 },
+  { { 97, 99 }, 2, 10 },   { { 97, 99 }, 2, 10 },   { { 97, 101 }, 2, 10 },
+  { { 97, 101 }, 2, 10 },  { { 97, 101 }, 2, 10 },  { { 97, 101 }, 2, 10 },
+  { { 97, 105 }, 2, 10 },  { { 97, 105 }, 2, 10 },  { { 97, 105 }, 2, 10 },
+  { { 97, 105 }, 2, 10 },  { { 97, 111 }, 2, 10 },  { { 97, 111 }, 2, 10 },
+  { { 97, 111 }, 2, 10 },  { { 97, 111 }, 2, 10 },  { { 97, 115 }, 2, 10 },
+  { { 97, 115 }, 2, 10 },  { { 97, 115 }, 2, 10 },  { { 97, 115 }, 2, 10 },
+  { { 97, 116 }, 2, 10 },  { { 97, 116 }, 2, 10 },  { { 97, 116 }, 2, 10 },
+  { { 97, 116 }, 2, 10 },  { { 97, 32 }, 2, 11 },   { { 97, 32 }, 2, 11 },
+  { { 97, 37 }, 2, 11 },   { { 97, 37 }, 2, 11 },   { { 97, 45 }, 2, 11 },
+  { { 97, 45 }, 2, 11 },   { { 97, 46 }, 2, 11 },   { { 97, 46 }, 2, 11 },
+  { { 97, 47 }, 2, 11 },   { { 97, 47 }, 2, 11 },   { { 97, 51 }, 2, 11 },
+  { { 97, 51 }, 2, 11 },   { { 97, 52 }, 2, 11 },   { { 97, 52 }, 2, 11 },
+  { { 97, 53 }, 2, 11 },   { { 97, 53 }, 2, 11 },   { { 97, 54 }, 2, 11 },
+  { { 97, 54 }, 2, 11 },   { { 97, 55 }, 2, 11 },   { { 97, 55 }, 2, 11 },
+  { { 97, 56 }, 2, 11 },   { { 97, 56 }, 2, 11 },   { { 97, 57 }, 2, 11 },
+  { { 97, 57 }, 2, 11 },   { { 97, 61 }, 2, 11 },   { { 97, 61 }, 2, 11 },
+  { { 97, 65 }, 2, 11 },   { { 97, 65 }, 2, 11 },   { { 97, 95 }, 2, 11 },
+  { { 97, 95 }, 2, 11 },   { { 97, 98 }, 2, 11 },   { { 97, 98 }, 2, 11 },
+  { { 97, 100 }, 2, 11 },  { { 97, 100 }, 2, 11 },  { { 97, 102 }, 2, 11 },
+  { { 97, 102 }, 2, 11 },  { { 97, 103 }, 2, 11 },  { { 97, 103 }, 2, 11 },
+  { { 97, 104 }, 2, 11 },  { { 97, 104 }, 2, 11 },  { { 97, 108 }, 2, 11 },
+  { { 97, 108 }, 2, 11 },  { { 97, 109 }, 2, 11 },  { { 97, 109 }, 2, 11 },
+  { { 97, 110 }, 2, 11 },  { { 97, 110 }, 2, 11 },  { { 97, 112 }, 2, 11 },
+  { { 97, 112 }, 2, 11 },  { { 97, 114 }, 2, 11 },  { { 97, 114 }, 2, 11 },
+  { { 97, 117 }, 2, 11 },  { { 97, 117 }, 2, 11 },  { { 97, 58 }, 2, 12 },
+  { { 97, 66 }, 2, 12 },   { { 97, 67 }, 2, 12 },   { { 97, 68 }, 2, 12 },
+  { { 97, 69 }, 2, 12 },   { { 97, 70 }, 2, 12 },   { { 97, 71 }, 2, 12 },
+  { { 97, 72 }, 2, 12 },   { { 97, 73 }, 2, 12 },   { { 97, 74 }, 2, 12 },
+  { { 97, 75 }, 2, 12 },   { { 97, 76 }, 2, 12 },   { { 97, 77 }, 2, 12 },
+  { { 97, 78 }, 2, 12 },   { { 97, 79 }, 2, 12 },   { { 97, 80 }, 2, 12 },
+  { { 97, 81 }, 2, 12 },   { { 97, 82 }, 2, 12 },   { { 97, 83 }, 2, 12 },
+  { { 97, 84 }, 2, 12 },   { { 97, 85 }, 2, 12 },   { { 97, 86 }, 2, 12 },
+  { { 97, 87 }, 2, 12 },   { { 97, 89 }, 2, 12 },   { { 97, 106 }, 2, 12 },
+  { { 97, 107 }, 2, 12 },  { { 97, 113 }, 2, 12 },  { { 97, 118 }, 2, 12 },
+  { { 97, 119 }, 2, 12 },  { { 97, 120 }, 2, 12 },  { { 97, 121 }, 2, 12 },
+  { { 97, 122 }, 2, 12 },  { { 97, 0 }, 1, 5 },     { { 97, 0 }, 1, 5 },
+  { { 97, 0 }, 1, 5 },     { { 97, 0 }, 1, 5 },     { { 99, 48 }, 2, 10 },
+  { { 99, 48 }, 2, 10 },   { { 99, 48 }, 2, 10 },   { { 99, 48 }, 2, 10 },
+  { { 99, 49 }, 2, 10 },   { { 99, 49 }, 2, 10 },   { { 99, 49 }, 2, 10 },
+  { { 99, 49 }, 2, 10 },   { { 99, 50 }, 2, 10 },   { { 99, 50 }, 2, 10 },
+  { { 99, 50 }, 2, 10 },   { { 99, 50 }, 2, 10 },   { { 99, 97 }, 2, 10 },
+  { { 99, 97 }, 2, 10 },   { { 99, 97 }, 2, 10 },   { { 99, 97 }, 2, 10 },
+  { { 99, 99 }, 2, 10 },   { { 99, 99 }, 2, 10 },   { { 99, 99 }, 2, 10 },
+  { { 99, 99 }, 2, 10 },   { { 99, 101 }, 2, 10 },  { { 99, 101 }, 2, 10 },
+  { { 99, 101 }, 2, 10 },  { { 99, 101 }, 2, 10 },  { { 99, 105 }, 2, 10 },
+  { { 99, 105 }, 2, 10 },  { { 99, 105 }, 2, 10 },  { { 99, 105 }, 2, 10 },
+  { { 99, 111 }, 2, 10 },  { { 99, 111 }, 2, 10 },  { { 99, 111 }, 2, 10 },
+  { { 99, 111 }, 2, 10 },  { { 99, 115 }, 2, 10 },  { { 99, 115 }, 2, 10 },
+  { { 99, 115 }, 2, 10 },  { { 99, 115 }, 2, 10 },  { { 99, 116 }, 2, 10 },
+  { { 99, 116 }, 2, 10 },  { { 99, 116 }, 2, 10 },  { { 99, 116 }, 2, 10 },
+  { { 99, 32 }, 2, 11 },   { { 99, 32 }, 2, 11 },   { { 99, 37 }, 2, 11 },
+  { { 99, 37 }, 2, 11 },   { { 99, 45 }, 2, 11 },   { { 99, 45 }, 2, 11 },
+  { { 99, 46 }, 2, 11 },   { { 99, 46 }, 2, 11 },   { { 99, 47 }, 2, 11 },
+  { { 99, 47 }, 2, 11 },   { { 99, 51 }, 2, 11 },   { { 99, 51 }, 2, 11 },
+  { { 99, 52 }, 2, 11 },   { { 99, 52 }, 2, 11 },   { { 99, 53 }, 2, 11 },
+  { { 99, 53 }, 2, 11 },   { { 99, 54 }, 2, 11 },   { { 99, 54 }, 2, 11 },
+  { { 99, 55 }, 2, 11 },   { { 99, 55 }, 2, 11 },   { { 99, 56 }, 2, 11 },
+  { { 99, 56 }, 2, 11 },   { { 99, 57 }, 2, 11 },   { { 99, 57 }, 2, 11 },
+  { { 99, 61 }, 2, 11 },   { { 99, 61 }, 2, 11 },   { { 99, 65 }, 2, 11 },
+  { { 99, 65 }, 2, 11 },   { { 99, 95 }, 2, 11 },   { { 99, 95 }, 2, 11 },
+  { { 99, 98 }, 2, 11 },   { { 99, 98 }, 2, 11 },   { { 99, 100 }, 2, 11 },
+  { { 99, 100 }, 2, 11 },  { { 99, 102 }, 2, 11 },  { { 99, 102 }, 2, 11 },
+  { { 99, 103 }, 2, 11 },  { { 99, 103 }, 2, 11 },  { { 99, 104 }, 2, 11 },
+  { { 99, 104 }, 2, 11 },  { { 99, 108 }, 2, 11 },  { { 99, 108 }, 2, 11 },
+  { { 99, 109 }, 2, 11 },  { { 99, 109 }, 2, 11 },  { { 99, 110 }, 2, 11 },
+  { { 99, 110 }, 2, 11 },  { { 99, 112 }, 2, 11 },  { { 99, 112 }, 2, 11 },
+  { { 99, 114 }, 2, 11 },  { { 99, 114 }, 2, 11 },  { { 99, 117 }, 2, 11 },
+  { { 99, 117 }, 2, 11 },  { { 99, 58 }, 2, 12 },   { { 99, 66 }, 2, 12 },
+  { { 99, 67 }, 2, 12 },   { { 99, 68 }, 2, 12 },   { { 99, 69 }, 2, 12 },
+  { { 99, 70 }, 2, 12 },   { { 99, 71 }, 2, 12 },   { { 99, 72 }, 2, 12 },
+  { { 99, 73 }, 2, 12 },   { { 99, 74 }, 2, 12 },   { { 99, 75 }, 2, 12 },
+  { { 99, 76 }, 2, 12 },   { { 99, 77 }, 2, 12 },   { { 99, 78 }, 2, 12 },
+  { { 99, 79 }, 2, 12 },   { { 99, 80 }, 2, 12 },   { { 99, 81 }, 2, 12 },
+  { { 99, 82 }, 2, 12 },   { { 99, 83 }, 2, 12 },   { { 99, 84 }, 2, 12 },
+  { { 99, 85 }, 2, 12 },   { { 99, 86 }, 2, 12 },   { { 99, 87 }, 2, 12 },
+  { { 99, 89 }, 2, 12 },   { { 99, 106 }, 2, 12 },  { { 99, 107 }, 2, 12 },
+  { { 99, 113 }, 2, 12 },  { { 99, 118 }, 2, 12 },  { { 99, 119 }, 2, 12 },
+  { { 99, 120 }, 2, 12 },  { { 99, 121 }, 2, 12 },  { { 99, 122 }, 2, 12 },
+  { { 99, 0 }, 1, 5 },     { { 99, 0 }, 1, 5 },     { { 99, 0 }, 1, 5 },
+  { { 99, 0 }, 1, 5 },     { { 101, 48 }, 2, 10 },  { { 101, 48 }, 2, 10 },
+  { { 101, 48 }, 2, 10 },  { { 101, 48 }, 2, 10 },  { { 101, 49 }, 2, 10 },
+  { { 101, 49 }, 2, 10 },  { { 101, 49 }, 2, 10 },  { { 101, 49 }, 2, 10 },
+  { { 101, 50 }, 2, 10 },  { { 101, 50 }, 2, 10 },  { { 101, 50 }, 2, 10 },
+  { { 101, 50 }, 2, 10 },  { { 101, 97 }, 2, 10 },  { { 101, 97 }, 2, 10 },
+  { { 101, 97 }, 2, 10 },  { { 101, 97 }, 2, 10 },  { { 101, 99 }, 2, 10 },
+  { { 101, 99 }, 2, 10 },  { { 101, 99 }, 2, 10 },  { { 101, 99 }, 2, 10 },
+  { { 101, 101 }, 2, 10 }, { { 101, 101 }, 2, 10 }, { { 101, 101 }, 2, 10 },
+  { { 101, 101 }, 2, 10 }, { { 101, 105 }, 2, 10 }, { { 101, 105 }, 2, 10 },
+  { { 101, 105 }, 2, 10 }, { { 101, 105 }, 2, 10 }, { { 101, 111 }, 2, 10 },
+  { { 101, 111 }, 2, 10 }, { { 101, 111 }, 2, 10 }, { { 101, 111 }, 2, 10 },
+  { { 101, 115 }, 2, 10 }, { { 101, 115 }, 2, 10 }, { { 101, 115 }, 2, 10 },
+  { { 101, 115 }, 2, 10 }, { { 101, 116 }, 2, 10 }, { { 101, 116 }, 2, 10 },
+  { { 101, 116 }, 2, 10 }, { { 101, 116 }, 2, 10 }, { { 101, 32 }, 2, 11 },
+  { { 101, 32 }, 2, 11 },  { { 101, 37 }, 2, 11 },  { { 101, 37 }, 2, 11 },
+  { { 101, 45 }, 2, 11 },  { { 101, 45 }, 2, 11 },  { { 101, 46 }, 2, 11 },
+  { { 101, 46 }, 2, 11 },  { { 101, 47 }, 2, 11 },  { { 101, 47 }, 2, 11 },
+  { { 101, 51 }, 2, 11 },  { { 101, 51 }, 2, 11 },  { { 101, 52 }, 2, 11 },
+  { { 101, 52 }, 2, 11 },  { { 101, 53 }, 2, 11 },  { { 101, 53 }, 2, 11 },
+  { { 101, 54 }, 2, 11 },  { { 101, 54 }, 2, 11 },  { { 101, 55 }, 2, 11 },
+  { { 101, 55 }, 2, 11 },  { { 101, 56 }, 2, 11 },  { { 101, 56 }, 2, 11 },
+  { { 101, 57 }, 2, 11 },  { { 101, 57 }, 2, 11 },  { { 101, 61 }, 2, 11 },
+  { { 101, 61 }, 2, 11 },  { { 101, 65 }, 2, 11 },  { { 101, 65 }, 2, 11 },
+  { { 101, 95 }, 2, 11 },  { { 101, 95 }, 2, 11 },  { { 101, 98 }, 2, 11 },
+  { { 101, 98 }, 2, 11 },  { { 101, 100 }, 2, 11 }, { { 101, 100 }, 2, 11 },
+  { { 101, 102 }, 2, 11 }, { { 101, 102 }, 2, 11 }, { { 101, 103 }, 2, 11 },
+  { { 101, 103 }, 2, 11 }, { { 101, 104 }, 2, 11 }, { { 101, 104 }, 2, 11 },
+  { { 101, 108 }, 2, 11 }, { { 101, 108 }, 2, 11 }, { { 101, 109 }, 2, 11 },
+  { { 101, 109 }, 2, 11 }, { { 101, 110 }, 2, 11 }, { { 101, 110 }, 2, 11 },
+  { { 101, 112 }, 2, 11 }, { { 101, 112 }, 2, 11 }, { { 101, 114 }, 2, 11 },
+  { { 101, 114 }, 2, 11 }, { { 101, 117 }, 2, 11 }, { { 101, 117 }, 2, 11 },
+  { { 101, 58 }, 2, 12 },  { { 101, 66 }, 2, 12 },  { { 101, 67 }, 2, 12 },
+  { { 101, 68 }, 2, 12 },  { { 101, 69 }, 2, 12 },  { { 101, 70 }, 2, 12 },
+  { { 101, 71 }, 2, 12 },  { { 101, 72 }, 2, 12 },  { { 101, 73 }, 2, 12 },
+  { { 101, 74 }, 2, 12 },  { { 101, 75 }, 2, 12 },  { { 101, 76 }, 2, 12 },
+  { { 101, 77 }, 2, 12 },  { { 101, 78 }, 2, 12 },  { { 101, 79 }, 2, 12 },
+  { { 101, 80 }, 2, 12 },  { { 101, 81 }, 2, 12 },  { { 101, 82 }, 2, 12 },
+  { { 101, 83 }, 2, 12 },  { { 101, 84 }, 2, 12 },  { { 101, 85 }, 2, 12 },
+  { { 101, 86 }, 2, 12 },  { { 101, 87 }, 2, 12 },  { { 101, 89 }, 2, 12 },
+  { { 101, 106 }, 2, 12 }, { { 101, 107 }, 2, 12 }, { { 101, 113 }, 2, 12 },
+  { { 101, 118 }, 2, 12 }, { { 101, 119 }, 2, 12 }, { { 101, 120 }, 2, 12 },
+  { { 101, 121 }, 2, 12 }, { { 101, 122 }, 2, 12 }, { { 101, 0 }, 1, 5 },
+  { { 101, 0 }, 1, 5 },    { { 101, 0 }, 1, 5 },    { { 101, 0 }, 1, 5 },
+  { { 105, 48 }, 2, 10 },  { { 105, 48 }, 2, 10 },  { { 105, 48 }, 2, 10 },
+  { { 105, 48 }, 2, 10 },  { { 105, 49 }, 2, 10 },  { { 105, 49 }, 2, 10 },
+  { { 105, 49 }, 2, 10 },  { { 105, 49 }, 2, 10 },  { { 105, 50 }, 2, 10 },
+  { { 105, 50 }, 2, 10 },  { { 105, 50 }, 2, 10 },  { { 105, 50 }, 2, 10 },
+  { { 105, 97 }, 2, 10 },  { { 105, 97 }, 2, 10 },  { { 105, 97 }, 2, 10 },
+  { { 105, 97 }, 2, 10 },  { { 105, 99 }, 2, 10 },  { { 105, 99 }, 2, 10 },
+  { { 105, 99 }, 2, 10 },  { { 105, 99 }, 2, 10 },  { { 105, 101 }, 2, 10 },
+  { { 105, 101 }, 2, 10 }, { { 105, 101 }, 2, 10 }, { { 105, 101 }, 2, 10 },
+  { { 105, 105 }, 2, 10 }, { { 105, 105 }, 2, 10 }, { { 105, 105 }, 2, 10 },
+  { { 105, 105 }, 2, 10 }, { { 105, 111 }, 2, 10 }, { { 105, 111 }, 2, 10 },
+  { { 105, 111 }, 2, 10 }, { { 105, 111 }, 2, 10 }, { { 105, 115 }, 2, 10 },
+  { { 105, 115 }, 2, 10 }, { { 105, 115 }, 2, 10 }, { { 105, 115 }, 2, 10 },
+  { { 105, 116 }, 2, 10 }, { { 105, 116 }, 2, 10 }, { { 105, 116 }, 2, 10 },
+  { { 105, 116 }, 2, 10 }, { { 105, 32 }, 2, 11 },  { { 105, 32 }, 2, 11 },
+  { { 105, 37 }, 2, 11 },  { { 105, 37 }, 2, 11 },  { { 105, 45 }, 2, 11 },
+  { { 105, 45 }, 2, 11 },  { { 105, 46 }, 2, 11 },  { { 105, 46 }, 2, 11 },
+  { { 105, 47 }, 2, 11 },  { { 105, 47 }, 2, 11 },  { { 105, 51 }, 2, 11 },
+  { { 105, 51 }, 2, 11 },  { { 105, 52 }, 2, 11 },  { { 105, 52 }, 2, 11 },
+  { { 105, 53 }, 2, 11 },  { { 105, 53 }, 2, 11 },  { { 105, 54 }, 2, 11 },
+  { { 105, 54 }, 2, 11 },  { { 105, 55 }, 2, 11 },  { { 105, 55 }, 2, 11 },
+  { { 105, 56 }, 2, 11 },  { { 105, 56 }, 2, 11 },  { { 105, 57 }, 2, 11 },
+  { { 105, 57 }, 2, 11 },  { { 105, 61 }, 2, 11 },  { { 105, 61 }, 2, 11 },
+  { { 105, 65 }, 2, 11 },  { { 105, 65 }, 2, 11 },  { { 105, 95 }, 2, 11 },
+  { { 105, 95 }, 2, 11 },  { { 105, 98 }, 2, 11 },  { { 105, 98 }, 2, 11 },
+  { { 105, 100 }, 2, 11 }, { { 105, 100 }, 2, 11 }, { { 105, 102 }, 2, 11 },
+  { { 105, 102 }, 2, 11 }, { { 105, 103 }, 2, 11 }, { { 105, 103 }, 2, 11 },
+  { { 105, 104 }, 2, 11 }, { { 105, 104 }, 2, 11 }, { { 105, 108 }, 2, 11 },
+  { { 105, 108 }, 2, 11 }, { { 105, 109 }, 2, 11 }, { { 105, 109 }, 2, 11 },
+  { { 105, 110 }, 2, 11 }, { { 105, 110 }, 2, 11 }, { { 105, 112 }, 2, 11 },
+  { { 105, 112 }, 2, 11 }, { { 105, 114 }, 2, 11 }, { { 105, 114 }, 2, 11 },
+  { { 105, 117 }, 2, 11 }, { { 105, 117 }, 2, 11 }, { { 105, 58 }, 2, 12 },
+  { { 105, 66 }, 2, 12 },  { { 105, 67 }, 2, 12 },  { { 105, 68 }, 2, 12 },
+  { { 105, 69 }, 2, 12 },  { { 105, 70 }, 2, 12 },  { { 105, 71 }, 2, 12 },
+  { { 105, 72 }, 2, 12 },  { { 105, 73 }, 2, 12 },  { { 105, 74 }, 2, 12 },
+  { { 105, 75 }, 2, 12 },  { { 105, 76 }, 2, 12 },  { { 105, 77 }, 2, 12 },
+  { { 105, 78 }, 2, 12 },  { { 105, 79 }, 2, 12 },  { { 105, 80 }, 2, 12 },
+  { { 105, 81 }, 2, 12 },  { { 105, 82 }, 2, 12 },  { { 105, 83 }, 2, 12 },
+  { { 105, 84 }, 2, 12 },  { { 105, 85 }, 2, 12 },  { { 105, 86 }, 2, 12 },
+  { { 105, 87 }, 2, 12 },  { { 105, 89 }, 2, 12 },  { { 105, 106 }, 2, 12 },
+  { { 105, 107 }, 2, 12 }, { { 105, 113 }, 2, 12 }, { { 105, 118 }, 2, 12 },
+  { { 105, 119 }, 2, 12 }, { { 105, 120 }, 2, 12 }, { { 105, 121 }, 2, 12 },
+  { { 105, 122 }, 2, 12 }, { { 105, 0 }, 1, 5 },    { { 105, 0 }, 1, 5 },
+  { { 105, 0 }, 1, 5 },    { { 105, 0 }, 1, 5 },    { { 111, 48 }, 2, 10 },
+  { { 111, 48 }, 2, 10 },  { { 111, 48 }, 2, 10 },  { { 111, 48 }, 2, 10 },
+  { { 111, 49 }, 2, 10 },  { { 111, 49 }, 2, 10 },  { { 111, 49 }, 2, 10 },
+  { { 111, 49 }, 2, 10 },  { { 111, 50 }, 2, 10 },  { { 111, 50 }, 2, 10 },
+  { { 111, 50 }, 2, 10 },  { { 111, 50 }, 2, 10 },  { { 111, 97 }, 2, 10 },
+  { { 111, 97 }, 2, 10 },  { { 111, 97 }, 2, 10 },  { { 111, 97 }, 2, 10 },
+  { { 111, 99 }, 2, 10 },  { { 111, 99 }, 2, 10 },  { { 111, 99 }, 2, 10 },
+  { { 111, 99 }, 2, 10 },  { { 111, 101 }, 2, 10 }, { { 111, 101 }, 2, 10 },
+  { { 111, 101 }, 2, 10 }, { { 111, 101 }, 2, 10 }, { { 111, 105 }, 2, 10 },
+  { { 111, 105 }, 2, 10 }, { { 111, 105 }, 2, 10 }, { { 111, 105 }, 2, 10 },
+  { { 111, 111 }, 2, 10 }, { { 111, 111 }, 2, 10 }, { { 111, 111 }, 2, 10 },
+  { { 111, 111 }, 2, 10 }, { { 111, 115 }, 2, 10 }, { { 111, 115 }, 2, 10 },
+  { { 111, 115 }, 2, 10 }, { { 111, 115 }, 2, 10 }, { { 111, 116 }, 2, 10 },
+  { { 111, 116 }, 2, 10 }, { { 111, 116 }, 2, 10 }, { { 111, 116 }, 2, 10 },
+  { { 111, 32 }, 2, 11 },  { { 111, 32 }, 2, 11 },  { { 111, 37 }, 2, 11 },
+  { { 111, 37 }, 2, 11 },  { { 111, 45 }, 2, 11 },  { { 111, 45 }, 2, 11 },
+  { { 111, 46 }, 2, 11 },  { { 111, 46 }, 2, 11 },  { { 111, 47 }, 2, 11 },
+  { { 111, 47 }, 2, 11 },  { { 111, 51 }, 2, 11 },  { { 111, 51 }, 2, 11 },
+  { { 111, 52 }, 2, 11 },  { { 111, 52 }, 2, 11 },  { { 111, 53 }, 2, 11 },
+  { { 111, 53 }, 2, 11 },  { { 111, 54 }, 2, 11 },  { { 111, 54 }, 2, 11 },
+  { { 111, 55 }, 2, 11 },  { { 111, 55 }, 2, 11 },  { { 111, 56 }, 2, 11 },
+  { { 111, 56 }, 2, 11 },  { { 111, 57 }, 2, 11 },  { { 111, 57 }, 2, 11 },
+  { { 111, 61 }, 2, 11 },  { { 111, 61 }, 2, 11 },  { { 111, 65 }, 2, 11 },
+  { { 111, 65 }, 2, 11 },  { { 111, 95 }, 2, 11 },  { { 111, 95 }, 2, 11 },
+  { { 111, 98 }, 2, 11 },  { { 111, 98 }, 2, 11 },  { { 111, 100 }, 2, 11 },
+  { { 111, 100 }, 2, 11 }, { { 111, 102 }, 2, 11 }, { { 111, 102 }, 2, 11 },
+  { { 111, 103 }, 2, 11 }, { { 111, 103 }, 2, 11 }, { { 111, 104 }, 2, 11 },
+  { { 111, 104 }, 2, 11 }, { { 111, 108 }, 2, 11 }, { { 111, 108 }, 2, 11 },
+  { { 111, 109 }, 2, 11 }, { { 111, 109 }, 2, 11 }, { { 111, 110 }, 2, 11 },
+  { { 111, 110 }, 2, 11 }, { { 111, 112 }, 2, 11 }, { { 111, 112 }, 2, 11 },
+  { { 111, 114 }, 2, 11 }, { { 111, 114 }, 2, 11 }, { { 111, 117 }, 2, 11 },
+  { { 111, 117 }, 2, 11 }, { { 111, 58 }, 2, 12 },  { { 111, 66 }, 2, 12 },
+  { { 111, 67 }, 2, 12 },  { { 111, 68 }, 2, 12 },  { { 111, 69 }, 2, 12 },
+  { { 111, 70 }, 2, 12 },  { { 111, 71 }, 2, 12 },  { { 111, 72 }, 2, 12 },
+  { { 111, 73 }, 2, 12 },  { { 111, 74 }, 2, 12 },  { { 111, 75 }, 2, 12 },
+  { { 111, 76 }, 2, 12 },  { { 111, 77 }, 2, 12 },  { { 111, 78 }, 2, 12 },
+  { { 111, 79 }, 2, 12 },  { { 111, 80 }, 2, 12 },  { { 111, 81 }, 2, 12 },
+  { { 111, 82 }, 2, 12 },  { { 111, 83 }, 2, 12 },  { { 111, 84 }, 2, 12 },
+  { { 111, 85 }, 2, 12 },  { { 111, 86 }, 2, 12 },  { { 111, 87 }, 2, 12 },
+  { { 111, 89 }, 2, 12 },  { { 111, 106 }, 2, 12 }, { { 111, 107 }, 2, 12 },
+  { { 111, 113 }, 2, 12 }, { { 111, 118 }, 2, 12 }, { { 111, 119 }, 2, 12 },
+  { { 111, 120 }, 2, 12 }, { { 111, 121 }, 2, 12 }, { { 111, 122 }, 2, 12 },
+  { { 111, 0 }, 1, 5 },    { { 111, 0 }, 1, 5 },    { { 111, 0 }, 1, 5 },
+  { { 111, 0 }, 1, 5 },    { { 115, 48 }, 2, 10 },  { { 115, 48 }, 2, 10 },
+  { { 115, 48 }, 2, 10 },  { { 115, 48 }, 2, 10 },  { { 115, 49 }, 2, 10 },
+  { { 115, 49 }, 2, 10 },  { { 115, 49 }, 2, 10 },  { { 115, 49 }, 2, 10 },
+  { { 115, 50 }, 2, 10 },  { { 115, 50 }, 2, 10 },  { { 115, 50 }, 2, 10 },
+  { { 115, 50 }, 2, 10 },  { { 115, 97 }, 2, 10 },  { { 115, 97 }, 2, 10 },
+  { { 115, 97 }, 2, 10 },  { { 115, 97 }, 2, 10 },  { { 115, 99 }, 2, 10 },
+  { { 115, 99 }, 2, 10 },  { { 115, 99 }, 2, 10 },  { { 115, 99 }, 2, 10 },
+  { { 115, 101 }, 2, 10 }, { { 115, 101 }, 2, 10 }, { { 115, 101 }, 2, 10 },
+  { { 115, 101 }, 2, 10 }, { { 115, 105 }, 2, 10 }, { { 115, 105 }, 2, 10 },
+  { { 115, 105 }, 2, 10 }, { { 115, 105 }, 2, 10 }, { { 115, 111 }, 2, 10 },
+  { { 115, 111 }, 2, 10 }, { { 115, 111 }, 2, 10 }, { { 115, 111 }, 2, 10 },
+  { { 115, 115 }, 2, 10 }, { { 115, 115 }, 2, 10 }, { { 115, 115 }, 2, 10 },
+  { { 115, 115 }, 2, 10 }, { { 115, 116 }, 2, 10 }, { { 115, 116 }, 2, 10 },
+  { { 115, 116 }, 2, 10 }, { { 115, 116 }, 2, 10 }, { { 115, 32 }, 2, 11 },
+  { { 115, 32 }, 2, 11 },  { { 115, 37 }, 2, 11 },  { { 115, 37 }, 2, 11 },
+  { { 115, 45 }, 2, 11 },  { { 115, 45 }, 2, 11 },  { { 115, 46 }, 2, 11 },
+  { { 115, 46 }, 2, 11 },  { { 115, 47 }, 2, 11 },  { { 115, 47 }, 2, 11 },
+  { { 115, 51 }, 2, 11 },  { { 115, 51 }, 2, 11 },  { { 115, 52 }, 2, 11 },
+  { { 115, 52 }, 2, 11 },  { { 115, 53 }, 2, 11 },  { { 115, 53 }, 2, 11 },
+  { { 115, 54 }, 2, 11 },  { { 115, 54 }, 2, 11 },  { { 115, 55 }, 2, 11 },
+  { { 115, 55 }, 2, 11 },  { { 115, 56 }, 2, 11 },  { { 115, 56 }, 2, 11 },
+  { { 115, 57 }, 2, 11 },  { { 115, 57 }, 2, 11 },  { { 115, 61 }, 2, 11 },
+  { { 115, 61 }, 2, 11 },  { { 115, 65 }, 2, 11 },  { { 115, 65 }, 2, 11 },
+  { { 115, 95 }, 2, 11 },  { { 115, 95 }, 2, 11 },  { { 115, 98 }, 2, 11 },
+  { { 115, 98 }, 2, 11 },  { { 115, 100 }, 2, 11 }, { { 115, 100 }, 2, 11 },
+  { { 115, 102 }, 2, 11 }, { { 115, 102 }, 2, 11 }, { { 115, 103 }, 2, 11 },
+  { { 115, 103 }, 2, 11 }, { { 115, 104 }, 2, 11 }, { { 115, 104 }, 2, 11 },
+  { { 115, 108 }, 2, 11 }, { { 115, 108 }, 2, 11 }, { { 115, 109 }, 2, 11 },
+  { { 115, 109 }, 2, 11 }, { { 115, 110 }, 2, 11 }, { { 115, 110 }, 2, 11 },
+  { { 115, 112 }, 2, 11 }, { { 115, 112 }, 2, 11 }, { { 115, 114 }, 2, 11 },
+  { { 115, 114 }, 2, 11 }, { { 115, 117 }, 2, 11 }, { { 115, 117 }, 2, 11 },
+  { { 115, 58 }, 2, 12 },  { { 115, 66 }, 2, 12 },  { { 115, 67 }, 2, 12 },
+  { { 115, 68 }, 2, 12 },  { { 115, 69 }, 2, 12 },  { { 115, 70 }, 2, 12 },
+  { { 115, 71 }, 2, 12 },  { { 115, 72 }, 2, 12 },  { { 115, 73 }, 2, 12 },
+  { { 115, 74 }, 2, 12 },  { { 115, 75 }, 2, 12 },  { { 115, 76 }, 2, 12 },
+  { { 115, 77 }, 2, 12 },  { { 115, 78 }, 2, 12 },  { { 115, 79 }, 2, 12 },
+  { { 115, 80 }, 2, 12 },  { { 115, 81 }, 2, 12 },  { { 115, 82 }, 2, 12 },
+  { { 115, 83 }, 2, 12 },  { { 115, 84 }, 2, 12 },  { { 115, 85 }, 2, 12 },
+  { { 115, 86 }, 2, 12 },  { { 115, 87 }, 2, 12 },  { { 115, 89 }, 2, 12 },
+  { { 115, 106 }, 2, 12 }, { { 115, 107 }, 2, 12 }, { { 115, 113 }, 2, 12 },
+  { { 115, 118 }, 2, 12 }, { { 115, 119 }, 2, 12 }, { { 115, 120 }, 2, 12 },
+  { { 115, 121 }, 2, 12 }, { { 115, 122 }, 2, 12 }, { { 115, 0 }, 1, 5 },
+  { { 115, 0 }, 1, 5 },    { { 115, 0 }, 1, 5 },    { { 115, 0 }, 1, 5 },
+  { { 116, 48 }, 2, 10 },  { { 116, 48 }, 2, 10 },  { { 116, 48 }, 2, 10 },
+  { { 116, 48 }, 2, 10 },  { { 116, 49 }, 2, 10 },  { { 116, 49 }, 2, 10 },
+  { { 116, 49 }, 2, 10 },  { { 116, 49 }, 2, 10 },  { { 116, 50 }, 2, 10 },
+  { { 116, 50 }, 2, 10 },  { { 116, 50 }, 2, 10 },  { { 116, 50 }, 2, 10 },
+  { { 116, 97 }, 2, 10 },  { { 116, 97 }, 2, 10 },  { { 116, 97 }, 2, 10 },
+  { { 116, 97 }, 2, 10 },  { { 116, 99 }, 2, 10 },  { { 116, 99 }, 2, 10 },
+  { { 116, 99 }, 2, 10 },  { { 116, 99 }, 2, 10 },  { { 116, 101 }, 2, 10 },
+  { { 116, 101 }, 2, 10 }, { { 116, 101 }, 2, 10 }, { { 116, 101 }, 2, 10 },
+  { { 116, 105 }, 2, 10 }, { { 116, 105 }, 2, 10 }, { { 116, 105 }, 2, 10 },
+  { { 116, 105 }, 2, 10 }, { { 116, 111 }, 2, 10 }, { { 116, 111 }, 2, 10 },
+  { { 116, 111 }, 2, 10 }, { { 116, 111 }, 2, 10 }, { { 116, 115 }, 2, 10 },
+  { { 116, 115 }, 2, 10 }, { { 116, 115 }, 2, 10 }, { { 116, 115 }, 2, 10 },
+  { { 116, 116 }, 2, 10 }, { { 116, 116 }, 2, 10 }, { { 116, 116 }, 2, 10 },
+  { { 116, 116 }, 2, 10 }, { { 116, 32 }, 2, 11 },  { { 116, 32 }, 2, 11 },
+  { { 116, 37 }, 2, 11 },  { { 116, 37 }, 2, 11 },  { { 116, 45 }, 2, 11 },
+  { { 116, 45 }, 2, 11 },  { { 116, 46 }, 2, 11 },  { { 116, 46 }, 2, 11 },
+  { { 116, 47 }, 2, 11 },  { { 116, 47 }, 2, 11 },  { { 116, 51 }, 2, 11 },
+  { { 116, 51 }, 2, 11 },  { { 116, 52 }, 2, 11 },  { { 116, 52 }, 2, 11 },
+  { { 116, 53 }, 2, 11 },  { { 116, 53 }, 2, 11 },  { { 116, 54 }, 2, 11 },
+  { { 116, 54 }, 2, 11 },  { { 116, 55 }, 2, 11 },  { { 116, 55 }, 2, 11 },
+  { { 116, 56 }, 2, 11 },  { { 116, 56 }, 2, 11 },  { { 116, 57 }, 2, 11 },
+  { { 116, 57 }, 2, 11 },  { { 116, 61 }, 2, 11 },  { { 116, 61 }, 2, 11 },
+  { { 116, 65 }, 2, 11 },  { { 116, 65 }, 2, 11 },  { { 116, 95 }, 2, 11 },
+  { { 116, 95 }, 2, 11 },  { { 116, 98 }, 2, 11 },  { { 116, 98 }, 2, 11 },
+  { { 116, 100 }, 2, 11 }, { { 116, 100 }, 2, 11 }, { { 116, 102 }, 2, 11 },
+  { { 116, 102 }, 2, 11 }, { { 116, 103 }, 2, 11 }, { { 116, 103 }, 2, 11 },
+  { { 116, 104 }, 2, 11 }, { { 116, 104 }, 2, 11 }, { { 116, 108 }, 2, 11 },
+  { { 116, 108 }, 2, 11 }, { { 116, 109 }, 2, 11 }, { { 116, 109 }, 2, 11 },
+  { { 116, 110 }, 2, 11 }, { { 116, 110 }, 2, 11 }, { { 116, 112 }, 2, 11 },
+  { { 116, 112 }, 2, 11 }, { { 116, 114 }, 2, 11 }, { { 116, 114 }, 2, 11 },
+  { { 116, 117 }, 2, 11 }, { { 116, 117 }, 2, 11 }, { { 116, 58 }, 2, 12 },
+  { { 116, 66 }, 2, 12 },  { { 116, 67 }, 2, 12 },  { { 116, 68 }, 2, 12 },
+  { { 116, 69 }, 2, 12 },  { { 116, 70 }, 2, 12 },  { { 116, 71 }, 2, 12 },
+  { { 116, 72 }, 2, 12 },  { { 116, 73 }, 2, 12 },  { { 116, 74 }, 2, 12 },
+  { { 116, 75 }, 2, 12 },  { { 116, 76 }, 2, 12 },  { { 116, 77 }, 2, 12 },
+  { { 116, 78 }, 2, 12 },  { { 116, 79 }, 2, 12 },  { { 116, 80 }, 2, 12 },
+  { { 116, 81 }, 2, 12 },  { { 116, 82 }, 2, 12 },  { { 116, 83 }, 2, 12 },
+  { { 116, 84 }, 2, 12 },  { { 116, 85 }, 2, 12 },  { { 116, 86 }, 2, 12 },
+  { { 116, 87 }, 2, 12 },  { { 116, 89 }, 2, 12 },  { { 116, 106 }, 2, 12 },
+  { { 116, 107 }, 2, 12 }, { { 116, 113 }, 2, 12 }, { { 116, 118 }, 2, 12 },
+  { { 116, 119 }, 2, 12 }, { { 116, 120 }, 2, 12 }, { { 116, 121 }, 2, 12 },
+  { { 116, 122 }, 2, 12 }, { { 116, 0 }, 1, 5 },    { { 116, 0 }, 1, 5 },
+  { { 116, 0 }, 1, 5 },    { { 116, 0 }, 1, 5 },    { { 32, 48 }, 2, 11 },
+  { { 32, 48 }, 2, 11 },   { { 32, 49 }, 2, 11 },   { { 32, 49 }, 2, 11 },
+  { { 32, 50 }, 2, 11 },   { { 32, 50 }, 2, 11 },   { { 32, 97 }, 2, 11 },
+  { { 32, 97 }, 2, 11 },   { { 32, 99 }, 2, 11 },   { { 32, 99 }, 2, 11 },
+  { { 32, 101 }, 2, 11 },  { { 32, 101 }, 2, 11 },  { { 32, 105 }, 2, 11 },
+  { { 32, 105 }, 2, 11 },  { { 32, 111 }, 2, 11 },  { { 32, 111 }, 2, 11 },
+  { { 32, 115 }, 2, 11 },  { { 32, 115 }, 2, 11 },  { { 32, 116 }, 2, 11 },
+  { { 32, 116 }, 2, 11 },  { { 32, 32 }, 2, 12 },   { { 32, 37 }, 2, 12 },
+  { { 32, 45 }, 2, 12 },   { { 32, 46 }, 2, 12 },   { { 32, 47 }, 2, 12 },
+  { { 32, 51 }, 2, 12 },   { { 32, 52 }, 2, 12 },   { { 32, 53 }, 2, 12 },
+  { { 32, 54 }, 2, 12 },   { { 32, 55 }, 2, 12 },   { { 32, 56 }, 2, 12 },
+  { { 32, 57 }, 2, 12 },   { { 32, 61 }, 2, 12 },   { { 32, 65 }, 2, 12 },
+  { { 32, 95 }, 2, 12 },   { { 32, 98 }, 2, 12 },   { { 32, 100 }, 2, 12 },
+  { { 32, 102 }, 2, 12 },  { { 32, 103 }, 2, 12 },  { { 32, 104 }, 2, 12 },
+  { { 32, 108 }, 2, 12 },  { { 32, 109 }, 2, 12 },  { { 32, 110 }, 2, 12 },
+  { { 32, 112 }, 2, 12 },  { { 32, 114 }, 2, 12 },  { { 32, 117 }, 2, 12 },
+  { { 32, 0 }, 1, 6 },     { { 32, 0 }, 1, 6 },     { { 32, 0 }, 1, 6 },
+  { { 32, 0 }, 1, 6 },     { { 32, 0 }, 1, 6 },     { { 32, 0 }, 1, 6 },
+  { { 32, 0 }, 1, 6 },     { { 32, 0 }, 1, 6 },     { { 32, 0 }, 1, 6 },
+  { { 32, 0 }, 1, 6 },     { { 32, 0 }, 1, 6 },     { { 32, 0 }, 1, 6 },
+  { { 32, 0 }, 1, 6 },     { { 32, 0 }, 1, 6 },     { { 32, 0 }, 1, 6 },
+  { { 32, 0 }, 1, 6 },     { { 32, 0 }, 1, 6 },     { { 32, 0 }, 1, 6 },
+  { { 37, 48 }, 2, 11 },   { { 37, 48 }, 2, 11 },   { { 37, 49 }, 2, 11 },
+  { { 37, 49 }, 2, 11 },   { { 37, 50 }, 2, 11 },   { { 37, 50 }, 2, 11 },
+  { { 37, 97 }, 2, 11 },   { { 37, 97 }, 2, 11 },   { { 37, 99 }, 2, 11 },
+  { { 37, 99 }, 2, 11 },   { { 37, 101 }, 2, 11 },  { { 37, 101 }, 2, 11 },
+  { { 37, 105 }, 2, 11 },  { { 37, 105 }, 2, 11 },  { { 37, 111 }, 2, 11 },
+  { { 37, 111 }, 2, 11 },  { { 37, 115 }, 2, 11 },  { { 37, 115 }, 2, 11 },
+  { { 37, 116 }, 2, 11 },  { { 37, 116 }, 2, 11 },  { { 37, 32 }, 2, 12 },
+  { { 37, 37 }, 2, 12 },   { { 37, 45 }, 2, 12 },   { { 37, 46 }, 2, 12 },
+  { { 37, 47 }, 2, 12 },   { { 37, 51 }, 2, 12 },   { { 37, 52 }, 2, 12 },
+  { { 37, 53 }, 2, 12 },   { { 37, 54 }, 2, 12 },   { { 37, 55 }, 2, 12 },
+  { { 37, 56 }, 2, 12 },   { { 37, 57 }, 2, 12 },   { { 37, 61 }, 2, 12 },
+  { { 37, 65 }, 2, 12 },   { { 37, 95 }, 2, 12 },   { { 37, 98 }, 2, 12 },
+  { { 37, 100 }, 2, 12 },  { { 37, 102 }, 2, 12 },  { { 37, 103 }, 2, 12 },
+  { { 37, 104 }, 2, 12 },  { { 37, 108 }, 2, 12 },  { { 37, 109 }, 2, 12 },
+  { { 37, 110 }, 2, 12 },  { { 37, 112 }, 2, 12 },  { { 37, 114 }, 2, 12 },
+  { { 37, 117 }, 2, 12 },  { { 37, 0 }, 1, 6 },     { { 37, 0 }, 1, 6 },
+  { { 37, 0 }, 1, 6 },     { { 37, 0 }, 1, 6 },     { { 37, 0 }, 1, 6 },
+  { { 37, 0 }, 1, 6 },     { { 37, 0 }, 1, 6 },     { { 37, 0 }, 1, 6 },
+  { { 37, 0 }, 1, 6 },     { { 37, 0 }, 1, 6 },     { { 37, 0 }, 1, 6 },
+  { { 37, 0 }, 1, 6 },     { { 37, 0 }, 1, 6 },     { { 37, 0 }, 1, 6 },
+  { { 37, 0 }, 1, 6 },     { { 37, 0 }, 1, 6 },     { { 37, 0 }, 1, 6 },
+  { { 37, 0 }, 1, 6 },     { { 45, 48 }, 2, 11 },   { { 45, 48 }, 2, 11 },
+  { { 45, 49 }, 2, 11 },   { { 45, 49 }, 2, 11 },   { { 45, 50 }, 2, 11 },
+  { { 45, 50 }, 2, 11 },   { { 45, 97 }, 2, 11 },   { { 45, 97 }, 2, 11 },
+  { { 45, 99 }, 2, 11 },   { { 45, 99 }, 2, 11 },   { { 45, 101 }, 2, 11 },
+  { { 45, 101 }, 2, 11 },  { { 45, 105 }, 2, 11 },  { { 45, 105 }, 2, 11 },
+  { { 45, 111 }, 2, 11 },  { { 45, 111 }, 2, 11 },  { { 45, 115 }, 2, 11 },
+  { { 45, 115 }, 2, 11 },  { { 45, 116 }, 2, 11 },  { { 45, 116 }, 2, 11 },
+  { { 45, 32 }, 2, 12 },   { { 45, 37 }, 2, 12 },   { { 45, 45 }, 2, 12 },
+  { { 45, 46 }, 2, 12 },   { { 45, 47 }, 2, 12 },   { { 45, 51 }, 2, 12 },
+  { { 45, 52 }, 2, 12 },   { { 45, 53 }, 2, 12 },   { { 45, 54 }, 2, 12 },
+  { { 45, 55 }, 2, 12 },   { { 45, 56 }, 2, 12 },   { { 45, 57 }, 2, 12 },
+  { { 45, 61 }, 2, 12 },   { { 45, 65 }, 2, 12 },   { { 45, 95 }, 2, 12 },
+  { { 45, 98 }, 2, 12 },   { { 45, 100 }, 2, 12 },  { { 45, 102 }, 2, 12 },
+  { { 45, 103 }, 2, 12 },  { { 45, 104 }, 2, 12 },  { { 45, 108 }, 2, 12 },
+  { { 45, 109 }, 2, 12 },  { { 45, 110 }, 2, 12 },  { { 45, 112 }, 2, 12 },
+  { { 45, 114 }, 2, 12 },  { { 45, 117 }, 2, 12 },  { { 45, 0 }, 1, 6 },
+  { { 45, 0 }, 1, 6 },     { { 45, 0 }, 1, 6 },     { { 45, 0 }, 1, 6 },
+  { { 45, 0 }, 1, 6 },     { { 45, 0 }, 1, 6 },     { { 45, 0 }, 1, 6 },
+  { { 45, 0 }, 1, 6 },     { { 45, 0 }, 1, 6 },     { { 45, 0 }, 1, 6 },
+  { { 45, 0 }, 1, 6 },     { { 45, 0 }, 1, 6 },     { { 45, 0 }, 1, 6 },
+  { { 45, 0 }, 1, 6 },     { { 45, 0 }, 1, 6 },     { { 45, 0 }, 1, 6 },
+  { { 45, 0 }, 1, 6 },     { { 45, 0 }, 1, 6 },     { { 46, 48 }, 2, 11 },
+  { { 46, 48 }, 2, 11 },   { { 46, 49 }, 2, 11 },   { { 46, 49 }, 2, 11 },
+  { { 46, 50 }, 2, 11 },   { { 46, 50 }, 2, 11 },   { { 46, 97 }, 2, 11 },
+  { { 46, 97 }, 2, 11 },   { { 46, 99 }, 2, 11 },   { { 46, 99 }, 2, 11 },
+  { { 46, 101 }, 2, 11 },  { { 46, 101 }, 2, 11 },  { { 46, 105 }, 2, 11 },
+  { { 46, 105 }, 2, 11 },  { { 46, 111 }, 2, 11 },  { { 46, 111 }, 2, 11 },
+  { { 46, 115 }, 2, 11 },  { { 46, 115 }, 2, 11 },  { { 46, 116 }, 2, 11 },
+  { { 46, 116 }, 2, 11 },  { { 46, 32 }, 2, 12 },   { { 46, 37 }, 2, 12 },
+  { { 46, 45 }, 2, 12 },   { { 46, 46 }, 2, 12 },   { { 46, 47 }, 2, 12 },
+  { { 46, 51 }, 2, 12 },   { { 46, 52 }, 2, 12 },   { { 46, 53 }, 2, 12 },
+  { { 46, 54 }, 2, 12 },   { { 46, 55 }, 2, 12 },   { { 46, 56 }, 2, 12 },
+  { { 46, 57 }, 2, 12 },   { { 46, 61 }, 2, 12 },   { { 46, 65 }, 2, 12 },
+  { { 46, 95 }, 2, 12 },   { { 46, 98 }, 2, 12 },   { { 46, 100 }, 2, 12 },
+  { { 46, 102 }, 2, 12 },  { { 46, 103 }, 2, 12 },  { { 46, 104 }, 2, 12 },
+  { { 46, 108 }, 2, 12 },  { { 46, 109 }, 2, 12 },  { { 46, 110 }, 2, 12 },
+  { { 46, 112 }, 2, 12 },  { { 46, 114 }, 2, 12 },  { { 46, 117 }, 2, 12 },
+  { { 46, 0 }, 1, 6 },     { { 46, 0 }, 1, 6 },     { { 46, 0 }, 1, 6 },
+  { { 46, 0 }, 1, 6 },     { { 46, 0 }, 1, 6 },     { { 46, 0 }, 1, 6 },
+  { { 46, 0 }, 1, 6 },     { { 46, 0 }, 1, 6 },     { { 46, 0 }, 1, 6 },
+  { { 46, 0 }, 1, 6 },     { { 46, 0 }, 1, 6 },     { { 46, 0 }, 1, 6 },
+  { { 46, 0 }, 1, 6 },     { { 46, 0 }, 1, 6 },     { { 46, 0 }, 1, 6 },
+  { { 46, 0 }, 1, 6 },     { { 46, 0 }, 1, 6 },     { { 46, 0 }, 1, 6 },
+  { { 47, 48 }, 2, 11 },   { { 47, 48 }, 2, 11 },   { { 47, 49 }, 2, 11 },
+  { { 47, 49 }, 2, 11 },   { { 47, 50 }, 2, 11 },   { { 47, 50 }, 2, 11 },
+  { { 47, 97 }, 2, 11 },   { { 47, 97 }, 2, 11 },   { { 47, 99 }, 2, 11 },
+  { { 47, 99 }, 2, 11 },   { { 47, 101 }, 2, 11 },  { { 47, 101 }, 2, 11 },
+  { { 47, 105 }, 2, 11 },  { { 47, 105 }, 2, 11 },  { { 47, 111 }, 2, 11 },
+  { { 47, 111 }, 2, 11 },  { { 47, 115 }, 2, 11 },  { { 47, 115 }, 2, 11 },
+  { { 47, 116 }, 2, 11 },  { { 47, 116 }, 2, 11 },  { { 47, 32 }, 2, 12 },
+  { { 47, 37 }, 2, 12 },   { { 47, 45 }, 2, 12 },   { { 47, 46 }, 2, 12 },
+  { { 47, 47 }, 2, 12 },   { { 47, 51 }, 2, 12 },   { { 47, 52 }, 2, 12 },
+  { { 47, 53 }, 2, 12 },   { { 47, 54 }, 2, 12 },   { { 47, 55 }, 2, 12 },
+  { { 47, 56 }, 2, 12 },   { { 47, 57 }, 2, 12 },   { { 47, 61 }, 2, 12 },
+  { { 47, 65 }, 2, 12 },   { { 47, 95 }, 2, 12 },   { { 47, 98 }, 2, 12 },
+  { { 47, 100 }, 2, 12 },  { { 47, 102 }, 2, 12 },  { { 47, 103 }, 2, 12 },
+  { { 47, 104 }, 2, 12 },  { { 47, 108 }, 2, 12 },  { { 47, 109 }, 2, 12 },
+  { { 47, 110 }, 2, 12 },  { { 47, 112 }, 2, 12 },  { { 47, 114 }, 2, 12 },
+  { { 47, 117 }, 2, 12 },  { { 47, 0 }, 1, 6 },     { { 47, 0 }, 1, 6 },
+  { { 47, 0 }, 1, 6 },     { { 47, 0 }, 1, 6 },     { { 47, 0 }, 1, 6 },
+  { { 47, 0 }, 1, 6 },     { { 47, 0 }, 1, 6 },     { { 47, 0 }, 1, 6 },
+  { { 47, 0 }, 1, 6 },     { { 47, 0 }, 1, 6 },     { { 47, 0 }, 1, 6 },
+  { { 47, 0 }, 1, 6 },     { { 47, 0 }, 1, 6 },     { { 47, 0 }, 1, 6 },
+  { { 47, 0 }, 1, 6 },     { { 47, 0 }, 1, 6 },     { { 47, 0 }, 1, 6 },
+  { { 47, 0 }, 1, 6 },     { { 51, 48 }, 2, 11 },   { { 51, 48 }, 2, 11 },
+  { { 51, 49 }, 2, 11 },   { { 51, 49 }, 2, 11 },   { { 51, 50 }, 2, 11 },
+  { { 51, 50 }, 2, 11 },   { { 51, 97 }, 2, 11 },   { { 51, 97 }, 2, 11 },
+  { { 51, 99 }, 2, 11 },   { { 51, 99 }, 2, 11 },   { { 51, 101 }, 2, 11 },
+  { { 51, 101 }, 2, 11 },  { { 51, 105 }, 2, 11 },  { { 51, 105 }, 2, 11 },
+  { { 51, 111 }, 2, 11 },  { { 51, 111 }, 2, 11 },  { { 51, 115 }, 2, 11 },
+  { { 51, 115 }, 2, 11 },  { { 51, 116 }, 2, 11 },  { { 51, 116 }, 2, 11 },
+  { { 51, 32 }, 2, 12 },   { { 51, 37 }, 2, 12 },   { { 51, 45 }, 2, 12 },
+  { { 51, 46 }, 2, 12 },   { { 51, 47 }, 2, 12 },   { { 51, 51 }, 2, 12 },
+  { { 51, 52 }, 2, 12 },   { { 51, 53 }, 2, 12 },   { { 51, 54 }, 2, 12 },
+  { { 51, 55 }, 2, 12 },   { { 51, 56 }, 2, 12 },   { { 51, 57 }, 2, 12 },
+  { { 51, 61 }, 2, 12 },   { { 51, 65 }, 2, 12 },   { { 51, 95 }, 2, 12 },
+  { { 51, 98 }, 2, 12 },   { { 51, 100 }, 2, 12 },  { { 51, 102 }, 2, 12 },
+  { { 51, 103 }, 2, 12 },  { { 51, 104 }, 2, 12 },  { { 51, 108 }, 2, 12 },
+  { { 51, 109 }, 2, 12 },  { { 51, 110 }, 2, 12 },  { { 51, 112 }, 2, 12 },
+  { { 51, 114 }, 2, 12 },  { { 51, 117 }, 2, 12 },  { { 51, 0 }, 1, 6 },
+  { { 51, 0 }, 1, 6 },     { { 51, 0 }, 1, 6 },     { { 51, 0 }, 1, 6 },
+  { { 51, 0 }, 1, 6 },     { { 51, 0 }, 1, 6 },     { { 51, 0 }, 1, 6 },
+  { { 51, 0 }, 1, 6 },     { { 51, 0 }, 1, 6 },     { { 51, 0 }, 1, 6 },
+  { { 51, 0 }, 1, 6 },     { { 51, 0 }, 1, 6 },     { { 51, 0 }, 1, 6 },
+  { { 51, 0 }, 1, 6 },     { { 51, 0 }, 1, 6 },     { { 51, 0 }, 1, 6 },
+  { { 51, 0 }, 1, 6 },     { { 51, 0 }, 1, 6 },     { { 52, 48 }, 2, 11 },
+  { { 52, 48 }, 2, 11 },   { { 52, 49 }, 2, 11 },   { { 52, 49 }, 2, 11 },
+  { { 52, 50 }, 2, 11 },   { { 52, 50 }, 2, 11 },   { { 52, 97 }, 2, 11 },
+  { { 52, 97 }, 2, 11 },   { { 52, 99 }, 2, 11 },   { { 52, 99 }, 2, 11 },
+  { { 52, 101 }, 2, 11 },  { { 52, 101 }, 2, 11 },  { { 52, 105 }, 2, 11 },
+  { { 52, 105 }, 2, 11 },  { { 52, 111 }, 2, 11 },  { { 52, 111 }, 2, 11 },
+  { { 52, 115 }, 2, 11 },  { { 52, 115 }, 2, 11 },  { { 52, 116 }, 2, 11 },
+  { { 52, 116 }, 2, 11 },  { { 52, 32 }, 2, 12 },   { { 52, 37 }, 2, 12 },
+  { { 52, 45 }, 2, 12 },   { { 52, 46 }, 2, 12 },   { { 52, 47 }, 2, 12 },
+  { { 52, 51 }, 2, 12 },   { { 52, 52 }, 2, 12 },   { { 52, 53 }, 2, 12 },
+  { { 52, 54 }, 2, 12 },   { { 52, 55 }, 2, 12 },   { { 52, 56 }, 2, 12 },
+  { { 52, 57 }, 2, 12 },   { { 52, 61 }, 2, 12 },   { { 52, 65 }, 2, 12 },
+  { { 52, 95 }, 2, 12 },   { { 52, 98 }, 2, 12 },   { { 52, 100 }, 2, 12 },
+  { { 52, 102 }, 2, 12 },  { { 52, 103 }, 2, 12 },  { { 52, 104 }, 2, 12 },
+  { { 52, 108 }, 2, 12 },  { { 52, 109 }, 2, 12 },  { { 52, 110 }, 2, 12 },
+  { { 52, 112 }, 2, 12 },  { { 52, 114 }, 2, 12 },  { { 52, 117 }, 2, 12 },
+  { { 52, 0 }, 1, 6 },     { { 52, 0 }, 1, 6 },     { { 52, 0 }, 1, 6 },
+  { { 52, 0 }, 1, 6 },     { { 52, 0 }, 1, 6 },     { { 52, 0 }, 1, 6 },
+  { { 52, 0 }, 1, 6 },     { { 52, 0 }, 1, 6 },     { { 52, 0 }, 1, 6 },
+  { { 52, 0 }, 1, 6 },     { { 52, 0 }, 1, 6 },     { { 52, 0 }, 1, 6 },
+  { { 52, 0 }, 1, 6 },     { { 52, 0 }, 1, 6 },     { { 52, 0 }, 1, 6 },
+  { { 52, 0 }, 1, 6 },     { { 52, 0 }, 1, 6 },     { { 52, 0 }, 1, 6 },
+  { { 53, 48 }, 2, 11 },   { { 53, 48 }, 2, 11 },   { { 53, 49 }, 2, 11 },
+  { { 53, 49 }, 2, 11 },   { { 53, 50 }, 2, 11 },   { { 53, 50 }, 2, 11 },
+  { { 53, 97 }, 2, 11 },   { { 53, 97 }, 2, 11 },   { { 53, 99 }, 2, 11 },
+  { { 53, 99 }, 2, 11 },   { { 53, 101 }, 2, 11 },  { { 53, 101 }, 2, 11 },
+  { { 53, 105 }, 2, 11 },  { { 53, 105 }, 2, 11 },  { { 53, 111 }, 2, 11 },
+  { { 53, 111 }, 2, 11 },  { { 53, 115 }, 2, 11 },  { { 53, 115 }, 2, 11 },
+  { { 53, 116 }, 2, 11 },  { { 53, 116 }, 2, 11 },  { { 53, 32 }, 2, 12 },
+  { { 53, 37 }, 2, 12 },   { { 53, 45 }, 2, 12 },   { { 53, 46 }, 2, 12 },
+  { { 53, 47 }, 2, 12 },   { { 53, 51 }, 2, 12 },   { { 53, 52 }, 2, 12 },
+  { { 53, 53 }, 2, 12 },   { { 53, 54 }, 2, 12 },   { { 53, 55 }, 2, 12 },
+  { { 53, 56 }, 2, 12 },   { { 53, 57 }, 2, 12 },   { { 53, 61 }, 2, 12 },
+  { { 53, 65 }, 2, 12 },   { { 53, 95 }, 2, 12 },   { { 53, 98 }, 2, 12 },
+  { { 53, 100 }, 2, 12 },  { { 53, 102 }, 2, 12 },  { { 53, 103 }, 2, 12 },
+  { { 53, 104 }, 2, 12 },  { { 53, 108 }, 2, 12 },  { { 53, 109 }, 2, 12 },
+  { { 53, 110 }, 2, 12 },  { { 53, 112 }, 2, 12 },  { { 53, 114 }, 2, 12 },
+  { { 53, 117 }, 2, 12 },  { { 53, 0 }, 1, 6 },     { { 53, 0 }, 1, 6 },
+  { { 53, 0 }, 1, 6 },     { { 53, 0 }, 1, 6 },     { { 53, 0 }, 1, 6 },
+  { { 53, 0 }, 1, 6 },     { { 53, 0 }, 1, 6 },     { { 53, 0 }, 1, 6 },
+  { { 53, 0 }, 1, 6 },     { { 53, 0 }, 1, 6 },     { { 53, 0 }, 1, 6 },
+  { { 53, 0 }, 1, 6 },     { { 53, 0 }, 1, 6 },     { { 53, 0 }, 1, 6 },
+  { { 53, 0 }, 1, 6 },     { { 53, 0 }, 1, 6 },     { { 53, 0 }, 1, 6 },
+  { { 53, 0 }, 1, 6 },     { { 54, 48 }, 2, 11 },   { { 54, 48 }, 2, 11 },
+  { { 54, 49 }, 2, 11 },   { { 54, 49 }, 2, 11 },   { { 54, 50 }, 2, 11 },
+  { { 54, 50 }, 2, 11 },   { { 54, 97 }, 2, 11 },   { { 54, 97 }, 2, 11 },
+  { { 54, 99 }, 2, 11 },   { { 54, 99 }, 2, 11 },   { { 54, 101 }, 2, 11 },
+  { { 54, 101 }, 2, 11 },  { { 54, 105 }, 2, 11 },  { { 54, 105 }, 2, 11 },
+  { { 54, 111 }, 2, 11 },  { { 54, 111 }, 2, 11 },  { { 54, 115 }, 2, 11 },
+  { { 54, 115 }, 2, 11 },  { { 54, 116 }, 2, 11 },  { { 54, 116 }, 2, 11 },
+  { { 54, 32 }, 2, 12 },   { { 54, 37 }, 2, 12 },   { { 54, 45 }, 2, 12 },
+  { { 54, 46 }, 2, 12 },   { { 54, 47 }, 2, 12 },   { { 54, 51 }, 2, 12 },
+  { { 54, 52 }, 2, 12 },   { { 54, 53 }, 2, 12 },   { { 54, 54 }, 2, 12 },
+  { { 54, 55 }, 2, 12 },   { { 54, 56 }, 2, 12 },   { { 54, 57 }, 2, 12 },
+  { { 54, 61 }, 2, 12 },   { { 54, 65 }, 2, 12 },   { { 54, 95 }, 2, 12 },
+  { { 54, 98 }, 2, 12 },   { { 54, 100 }, 2, 12 },  { { 54, 102 }, 2, 12 },
+  { { 54, 103 }, 2, 12 },  { { 54, 104 }, 2, 12 },  { { 54, 108 }, 2, 12 },
+  { { 54, 109 }, 2, 12 },  { { 54, 110 }, 2, 12 },  { { 54, 112 }, 2, 12 },
+  { { 54, 114 }, 2, 12 },  { { 54, 117 }, 2, 12 },  { { 54, 0 }, 1, 6 },
+  { { 54, 0 }, 1, 6 },     { { 54, 0 }, 1, 6 },     { { 54, 0 }, 1, 6 },
+  { { 54, 0 }, 1, 6 },     { { 54, 0 }, 1, 6 },     { { 54, 0 }, 1, 6 },
+  { { 54, 0 }, 1, 6 },     { { 54, 0 }, 1, 6 },     { { 54, 0 }, 1, 6 },
+  { { 54, 0 }, 1, 6 },     { { 54, 0 }, 1, 6 },     { { 54, 0 }, 1, 6 },
+  { { 54, 0 }, 1, 6 },     { { 54, 0 }, 1, 6 },     { { 54, 0 }, 1, 6 },
+  { { 54, 0 }, 1, 6 },     { { 54, 0 }, 1, 6 },     { { 55, 48 }, 2, 11 },
+  { { 55, 48 }, 2, 11 },   { { 55, 49 }, 2, 11 },   { { 55, 49 }, 2, 11 },
+  { { 55, 50 }, 2, 11 },   { { 55, 50 }, 2, 11 },   { { 55, 97 }, 2, 11 },
+  { { 55, 97 }, 2, 11 },   { { 55, 99 }, 2, 11 },   { { 55, 99 }, 2, 11 },
+  { { 55, 101 }, 2, 11 },  { { 55, 101 }, 2, 11 },  { { 55, 105 }, 2, 11 },
+  { { 55, 105 }, 2, 11 },  { { 55, 111 }, 2, 11 },  { { 55, 111 }, 2, 11 },
+  { { 55, 115 }, 2, 11 },  { { 55, 115 }, 2, 11 },  { { 55, 116 }, 2, 11 },
+  { { 55, 116 }, 2, 11 },  { { 55, 32 }, 2, 12 },   { { 55, 37 }, 2, 12 },
+  { { 55, 45 }, 2, 12 },   { { 55, 46 }, 2, 12 },   { { 55, 47 }, 2, 12 },
+  { { 55, 51 }, 2, 12 },   { { 55, 52 }, 2, 12 },   { { 55, 53 }, 2, 12 },
+  { { 55, 54 }, 2, 12 },   { { 55, 55 }, 2, 12 },   { { 55, 56 }, 2, 12 },
+  { { 55, 57 }, 2, 12 },   { { 55, 61 }, 2, 12 },   { { 55, 65 }, 2, 12 },
+  { { 55, 95 }, 2, 12 },   { { 55, 98 }, 2, 12 },   { { 55, 100 }, 2, 12 },
+  { { 55, 102 }, 2, 12 },  { { 55, 103 }, 2, 12 },  { { 55, 104 }, 2, 12 },
+  { { 55, 108 }, 2, 12 },  { { 55, 109 }, 2, 12 },  { { 55, 110 }, 2, 12 },
+  { { 55, 112 }, 2, 12 },  { { 55, 114 }, 2, 12 },  { { 55, 117 }, 2, 12 },
+  { { 55, 0 }, 1, 6 },     { { 55, 0 }, 1, 6 },     { { 55, 0 }, 1, 6 },
+  { { 55, 0 }, 1, 6 },     { { 55, 0 }, 1, 6 },     { { 55, 0 }, 1, 6 },
+  { { 55, 0 }, 1, 6 },     { { 55, 0 }, 1, 6 },     { { 55, 0 }, 1, 6 },
+  { { 55, 0 }, 1, 6 },     { { 55, 0 }, 1, 6 },     { { 55, 0 }, 1, 6 },
+  { { 55, 0 }, 1, 6 },     { { 55, 0 }, 1, 6 },     { { 55, 0 }, 1, 6 },
+  { { 55, 0 }, 1, 6 },     { { 55, 0 }, 1, 6 },     { { 55, 0 }, 1, 6 },
+  { { 56, 48 }, 2, 11 },   { { 56, 48 }, 2, 11 },   { { 56, 49 }, 2, 11 },
+  { { 56, 49 }, 2, 11 },   { { 56, 50 }, 2, 11 },   { { 56, 50 }, 2, 11 },
+  { { 56, 97 }, 2, 11 },   { { 56, 97 }, 2, 11 },   { { 56, 99 }, 2, 11 },
+  { { 56, 99 }, 2, 11 },   { { 56, 101 }, 2, 11 },  { { 56, 101 }, 2, 11 },
+  { { 56, 105 }, 2, 11 },  { { 56, 105 }, 2, 11 },  { { 56, 111 }, 2, 11 },
+  { { 56, 111 }, 2, 11 },  { { 56, 115 }, 2, 11 },  { { 56, 115 }, 2, 11 },
+  { { 56, 116 }, 2, 11 },  { { 56, 116 }, 2, 11 },  { { 56, 32 }, 2, 12 },
+  { { 56, 37 }, 2, 12 },   { { 56, 45 }, 2, 12 },   { { 56, 46 }, 2, 12 },
+  { { 56, 47 }, 2, 12 },   { { 56, 51 }, 2, 12 },   { { 56, 52 }, 2, 12 },
+  { { 56, 53 }, 2, 12 },   { { 56, 54 }, 2, 12 },   { { 56, 55 }, 2, 12 },
+  { { 56, 56 }, 2, 12 },   { { 56, 57 }, 2, 12 },   { { 56, 61 }, 2, 12 },
+  { { 56, 65 }, 2, 12 },   { { 56, 95 }, 2, 12 },   { { 56, 98 }, 2, 12 },
+  { { 56, 100 }, 2, 12 },  { { 56, 102 }, 2, 12 },  { { 56, 103 }, 2, 12 },
+  { { 56, 104 }, 2, 12 },  { { 56, 108 }, 2, 12 },  { { 56, 109 }, 2, 12 },
+  { { 56, 110 }, 2, 12 },  { { 56, 112 }, 2, 12 },  { { 56, 114 }, 2, 12 },
+  { { 56, 117 }, 2, 12 },  { { 56, 0 }, 1, 6 },     { { 56, 0 }, 1, 6 },
+  { { 56, 0 }, 1, 6 },     { { 56, 0 }, 1, 6 },     { { 56, 0 }, 1, 6 },
+  { { 56, 0 }, 1, 6 },     { { 56, 0 }, 1, 6 },     { { 56, 0 }, 1, 6 },
+  { { 56, 0 }, 1, 6 },     { { 56, 0 }, 1, 6 },     { { 56, 0 }, 1, 6 },
+  { { 56, 0 }, 1, 6 },     { { 56, 0 }, 1, 6 },     { { 56, 0 }, 1, 6 },
+  { { 56, 0 }, 1, 6 },     { { 56, 0 }, 1, 6 },     { { 56, 0 }, 1, 6 },
+  { { 56, 0 }, 1, 6 },     { { 57, 48 }, 2, 11 },   { { 57, 48 }, 2, 11 },
+  { { 57, 49 }, 2, 11 },   { { 57, 49 }, 2, 11 },   { { 57, 50 }, 2, 11 },
+  { { 57, 50 }, 2, 11 },   { { 57, 97 }, 2, 11 },   { { 57, 97 }, 2, 11 },
+  { { 57, 99 }, 2, 11 },   { { 57, 99 }, 2, 11 },   { { 57, 101 }, 2, 11 },
+  { { 57, 101 }, 2, 11 },  { { 57, 105 }, 2, 11 },  { { 57, 105 }, 2, 11 },
+  { { 57, 111 }, 2, 11 },  { { 57, 111 }, 2, 11 },  { { 57, 115 }, 2, 11 },
+  { { 57, 115 }, 2, 11 },  { { 57, 116 }, 2, 11 },  { { 57, 116 }, 2, 11 },
+  { { 57, 32 }, 2, 12 },   { { 57, 37 }, 2, 12 },   { { 57, 45 }, 2, 12 },
+  { { 57, 46 }, 2, 12 },   { { 57, 47 }, 2, 12 },   { { 57, 51 }, 2, 12 },
+  { { 57, 52 }, 2, 12 },   { { 57, 53 }, 2, 12 },   { { 57, 54 }, 2, 12 },
+  { { 57, 55 }, 2, 12 },   { { 57, 56 }, 2, 12 },   { { 57, 57 }, 2, 12 },
+  { { 57, 61 }, 2, 12 },   { { 57, 65 }, 2, 12 },   { { 57, 95 }, 2, 12 },
+  { { 57, 98 }, 2, 12 },   { { 57, 100 }, 2, 12 },  { { 57, 102 }, 2, 12 },
+  { { 57, 103 }, 2, 12 },  { { 57, 104 }, 2, 12 },  { { 57, 108 }, 2, 12 },
+  { { 57, 109 }, 2, 12 },  { { 57, 110 }, 2, 12 },  { { 57, 112 }, 2, 12 },
+  { { 57, 114 }, 2, 12 },  { { 57, 117 }, 2, 12 },  { { 57, 0 }, 1, 6 },
+  { { 57, 0 }, 1, 6 },     { { 57, 0 }, 1, 6 },     { { 57, 0 }, 1, 6 },
+  { { 57, 0 }, 1, 6 },     { { 57, 0 }, 1, 6 },     { { 57, 0 }, 1, 6 },
+  { { 57, 0 }, 1, 6 },     { { 57, 0 }, 1, 6 },     { { 57, 0 }, 1, 6 },
+  { { 57, 0 }, 1, 6 },     { { 57, 0 }, 1, 6 },     { { 57, 0 }, 1, 6 },
+  { { 57, 0 }, 1, 6 },     { { 57, 0 }, 1, 6 },     { { 57, 0 }, 1, 6 },
+  { { 57, 0 }, 1, 6 },     { { 57, 0 }, 1, 6 },     { { 61, 48 }, 2, 11 },
+  { { 61, 48 }, 2, 11 },   { { 61, 49 }, 2, 11 },   { { 61, 49 }, 2, 11 },
+  { { 61, 50 }, 2, 11 },   { { 61, 50 }, 2, 11 },   { { 61, 97 }, 2, 11 },
+  { { 61, 97 }, 2, 11 },   { { 61, 99 }, 2, 11 },   { { 61, 99 }, 2, 11 },
+  { { 61, 101 }, 2, 11 },  { { 61, 101 }, 2, 11 },  { { 61, 105 }, 2, 11 },
+  { { 61, 105 }, 2, 11 },  { { 61, 111 }, 2, 11 },  { { 61, 111 }, 2, 11 },
+  { { 61, 115 }, 2, 11 },  { { 61, 115 }, 2, 11 },  { { 61, 116 }, 2, 11 },
+  { { 61, 116 }, 2, 11 },  { { 61, 32 }, 2, 12 },   { { 61, 37 }, 2, 12 },
+  { { 61, 45 }, 2, 12 },   { { 61, 46 }, 2, 12 },   { { 61, 47 }, 2, 12 },
+  { { 61, 51 }, 2, 12 },   { { 61, 52 }, 2, 12 },   { { 61, 53 }, 2, 12 },
+  { { 61, 54 }, 2, 12 },   { { 61, 55 }, 2, 12 },   { { 61, 56 }, 2, 12 },
+  { { 61, 57 }, 2, 12 },   { { 61, 61 }, 2, 12 },   { { 61, 65 }, 2, 12 },
+  { { 61, 95 }, 2, 12 },   { { 61, 98 }, 2, 12 },   { { 61, 100 }, 2, 12 },
+  { { 61, 102 }, 2, 12 },  { { 61, 103 }, 2, 12 },  { { 61, 104 }, 2, 12 },
+  { { 61, 108 }, 2, 12 },  { { 61, 109 }, 2, 12 },  { { 61, 110 }, 2, 12 },
+  { { 61, 112 }, 2, 12 },  { { 61, 114 }, 2, 12 },  { { 61, 117 }, 2, 12 },
+  { { 61, 0 }, 1, 6 },     { { 61, 0 }, 1, 6 },     { { 61, 0 }, 1, 6 },
+  { { 61, 0 }, 1, 6 },     { { 61, 0 }, 1, 6 },     { { 61, 0 }, 1, 6 },
+  { { 61, 0 }, 1, 6 },     { { 61, 0 }, 1, 6 },     { { 61, 0 }, 1, 6 },
+  { { 61, 0 }, 1, 6 },     { { 61, 0 }, 1, 6 },     { { 61, 0 }, 1, 6 },
+  { { 61, 0 }, 1, 6 },     { { 61, 0 }, 1, 6 },     { { 61, 0 }, 1, 6 },
+  { { 61, 0 }, 1, 6 },     { { 61, 0 }, 1, 6 },     { { 61, 0 }, 1, 6 },
+  { { 65, 48 }, 2, 11 },   { { 65, 48 }, 2, 11 },   { { 65, 49 }, 2, 11 },
+  { { 65, 49 }, 2, 11 },   { { 65, 50 }, 2, 11 },   { { 65, 50 }, 2, 11 },
+  { { 65, 97 }, 2, 11 },   { { 65, 97 }, 2, 11 },   { { 65, 99 }, 2, 11 },
+  { { 65, 99 }, 2, 11 },   { { 65, 101 }, 2, 11 },  { { 65, 101 }, 2, 11 },
+  { { 65, 105 }, 2, 11 },  { { 65, 105 }, 2, 11 },  { { 65, 111 }, 2, 11 },
+  { { 65, 111 }, 2, 11 },  { { 65, 115 }, 2, 11 },  { { 65, 115 }, 2, 11 },
+  { { 65, 116 }, 2, 11 },  { { 65, 116 }, 2, 11 },  { { 65, 32 }, 2, 12 },
+  { { 65, 37 }, 2, 12 },   { { 65, 45 }, 2, 12 },   { { 65, 46 }, 2, 12 },
+  { { 65, 47 }, 2, 12 },   { { 65, 51 }, 2, 12 },   { { 65, 52 }, 2, 12 },
+  { { 65, 53 }, 2, 12 },   { { 65, 54 }, 2, 12 },   { { 65, 55 }, 2, 12 },
+  { { 65, 56 }, 2, 12 },   { { 65, 57 }, 2, 12 },   { { 65, 61 }, 2, 12 },
+  { { 65, 65 }, 2, 12 },   { { 65, 95 }, 2, 12 },   { { 65, 98 }, 2, 12 },
+  { { 65, 100 }, 2, 12 },  { { 65, 102 }, 2, 12 },  { { 65, 103 }, 2, 12 },
+  { { 65, 104 }, 2, 12 },  { { 65, 108 }, 2, 12 },  { { 65, 109 }, 2, 12 },
+  { { 65, 110 }, 2, 12 },  { { 65, 112 }, 2, 12 },  { { 65, 114 }, 2, 12 },
+  { { 65, 117 }, 2, 12 },  { { 65, 0 }, 1, 6 },     { { 65, 0 }, 1, 6 },
+  { { 65, 0 }, 1, 6 },     { { 65, 0 }, 1, 6 },     { { 65, 0 }, 1, 6 },
+  { { 65, 0 }, 1, 6 },     { { 65, 0 }, 1, 6 },     { { 65, 0 }, 1, 6 },
+  { { 65, 0 }, 1, 6 },     { { 65, 0 }, 1, 6 },     { { 65, 0 }, 1, 6 },
+  { { 65, 0 }, 1, 6 },     { { 65, 0 }, 1, 6 },     { { 65, 0 }, 1, 6 },
+  { { 65, 0 }, 1, 6 },     { { 65, 0 }, 1, 6 },     { { 65, 0 }, 1, 6 },
+  { { 65, 0 }, 1, 6 },     { { 95, 48 }, 2, 11 },   { { 95, 48 }, 2, 11 },
+  { { 95, 49 }, 2, 11 },   { { 95, 49 }, 2, 11 },   { { 95, 50 }, 2, 11 },
+  { { 95, 50 }, 2, 11 },   { { 95, 97 }, 2, 11 },   { { 95, 97 }, 2, 11 },
+  { { 95, 99 }, 2, 11 },   { { 95, 99 }, 2, 11 },   { { 95, 101 }, 2, 11 },
+  { { 95, 101 }, 2, 11 },  { { 95, 105 }, 2, 11 },  { { 95, 105 }, 2, 11 },
+  { { 95, 111 }, 2, 11 },  { { 95, 111 }, 2, 11 },  { { 95, 115 }, 2, 11 },
+  { { 95, 115 }, 2, 11 },  { { 95, 116 }, 2, 11 },  { { 95, 116 }, 2, 11 },
+  { { 95, 32 }, 2, 12 },   { { 95, 37 }, 2, 12 },   { { 95, 45 }, 2, 12 },
+  { { 95, 46 }, 2, 12 },   { { 95, 47 }, 2, 12 },   { { 95, 51 }, 2, 12 },
+  { { 95, 52 }, 2, 12 },   { { 95, 53 }, 2, 12 },   { { 95, 54 }, 2, 12 },
+  { { 95, 55 }, 2, 12 },   { { 95, 56 }, 2, 12 },   { { 95, 57 }, 2, 12 },
+  { { 95, 61 }, 2, 12 },   { { 95, 65 }, 2, 12 },   { { 95, 95 }, 2, 12 },
+  { { 95, 98 }, 2, 12 },   { { 95, 100 }, 2, 12 },  { { 95, 102 }, 2, 12 },
+  { { 95, 103 }, 2, 12 },  { { 95, 104 }, 2, 12 },  { { 95, 108 }, 2, 12 },
+  { { 95, 109 }, 2, 12 },  { { 95, 110 }, 2, 12 },  { { 95, 112 }, 2, 12 },
+  { { 95, 114 }, 2, 12 },  { { 95, 117 }, 2, 12 },  { { 95, 0 }, 1, 6 },
+  { { 95, 0 }, 1, 6 },     { { 95, 0 }, 1, 6 },     { { 95, 0 }, 1, 6 },
+  { { 95, 0 }, 1, 6 },     { { 95, 0 }, 1, 6 },     { { 95, 0 }, 1, 6 },
+  { { 95, 0 }, 1, 6 },     { { 95, 0 }, 1, 6 },     { { 95, 0 }, 1, 6 },
+  { { 95, 0 }, 1, 6 },     { { 95, 0 }, 1, 6 },     { { 95, 0 }, 1, 6 },
+  { { 95, 0 }, 1, 6 },     { { 95, 0 }, 1, 6 },     { { 95, 0 }, 1, 6 },
+  { { 95, 0 }, 1, 6 },     { { 95, 0 }, 1, 6 },     { { 98, 48 }, 2, 11 },
+  { { 98, 48 }, 2, 11 },   { { 98, 49 }, 2, 11 },   { { 98, 49 }, 2, 11 },
+  { { 98, 50 }, 2, 11 },   { { 98, 50 }, 2, 11 },   { { 98, 97 }, 2, 11 },
+  { { 98, 97 }, 2, 11 },   { { 98, 99 }, 2, 11 },   { { 98, 99 }, 2, 11 },
+  { { 98, 101 }, 2, 11 },  { { 98, 101 }, 2, 11 },  { { 98, 105 }, 2, 11 },
+  { { 98, 105 }, 2, 11 },  { { 98, 111 }, 2, 11 },  { { 98, 111 }, 2, 11 },
+  { { 98, 115 }, 2, 11 },  { { 98, 115 }, 2, 11 },  { { 98, 116 }, 2, 11 },
+  { { 98, 116 }, 2, 11 },  { { 98, 32 }, 2, 12 },   { { 98, 37 }, 2, 12 },
+  { { 98, 45 }, 2, 12 },   { { 98, 46 }, 2, 12 },   { { 98, 47 }, 2, 12 },
+  { { 98, 51 }, 2, 12 },   { { 98, 52 }, 2, 12 },   { { 98, 53 }, 2, 12 },
+  { { 98, 54 }, 2, 12 },   { { 98, 55 }, 2, 12 },   { { 98, 56 }, 2, 12 },
+  { { 98, 57 }, 2, 12 },   { { 98, 61 }, 2, 12 },   { { 98, 65 }, 2, 12 },
+  { { 98, 95 }, 2, 12 },   { { 98, 98 }, 2, 12 },   { { 98, 100 }, 2, 12 },
+  { { 98, 102 }, 2, 12 },  { { 98, 103 }, 2, 12 },  { { 98, 104 }, 2, 12 },
+  { { 98, 108 }, 2, 12 },  { { 98, 109 }, 2, 12 },  { { 98, 110 }, 2, 12 },
+  { { 98, 112 }, 2, 12 },  { { 98, 114 }, 2, 12 },  { { 98, 117 }, 2, 12 },
+  { { 98, 0 }, 1, 6 },     { { 98, 0 }, 1, 6 },     { { 98, 0 }, 1, 6 },
+  { { 98, 0 }, 1, 6 },     { { 98, 0 }, 1, 6 },     { { 98, 0 }, 1, 6 },
+  { { 98, 0 }, 1, 6 },     { { 98, 0 }, 1, 6 },     { { 98, 0 }, 1, 6 },
+  { { 98, 0 }, 1, 6 },     { { 98, 0 }, 1, 6 },     { { 98, 0 }, 1, 6 },
+  { { 98, 0 }, 1, 6 },     { { 98, 0 }, 1, 6 },     { { 98, 0 }, 1, 6 },
+  { { 98, 0 }, 1, 6 },     { { 98, 0 }, 1, 6 },     { { 98, 0 }, 1, 6 },
+  { { 100, 48 }, 2, 11 },  { { 100, 48 }, 2, 11 },  { { 100, 49 }, 2, 11 },
+  { { 100, 49 }, 2, 11 },  { { 100, 50 }, 2, 11 },  { { 100, 50 }, 2, 11 },
+  { { 100, 97 }, 2, 11 },  { { 100, 97 }, 2, 11 },  { { 100, 99 }, 2, 11 },
+  { { 100, 99 }, 2, 11 },  { { 100, 101 }, 2, 11 }, { { 100, 101 }, 2, 11 },
+  { { 100, 105 }, 2, 11 }, { { 100, 105 }, 2, 11 }, { { 100, 111 }, 2, 11 },
+  { { 100, 111 }, 2, 11 }, { { 100, 115 }, 2, 11 }, { { 100, 115 }, 2, 11 },
+  { { 100, 116 }, 2, 11 }, { { 100, 116 }, 2, 11 }, { { 100, 32 }, 2, 12 },
+  { { 100, 37 }, 2, 12 },  { { 100, 45 }, 2, 12 },  { { 100, 46 }, 2, 12 },
+  { { 100, 47 }, 2, 12 },  { { 100, 51 }, 2, 12 },  { { 100, 52 }, 2, 12 },
+  { { 100, 53 }, 2, 12 },  { { 100, 54 }, 2, 12 },  { { 100, 55 }, 2, 12 },
+  { { 100, 56 }, 2, 12 },  { { 100, 57 }, 2, 12 },  { { 100, 61 }, 2, 12 },
+  { { 100, 65 }, 2, 12 },  { { 100, 95 }, 2, 12 },  { { 100, 98 }, 2, 12 },
+  { { 100, 100 }, 2, 12 }, { { 100, 102 }, 2, 12 }, { { 100, 103 }, 2, 12 },
+  { { 100, 104 }, 2, 12 }, { { 100, 108 }, 2, 12 }, { { 100, 109 }, 2, 12 },
+  { { 100, 110 }, 2, 12 }, { { 100, 112 }, 2, 12 }, { { 100, 114 }, 2, 12 },
+  { { 100, 117 }, 2, 12 }, { { 100, 0 }, 1, 6 },    { { 100, 0 }, 1, 6 },
+  { { 100, 0 }, 1, 6 },    { { 100, 0 }, 1, 6 },    { { 100, 0 }, 1, 6 },
+  { { 100, 0 }, 1, 6 },    { { 100, 0 }, 1, 6 },    { { 100, 0 }, 1, 6 },
+  { { 100, 0 }, 1, 6 },    { { 100, 0 }, 1, 6 },    { { 100, 0 }, 1, 6 },
+  { { 100, 0 }, 1, 6 },    { { 100, 0 }, 1, 6 },    { { 100, 0 }, 1, 6 },
+  { { 100, 0 }, 1, 6 },    { { 100, 0 }, 1, 6 },    { { 100, 0 }, 1, 6 },
+  { { 100, 0 }, 1, 6 },    { { 102, 48 }, 2, 11 },  { { 102, 48 }, 2, 11 },
+  { { 102, 49 }, 2, 11 },  { { 102, 49 }, 2, 11 },  { { 102, 50 }, 2, 11 },
+  { { 102, 50 }, 2, 11 },  { { 102, 97 }, 2, 11 },  { { 102, 97 }, 2, 11 },
+  { { 102, 99 }, 2, 11 },  { { 102, 99 }, 2, 11 },  { { 102, 101 }, 2, 11 },
+  { { 102, 101 }, 2, 11 }, { { 102, 105 }, 2, 11 }, { { 102, 105 }, 2, 11 },
+  { { 102, 111 }, 2, 11 }, { { 102, 111 }, 2, 11 }, { { 102, 115 }, 2, 11 },
+  { { 102, 115 }, 2, 11 }, { { 102, 116 }, 2, 11 }, { { 102, 116 }, 2, 11 },
+  { { 102, 32 }, 2, 12 },  { { 102, 37 }, 2, 12 },  { { 102, 45 }, 2, 12 },
+  { { 102, 46 }, 2, 12 },  { { 102, 47 }, 2, 12 },  { { 102, 51 }, 2, 12 },
+  { { 102, 52 }, 2, 12 },  { { 102, 53 }, 2, 12 },  { { 102, 54 }, 2, 12 },
+  { { 102, 55 }, 2, 12 },  { { 102, 56 }, 2, 12 },  { { 102, 57 }, 2, 12 },
+  { { 102, 61 }, 2, 12 },  { { 102, 65 }, 2, 12 },  { { 102, 95 }, 2, 12 },
+  { { 102, 98 }, 2, 12 },  { { 102, 100 }, 2, 12 }, { { 102, 102 }, 2, 12 },
+  { { 102, 103 }, 2, 12 }, { { 102, 104 }, 2, 12 }, { { 102, 108 }, 2, 12 },
+  { { 102, 109 }, 2, 12 }, { { 102, 110 }, 2, 12 }, { { 102, 112 }, 2, 12 },
+  { { 102, 114 }, 2, 12 }, { { 102, 117 }, 2, 12 }, { { 102, 0 }, 1, 6 },
+  { { 102, 0 }, 1, 6 },    { { 102, 0 }, 1, 6 },    { { 102, 0 }, 1, 6 },
+  { { 102, 0 }, 1, 6 },    { { 102, 0 }, 1, 6 },    { { 102, 0 }, 1, 6 },
+  { { 102, 0 }, 1, 6 },    { { 102, 0 }, 1, 6 },    { { 102, 0 }, 1, 6 },
+  { { 102, 0 }, 1, 6 },    { { 102, 0 }, 1, 6 },    { { 102, 0 }, 1, 6 },
+  { { 102, 0 }, 1, 6 },    { { 102, 0 }, 1, 6 },    { { 102, 0 }, 1, 6 },
+  { { 102, 0 }, 1, 6 },    { { 102, 0 }, 1, 6 },    { { 103, 48 }, 2, 11 },
+  { { 103, 48 }, 2, 11 },  { { 103, 49 }, 2, 11 },  { { 103, 49 }, 2, 11 },
+  { { 103, 50 }, 2, 11 },  { { 103, 50 }, 2, 11 },  { { 103, 97 }, 2, 11 },
+  { { 103, 97 }, 2, 11 },  { { 103, 99 }, 2, 11 },  { { 103, 99 }, 2, 11 },
+  { { 103, 101 }, 2, 11 }, { { 103, 101 }, 2, 11 }, { { 103, 105 }, 2, 11 },
+  { { 103, 105 }, 2, 11 }, { { 103, 111 }, 2, 11 }, { { 103, 111 }, 2, 11 },
+  { { 103, 115 }, 2, 11 }, { { 103, 115 }, 2, 11 }, { { 103, 116 }, 2, 11 },
+  { { 103, 116 }, 2, 11 }, { { 103, 32 }, 2, 12 },  { { 103, 37 }, 2, 12 },
+  { { 103, 45 }, 2, 12 },  { { 103, 46 }, 2, 12 },  { { 103, 47 }, 2, 12 },
+  { { 103, 51 }, 2, 12 },  { { 103, 52 }, 2, 12 },  { { 103, 53 }, 2, 12 },
+  { { 103, 54 }, 2, 12 },  { { 103, 55 }, 2, 12 },  { { 103, 56 }, 2, 12 },
+  { { 103, 57 }, 2, 12 },  { { 103, 61 }, 2, 12 },  { { 103, 65 }, 2, 12 },
+  { { 103, 95 }, 2, 12 },  { { 103, 98 }, 2, 12 },  { { 103, 100 }, 2, 12 },
+  { { 103, 102 }, 2, 12 }, { { 103, 103 }, 2, 12 }, { { 103, 104 }, 2, 12 },
+  { { 103, 108 }, 2, 12 }, { { 103, 109 }, 2, 12 }, { { 103, 110 }, 2, 12 },
+  { { 103, 112 }, 2, 12 }, { { 103, 114 }, 2, 12 }, { { 103, 117 }, 2, 12 },
+  { { 103, 0 }, 1, 6 },    { { 103, 0 }, 1, 6 },    { { 103, 0 }, 1, 6 },
+  { { 103, 0 }, 1, 6 },    { { 103, 0 }, 1, 6 },    { { 103, 0 }, 1, 6 },
+  { { 103, 0 }, 1, 6 },    { { 103, 0 }, 1, 6 },    { { 103, 0 }, 1, 6 },
+  { { 103, 0 }, 1, 6 },    { { 103, 0 }, 1, 6 },    { { 103, 0 }, 1, 6 },
+  { { 103, 0 }, 1, 6 },    { { 103, 0 }, 1, 6 },    { { 103, 0 }, 1, 6 },
+  { { 103, 0 }, 1, 6 },    { { 103, 0 }, 1, 6 },    { { 103, 0 }, 1, 6 },
+  { { 104, 48 }, 2, 11 },  { { 104, 48 }, 2, 11 },  { { 104, 49 }, 2, 11 },
+  { { 104, 49 }, 2, 11 },  { { 104, 50 }, 2, 11 },  { { 104, 50 }, 2, 11 },
+  { { 104, 97 }, 2, 11 },  { { 104, 97 }, 2, 11 },  { { 104, 99 }, 2, 11 },
+  { { 104, 99 }, 2, 11 },  { { 104, 101 }, 2, 11 }, { { 104, 101 }, 2, 11 },
+  { { 104, 105 }, 2, 11 }, { { 104, 105 }, 2, 11 }, { { 104, 111 }, 2, 11 },
+  { { 104, 111 }, 2, 11 }, { { 104, 115 }, 2, 11 }, { { 104, 115 }, 2, 11 },
+  { { 104, 116 }, 2, 11 }, { { 104, 116 }, 2, 11 }, { { 104, 32 }, 2, 12 },
+  { { 104, 37 }, 2, 12 },  { { 104, 45 }, 2, 12 },  { { 104, 46 }, 2, 12 },
+  { { 104, 47 }, 2, 12 },  { { 104, 51 }, 2, 12 },  { { 104, 52 }, 2, 12 },
+  { { 104, 53 }, 2, 12 },  { { 104, 54 }, 2, 12 },  { { 104, 55 }, 2, 12 },
+  { { 104, 56 }, 2, 12 },  { { 104, 57 }, 2, 12 },  { { 104, 61 }, 2, 12 },
+  { { 104, 65 }, 2, 12 },  { { 104, 95 }, 2, 12 },  { { 104, 98 }, 2, 12 },
+  { { 104, 100 }, 2, 12 }, { { 104, 102 }, 2, 12 }, { { 104, 103 }, 2, 12 },
+  { { 104, 104 }, 2, 12 }, { { 104, 108 }, 2, 12 }, { { 104, 109 }, 2, 12 },
+  { { 104, 110 }, 2, 12 }, { { 104, 112 }, 2, 12 }, { { 104, 114 }, 2, 12 },
+  { { 104, 117 }, 2, 12 }, { { 104, 0 }, 1, 6 },    { { 104, 0 }, 1, 6 },
+  { { 104, 0 }, 1, 6 },    { { 104, 0 }, 1, 6 },    { { 104, 0 }, 1, 6 },
+  { { 104, 0 }, 1, 6 },    { { 104, 0 }, 1, 6 },    { { 104, 0 }, 1, 6 },
+  { { 104, 0 }, 1, 6 },    { { 104, 0 }, 1, 6 },    { { 104, 0 }, 1, 6 },
+  { { 104, 0 }, 1, 6 },    { { 104, 0 }, 1, 6 },    { { 104, 0 }, 1, 6 },
+  { { 104, 0 }, 1, 6 },    { { 104, 0 }, 1, 6 },    { { 104, 0 }, 1, 6 },
+  { { 104, 0 }, 1, 6 },    { { 108, 48 }, 2, 11 },  { { 108, 48 }, 2, 11 },
+  { { 108, 49 }, 2, 11 },  { { 108, 49 }, 2, 11 },  { { 108, 50 }, 2, 11 },
+  { { 108, 50 }, 2, 11 },  { { 108, 97 }, 2, 11 },  { { 108, 97 }, 2, 11 },
+  { { 108, 99 }, 2, 11 },  { { 108, 99 }, 2, 11 },  { { 108, 101 }, 2, 11 },
+  { { 108, 101 }, 2, 11 }, { { 108, 105 }, 2, 11 }, { { 108, 105 }, 2, 11 },
+  { { 108, 111 }, 2, 11 }, { { 108, 111 }, 2, 11 }, { { 108, 115 }, 2, 11 },
+  { { 108, 115 }, 2, 11 }, { { 108, 116 }, 2, 11 }, { { 108, 116 }, 2, 11 },
+  { { 108, 32 }, 2, 12 },  { { 108, 37 }, 2, 12 },  { { 108, 45 }, 2, 12 },
+  { { 108, 46 }, 2, 12 },  { { 108, 47 }, 2, 12 },  { { 108, 51 }, 2, 12 },
+  { { 108, 52 }, 2, 12 },  { { 108, 53 }, 2, 12 },  { { 108, 54 }, 2, 12 },
+  { { 108, 55 }, 2, 12 },  { { 108, 56 }, 2, 12 },  { { 108, 57 }, 2, 12 },
+  { { 108, 61 }, 2, 12 },  { { 108, 65 }, 2, 12 },  { { 108, 95 }, 2, 12 },
+  { { 108, 98 }, 2, 12 },  { { 108, 100 }, 2, 12 }, { { 108, 102 }, 2, 12 },
+  { { 108, 103 }, 2, 12 }, { { 108, 104 }, 2, 12 }, { { 108, 108 }, 2, 12 },
+  { { 108, 109 }, 2, 12 }, { { 108, 110 }, 2, 12 }, { { 108, 112 }, 2, 12 },
+  { { 108, 114 }, 2, 12 }, { { 108, 117 }, 2, 12 }, { { 108, 0 }, 1, 6 },
+  { { 108, 0 }, 1, 6 },    { { 108, 0 }, 1, 6 },    { { 108, 0 }, 1, 6 },
+  { { 108, 0 }, 1, 6 },    { { 108, 0 }, 1, 6 },    { { 108, 0 }, 1, 6 },
+  { { 108, 0 }, 1, 6 },    { { 108, 0 }, 1, 6 },    { { 108, 0 }, 1, 6 },
+  { { 108, 0 }, 1, 6 },    { { 108, 0 }, 1, 6 },    { { 108, 0 }, 1, 6 },
+  { { 108, 0 }, 1, 6 },    { { 108, 0 }, 1, 6 },    { { 108, 0 }, 1, 6 },
+  { { 108, 0 }, 1, 6 },    { { 108, 0 }, 1, 6 },    { { 109, 48 }, 2, 11 },
+  { { 109, 48 }, 2, 11 },  { { 109, 49 }, 2, 11 },  { { 109, 49 }, 2, 11 },
+  { { 109, 50 }, 2, 11 },  { { 109, 50 }, 2, 11 },  { { 109, 97 }, 2, 11 },
+  { { 109, 97 }, 2, 11 },  { { 109, 99 }, 2, 11 },  { { 109, 99 }, 2, 11 },
+  { { 109, 101 }, 2, 11 }, { { 109, 101 }, 2, 11 }, { { 109, 105 }, 2, 11 },
+  { { 109, 105 }, 2, 11 }, { { 109, 111 }, 2, 11 }, { { 109, 111 }, 2, 11 },
+  { { 109, 115 }, 2, 11 }, { { 109, 115 }, 2, 11 }, { { 109, 116 }, 2, 11 },
+  { { 109, 116 }, 2, 11 }, { { 109, 32 }, 2, 12 },  { { 109, 37 }, 2, 12 },
+  { { 109, 45 }, 2, 12 },  { { 109, 46 }, 2, 12 },  { { 109, 47 }, 2, 12 },
+  { { 109, 51 }, 2, 12 },  { { 109, 52 }, 2, 12 },  { { 109, 53 }, 2, 12 },
+  { { 109, 54 }, 2, 12 },  { { 109, 55 }, 2, 12 },  { { 109, 56 }, 2, 12 },
+  { { 109, 57 }, 2, 12 },  { { 109, 61 }, 2, 12 },  { { 109, 65 }, 2, 12 },
+  { { 109, 95 }, 2, 12 },  { { 109, 98 }, 2, 12 },  { { 109, 100 }, 2, 12 },
+  { { 109, 102 }, 2, 12 }, { { 109, 103 }, 2, 12 }, { { 109, 104 }, 2, 12 },
+  { { 109, 108 }, 2, 12 }, { { 109, 109 }, 2, 12 }, { { 109, 110 }, 2, 12 },
+  { { 109, 112 }, 2, 12 }, { { 109, 114 }, 2, 12 }, { { 109, 117 }, 2, 12 },
+  { { 109, 0 }, 1, 6 },    { { 109, 0 }, 1, 6 },    { { 109, 0 }, 1, 6 },
+  { { 109, 0 }, 1, 6 },    { { 109, 0 }, 1, 6 },    { { 109, 0 }, 1, 6 },
+  { { 109, 0 }, 1, 6 },    { { 109, 0 }, 1, 6 },    { { 109, 0 }, 1, 6 },
+  { { 109, 0 }, 1, 6 },    { { 109, 0 }, 1, 6 },    { { 109, 0 }, 1, 6 },
+  { { 109, 0 }, 1, 6 },    { { 109, 0 }, 1, 6 },    { { 109, 0 }, 1, 6 },
+  { { 109, 0 }, 1, 6 },    { { 109, 0 }, 1, 6 },    { { 109, 0 }, 1, 6 },
+  { { 110, 48 }, 2, 11 },  { { 110, 48 }, 2, 11 },  { { 110, 49 }, 2, 11 },
+  { { 110, 49 }, 2, 11 },  { { 110, 50 }, 2, 11 },  { { 110, 50 }, 2, 11 },
+  { { 110, 97 }, 2, 11 },  { { 110, 97 }, 2, 11 },  { { 110, 99 }, 2, 11 },
+  { { 110, 99 }, 2, 11 },  { { 110, 101 }, 2, 11 }, { { 110, 101 }, 2, 11 },
+  { { 110, 105 }, 2, 11 }, { { 110, 105 }, 2, 11 }, { { 110, 111 }, 2, 11 },
+  { { 110, 111 }, 2, 11 }, { { 110, 115 }, 2, 11 }, { { 110, 115 }, 2, 11 },
+  { { 110, 116 }, 2, 11 }, { { 110, 116 }, 2, 11 }, { { 110, 32 }, 2, 12 },
+  { { 110, 37 }, 2, 12 },  { { 110, 45 }, 2, 12 },  { { 110, 46 }, 2, 12 },
+  { { 110, 47 }, 2, 12 },  { { 110, 51 }, 2, 12 },  { { 110, 52 }, 2, 12 },
+  { { 110, 53 }, 2, 12 },  { { 110, 54 }, 2, 12 },  { { 110, 55 }, 2, 12 },
+  { { 110, 56 }, 2, 12 },  { { 110, 57 }, 2, 12 },  { { 110, 61 }, 2, 12 },
+  { { 110, 65 }, 2, 12 },  { { 110, 95 }, 2, 12 },  { { 110, 98 }, 2, 12 },
+  { { 110, 100 }, 2, 12 }, { { 110, 102 }, 2, 12 }, { { 110, 103 }, 2, 12 },
+  { { 110, 104 }, 2, 12 }, { { 110, 108 }, 2, 12 }, { { 110, 109 }, 2, 12 },
+  { { 110, 110 }, 2, 12 }, { { 110, 112 }, 2, 12 }, { { 110, 114 }, 2, 12 },
+  { { 110, 117 }, 2, 12 }, { { 110, 0 }, 1, 6 },    { { 110, 0 }, 1, 6 },
+  { { 110, 0 }, 1, 6 },    { { 110, 0 }, 1, 6 },    { { 110, 0 }, 1, 6 },
+  { { 110, 0 }, 1, 6 },    { { 110, 0 }, 1, 6 },    { { 110, 0 }, 1, 6 },
+  { { 110, 0 }, 1, 6 },    { { 110, 0 }, 1, 6 },    { { 110, 0 }, 1, 6 },
+  { { 110, 0 }, 1, 6 },    { { 110, 0 }, 1, 6 },    { { 110, 0 }, 1, 6 },
+  { { 110, 0 }, 1, 6 },    { { 110, 0 }, 1, 6 },    { { 110, 0 }, 1, 6 },
+  { { 110, 0 }, 1, 6 },    { { 112, 48 }, 2, 11 },  { { 112, 48 }, 2, 11 },
+  { { 112, 49 }, 2, 11 },  { { 112, 49 }, 2, 11 },  { { 112, 50 }, 2, 11 },
+  { { 112, 50 }, 2, 11 },  { { 112, 97 }, 2, 11 },  { { 112, 97 }, 2, 11 },
+  { { 112, 99 }, 2, 11 },  { { 112, 99 }, 2, 11 },  { { 112, 101 }, 2, 11 },
+  { { 112, 101 }, 2, 11 }, { { 112, 105 }, 2, 11 }, { { 112, 105 }, 2, 11 },
+  { { 112, 111 }, 2, 11 }, { { 112, 111 }, 2, 11 }, { { 112, 115 }, 2, 11 },
+  { { 112, 115 }, 2, 11 }, { { 112, 116 }, 2, 11 }, { { 112, 116 }, 2, 11 },
+  { { 112, 32 }, 2, 12 },  { { 112, 37 }, 2, 12 },  { { 112, 45 }, 2, 12 },
+  { { 112, 46 }, 2, 12 },  { { 112, 47 }, 2, 12 },  { { 112, 51 }, 2, 12 },
+  { { 112, 52 }, 2, 12 },  { { 112, 53 }, 2, 12 },  { { 112, 54 }, 2, 12 },
+  { { 112, 55 }, 2, 12 },  { { 112, 56 }, 2, 12 },  { { 112, 57 }, 2, 12 },
+  { { 112, 61 }, 2, 12 },  { { 112, 65 }, 2, 12 },  { { 112, 95 }, 2, 12 },
+  { { 112, 98 }, 2, 12 },  { { 112, 100 }, 2, 12 }, { { 112, 102 }, 2, 12 },
+  { { 112, 103 }, 2, 12 }, { { 112, 104 }, 2, 12 }, { { 112, 108 }, 2, 12 },
+  { { 112, 109 }, 2, 12 }, { { 112, 110 }, 2, 12 }, { { 112, 112 }, 2, 12 },
+  { { 112, 114 }, 2, 12 }, { { 112, 117 }, 2, 12 }, { { 112, 0 }, 1, 6 },
+  { { 112, 0 }, 1, 6 },    { { 112, 0 }, 1, 6 },    { { 112, 0 }, 1, 6 },
+  { { 112, 0 }, 1, 6 },    { { 112, 0 }, 1, 6 },    { { 112, 0 }, 1, 6 },
+  { { 112, 0 }, 1, 6 },    { { 112, 0 }, 1, 6 },    { { 112, 0 }, 1, 6 },
+  { { 112, 0 }, 1, 6 },    { { 112, 0 }, 1, 6 },    { { 112, 0 }, 1, 6 },
+  { { 112, 0 }, 1, 6 },    { { 112, 0 }, 1, 6 },    { { 112, 0 }, 1, 6 },
+  { { 112, 0 }, 1, 6 },    { { 112, 0 }, 1, 6 },    { { 114, 48 }, 2, 11 },
+  { { 114, 48 }, 2, 11 },  { { 114, 49 }, 2, 11 },  { { 114, 49 }, 2, 11 },
+  { { 114, 50 }, 2, 11 },  { { 114, 50 }, 2, 11 },  { { 114, 97 }, 2, 11 },
+  { { 114, 97 }, 2, 11 },  { { 114, 99 }, 2, 11 },  { { 114, 99 }, 2, 11 },
+  { { 114, 101 }, 2, 11 }, { { 114, 101 }, 2, 11 }, { { 114, 105 }, 2, 11 },
+  { { 114, 105 }, 2, 11 }, { { 114, 111 }, 2, 11 }, { { 114, 111 }, 2, 11 },
+  { { 114, 115 }, 2, 11 }, { { 114, 115 }, 2, 11 }, { { 114, 116 }, 2, 11 },
+  { { 114, 116 }, 2, 11 }, { { 114, 32 }, 2, 12 },  { { 114, 37 }, 2, 12 },
+  { { 114, 45 }, 2, 12 },  { { 114, 46 }, 2, 12 },  { { 114, 47 }, 2, 12 },
+  { { 114, 51 }, 2, 12 },  { { 114, 52 }, 2, 12 },  { { 114, 53 }, 2, 12 },
+  { { 114, 54 }, 2, 12 },  { { 114, 55 }, 2, 12 },  { { 114, 56 }, 2, 12 },
+  { { 114, 57 }, 2, 12 },  { { 114, 61 }, 2, 12 },  { { 114, 65 }, 2, 12 },
+  { { 114, 95 }, 2, 12 },  { { 114, 98 }, 2, 12 },  { { 114, 100 }, 2, 12 },
+  { { 114, 102 }, 2, 12 }, { { 114, 103 }, 2, 12 }, { { 114, 104 }, 2, 12 },
+  { { 114, 108 }, 2, 12 }, { { 114, 109 }, 2, 12 }, { { 114, 110 }, 2, 12 },
+  { { 114, 112 }, 2, 12 }, { { 114, 114 }, 2, 12 }, { { 114, 117 }, 2, 12 },
+  { { 114, 0 }, 1, 6 },    { { 114, 0 }, 1, 6 },    { { 114, 0 }, 1, 6 },
+  { { 114, 0 }, 1, 6 },    { { 114, 0 }, 1, 6 },    { { 114, 0 }, 1, 6 },
+  { { 114, 0 }, 1, 6 },    { { 114, 0 }, 1, 6 },    { { 114, 0 }, 1, 6 },
+  { { 114, 0 }, 1, 6 },    { { 114, 0 }, 1, 6 },    { { 114, 0 }, 1, 6 },
+  { { 114, 0 }, 1, 6 },    { { 114, 0 }, 1, 6 },    { { 114, 0 }, 1, 6 },
+  { { 114, 0 }, 1, 6 },    { { 114, 0 }, 1, 6 },    { { 114, 0 }, 1, 6 },
+  { { 117, 48 }, 2, 11 },  { { 117, 48 }, 2, 11 },  { { 117, 49 }, 2, 11 },
+  { { 117, 49 }, 2, 11 },  { { 117, 50 }, 2, 11 },  { { 117, 50 }, 2, 11 },
+  { { 117, 97 }, 2, 11 },  { { 117, 97 }, 2, 11 },  { { 117, 99 }, 2, 11 },
+  { { 117, 99 }, 2, 11 },  { { 117, 101 }, 2, 11 }, { { 117, 101 }, 2, 11 },
+  { { 117, 105 }, 2, 11 }, { { 117, 105 }, 2, 11 }, { { 117, 111 }, 2, 11 },
+  { { 117, 111 }, 2, 11 }, { { 117, 115 }, 2, 11 }, { { 117, 115 }, 2, 11 },
+  { { 117, 116 }, 2, 11 }, { { 117, 116 }, 2, 11 }, { { 117, 32 }, 2, 12 },
+  { { 117, 37 }, 2, 12 },  { { 117, 45 }, 2, 12 },  { { 117, 46 }, 2, 12 },
+  { { 117, 47 }, 2, 12 },  { { 117, 51 }, 2, 12 },  { { 117, 52 }, 2, 12 },
+  { { 117, 53 }, 2, 12 },  { { 117, 54 }, 2, 12 },  { { 117, 55 }, 2, 12 },
+  { { 117, 56 }, 2, 12 },  { { 117, 57 }, 2, 12 },  { { 117, 61 }, 2, 12 },
+  { { 117, 65 }, 2, 12 },  { { 117, 95 }, 2, 12 },  { { 117, 98 }, 2, 12 },
+  { { 117, 100 }, 2, 12 }, { { 117, 102 }, 2, 12 }, { { 117, 103 }, 2, 12 },
+  { { 117, 104 }, 2, 12 }, { { 117, 108 }, 2, 12 }, { { 117, 109 }, 2, 12 },
+  { { 117, 110 }, 2, 12 }, { { 117, 112 }, 2, 12 }, { { 117, 114 }, 2, 12 },
+  { { 117, 117 }, 2, 12 }, { { 117, 0 }, 1, 6 },    { { 117, 0 }, 1, 6 },
+  { { 117, 0 }, 1, 6 },    { { 117, 0 }, 1, 6 },    { { 117, 0 }, 1, 6 },
+  { { 117, 0 }, 1, 6 },    { { 117, 0 }, 1, 6 },    { { 117, 0 }, 1, 6 },
+  { { 117, 0 }, 1, 6 },    { { 117, 0 }, 1, 6 },    { { 117, 0 }, 1, 6 },
+  { { 117, 0 }, 1, 6 },    { { 117, 0 }, 1, 6 },    { { 117, 0 }, 1, 6 },
+  { { 117, 0 }, 1, 6 },    { { 117, 0 }, 1, 6 },    { { 117, 0 }, 1, 6 },
+  { { 117, 0 }, 1, 6 },    { { 58, 48 }, 2, 12 },   { { 58, 49 }, 2, 12 },
+  { { 58, 50 }, 2, 12 },   { { 58, 97 }, 2, 12 },   { { 58, 99 }, 2, 12 },
+  { { 58, 101 }, 2, 12 },  { { 58, 105 }, 2, 12 },  { { 58, 111 }, 2, 12 },
+  { { 58, 115 }, 2, 12 },  { { 58, 116 }, 2, 12 },  { { 58, 0 }, 1, 7 },
+  { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },
+  { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },
+  { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },
+  { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },
+  { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },
+  { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },
+  { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },     { { 58, 0 }, 1, 7 },
+  { { 66, 48 }, 2, 12 },   { { 66, 49 }, 2, 12 },   { { 66, 50 }, 2, 12 },
+  { { 66, 97 }, 2, 12 },   { { 66, 99 }, 2, 12 },   { { 66, 101 }, 2, 12 },
+  { { 66, 105 }, 2, 12 },  { { 66, 111 }, 2, 12 },  { { 66, 115 }, 2, 12 },
+  { { 66, 116 }, 2, 12 },  { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },
+  { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },
+  { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },
+  { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },
+  { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },
+  { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },
+  { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },
+  { { 66, 0 }, 1, 7 },     { { 66, 0 }, 1, 7 },     { { 67, 48 }, 2, 12 },
+  { { 67, 49 }, 2, 12 },   { { 67, 50 }, 2, 12 },   { { 67, 97 }, 2, 12 },
+  { { 67, 99 }, 2, 12 },   { { 67, 101 }, 2, 12 },  { { 67, 105 }, 2, 12 },
+  { { 67, 111 }, 2, 12 },  { { 67, 115 }, 2, 12 },  { { 67, 116 }, 2, 12 },
+  { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },
+  { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },
+  { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },
+  { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },
+  { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },
+  { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },
+  { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },     { { 67, 0 }, 1, 7 },
+  { { 67, 0 }, 1, 7 },     { { 68, 48 }, 2, 12 },   { { 68, 49 }, 2, 12 },
+  { { 68, 50 }, 2, 12 },   { { 68, 97 }, 2, 12 },   { { 68, 99 }, 2, 12 },
+  { { 68, 101 }, 2, 12 },  { { 68, 105 }, 2, 12 },  { { 68, 111 }, 2, 12 },
+  { { 68, 115 }, 2, 12 },  { { 68, 116 }, 2, 12 },  { { 68, 0 }, 1, 7 },
+  { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },
+  { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },
+  { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },
+  { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },
+  { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },
+  { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },
+  { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },     { { 68, 0 }, 1, 7 },
+  { { 69, 48 }, 2, 12 },   { { 69, 49 }, 2, 12 },   { { 69, 50 }, 2, 12 },
+  { { 69, 97 }, 2, 12 },   { { 69, 99 }, 2, 12 },   { { 69, 101 }, 2, 12 },
+  { { 69, 105 }, 2, 12 },  { { 69, 111 }, 2, 12 },  { { 69, 115 }, 2, 12 },
+  { { 69, 116 }, 2, 12 },  { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },
+  { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },
+  { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },
+  { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },
+  { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },
+  { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },
+  { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },
+  { { 69, 0 }, 1, 7 },     { { 69, 0 }, 1, 7 },     { { 70, 48 }, 2, 12 },
+  { { 70, 49 }, 2, 12 },   { { 70, 50 }, 2, 12 },   { { 70, 97 }, 2, 12 },
+  { { 70, 99 }, 2, 12 },   { { 70, 101 }, 2, 12 },  { { 70, 105 }, 2, 12 },
+  { { 70, 111 }, 2, 12 },  { { 70, 115 }, 2, 12 },  { { 70, 116 }, 2, 12 },
+  { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },
+  { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },
+  { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },
+  { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },
+  { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },
+  { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },
+  { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },     { { 70, 0 }, 1, 7 },
+  { { 70, 0 }, 1, 7 },     { { 71, 48 }, 2, 12 },   { { 71, 49 }, 2, 12 },
+  { { 71, 50 }, 2, 12 },   { { 71, 97 }, 2, 12 },   { { 71, 99 }, 2, 12 },
+  { { 71, 101 }, 2, 12 },  { { 71, 105 }, 2, 12 },  { { 71, 111 }, 2, 12 },
+  { { 71, 115 }, 2, 12 },  { { 71, 116 }, 2, 12 },  { { 71, 0 }, 1, 7 },
+  { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },
+  { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },
+  { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },
+  { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },
+  { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },
+  { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },
+  { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },     { { 71, 0 }, 1, 7 },
+  { { 72, 48 }, 2, 12 },   { { 72, 49 }, 2, 12 },   { { 72, 50 }, 2, 12 },
+  { { 72, 97 }, 2, 12 },   { { 72, 99 }, 2, 12 },   { { 72, 101 }, 2, 12 },
+  { { 72, 105 }, 2, 12 },  { { 72, 111 }, 2, 12 },  { { 72, 115 }, 2, 12 },
+  { { 72, 116 }, 2, 12 },  { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },
+  { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },
+  { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },
+  { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },
+  { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },
+  { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },
+  { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },
+  { { 72, 0 }, 1, 7 },     { { 72, 0 }, 1, 7 },     { { 73, 48 }, 2, 12 },
+  { { 73, 49 }, 2, 12 },   { { 73, 50 }, 2, 12 },   { { 73, 97 }, 2, 12 },
+  { { 73, 99 }, 2, 12 },   { { 73, 101 }, 2, 12 },  { { 73, 105 }, 2, 12 },
+  { { 73, 111 }, 2, 12 },  { { 73, 115 }, 2, 12 },  { { 73, 116 }, 2, 12 },
+  { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },
+  { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },
+  { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },
+  { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },
+  { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },
+  { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },
+  { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },     { { 73, 0 }, 1, 7 },
+  { { 73, 0 }, 1, 7 },     { { 74, 48 }, 2, 12 },   { { 74, 49 }, 2, 12 },
+  { { 74, 50 }, 2, 12 },   { { 74, 97 }, 2, 12 },   { { 74, 99 }, 2, 12 },
+  { { 74, 101 }, 2, 12 },  { { 74, 105 }, 2, 12 },  { { 74, 111 }, 2, 12 },
+  { { 74, 115 }, 2, 12 },  { { 74, 116 }, 2, 12 },  { { 74, 0 }, 1, 7 },
+  { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },
+  { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },
+  { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },
+  { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },
+  { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },
+  { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },
+  { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },     { { 74, 0 }, 1, 7 },
+  { { 75, 48 }, 2, 12 },   { { 75, 49 }, 2, 12 },   { { 75, 50 }, 2, 12 },
+  { { 75, 97 }, 2, 12 },   { { 75, 99 }, 2, 12 },   { { 75, 101 }, 2, 12 },
+  { { 75, 105 }, 2, 12 },  { { 75, 111 }, 2, 12 },  { { 75, 115 }, 2, 12 },
+  { { 75, 116 }, 2, 12 },  { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },
+  { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },
+  { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },
+  { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },
+  { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },
+  { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },
+  { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },
+  { { 75, 0 }, 1, 7 },     { { 75, 0 }, 1, 7 },     { { 76, 48 }, 2, 12 },
+  { { 76, 49 }, 2, 12 },   { { 76, 50 }, 2, 12 },   { { 76, 97 }, 2, 12 },
+  { { 76, 99 }, 2, 12 },   { { 76, 101 }, 2, 12 },  { { 76, 105 }, 2, 12 },
+  { { 76, 111 }, 2, 12 },  { { 76, 115 }, 2, 12 },  { { 76, 116 }, 2, 12 },
+  { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },
+  { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },
+  { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },
+  { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },
+  { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },
+  { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },
+  { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },     { { 76, 0 }, 1, 7 },
+  { { 76, 0 }, 1, 7 },     { { 77, 48 }, 2, 12 },   { { 77, 49 }, 2, 12 },
+  { { 77, 50 }, 2, 12 },   { { 77, 97 }, 2, 12 },   { { 77, 99 }, 2, 12 },
+  { { 77, 101 }, 2, 12 },  { { 77, 105 }, 2, 12 },  { { 77, 111 }, 2, 12 },
+  { { 77, 115 }, 2, 12 },  { { 77, 116 }, 2, 12 },  { { 77, 0 }, 1, 7 },
+  { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },
+  { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },
+  { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },
+  { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },
+  { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },
+  { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },
+  { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },     { { 77, 0 }, 1, 7 },
+  { { 78, 48 }, 2, 12 },   { { 78, 49 }, 2, 12 },   { { 78, 50 }, 2, 12 },
+  { { 78, 97 }, 2, 12 },   { { 78, 99 }, 2, 12 },   { { 78, 101 }, 2, 12 },
+  { { 78, 105 }, 2, 12 },  { { 78, 111 }, 2, 12 },  { { 78, 115 }, 2, 12 },
+  { { 78, 116 }, 2, 12 },  { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },
+  { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },
+  { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },
+  { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },
+  { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },
+  { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },
+  { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },
+  { { 78, 0 }, 1, 7 },     { { 78, 0 }, 1, 7 },     { { 79, 48 }, 2, 12 },
+  { { 79, 49 }, 2, 12 },   { { 79, 50 }, 2, 12 },   { { 79, 97 }, 2, 12 },
+  { { 79, 99 }, 2, 12 },   { { 79, 101 }, 2, 12 },  { { 79, 105 }, 2, 12 },
+  { { 79, 111 }, 2, 12 },  { { 79, 115 }, 2, 12 },  { { 79, 116 }, 2, 12 },
+  { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },
+  { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },
+  { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },
+  { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },
+  { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },
+  { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },
+  { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },     { { 79, 0 }, 1, 7 },
+  { { 79, 0 }, 1, 7 },     { { 80, 48 }, 2, 12 },   { { 80, 49 }, 2, 12 },
+  { { 80, 50 }, 2, 12 },   { { 80, 97 }, 2, 12 },   { { 80, 99 }, 2, 12 },
+  { { 80, 101 }, 2, 12 },  { { 80, 105 }, 2, 12 },  { { 80, 111 }, 2, 12 },
+  { { 80, 115 }, 2, 12 },  { { 80, 116 }, 2, 12 },  { { 80, 0 }, 1, 7 },
+  { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },
+  { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },
+  { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },
+  { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },
+  { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },
+  { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },
+  { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },     { { 80, 0 }, 1, 7 },
+  { { 81, 48 }, 2, 12 },   { { 81, 49 }, 2, 12 },   { { 81, 50 }, 2, 12 },
+  { { 81, 97 }, 2, 12 },   { { 81, 99 }, 2, 12 },   { { 81, 101 }, 2, 12 },
+  { { 81, 105 }, 2, 12 },  { { 81, 111 }, 2, 12 },  { { 81, 115 }, 2, 12 },
+  { { 81, 116 }, 2, 12 },  { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },
+  { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },
+  { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },
+  { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },
+  { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },
+  { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },
+  { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },
+  { { 81, 0 }, 1, 7 },     { { 81, 0 }, 1, 7 },     { { 82, 48 }, 2, 12 },
+  { { 82, 49 }, 2, 12 },   { { 82, 50 }, 2, 12 },   { { 82, 97 }, 2, 12 },
+  { { 82, 99 }, 2, 12 },   { { 82, 101 }, 2, 12 },  { { 82, 105 }, 2, 12 },
+  { { 82, 111 }, 2, 12 },  { { 82, 115 }, 2, 12 },  { { 82, 116 }, 2, 12 },
+  { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },
+  { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },
+  { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },
+  { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },
+  { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },
+  { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },
+  { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },     { { 82, 0 }, 1, 7 },
+  { { 82, 0 }, 1, 7 },     { { 83, 48 }, 2, 12 },   { { 83, 49 }, 2, 12 },
+  { { 83, 50 }, 2, 12 },   { { 83, 97 }, 2, 12 },   { { 83, 99 }, 2, 12 },
+  { { 83, 101 }, 2, 12 },  { { 83, 105 }, 2, 12 },  { { 83, 111 }, 2, 12 },
+  { { 83, 115 }, 2, 12 },  { { 83, 116 }, 2, 12 },  { { 83, 0 }, 1, 7 },
+  { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },
+  { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },
+  { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },
+  { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },
+  { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },
+  { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },
+  { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },     { { 83, 0 }, 1, 7 },
+  { { 84, 48 }, 2, 12 },   { { 84, 49 }, 2, 12 },   { { 84, 50 }, 2, 12 },
+  { { 84, 97 }, 2, 12 },   { { 84, 99 }, 2, 12 },   { { 84, 101 }, 2, 12 },
+  { { 84, 105 }, 2, 12 },  { { 84, 111 }, 2, 12 },  { { 84, 115 }, 2, 12 },
+  { { 84, 116 }, 2, 12 },  { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },
+  { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },
+  { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },
+  { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },
+  { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },
+  { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },
+  { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },
+  { { 84, 0 }, 1, 7 },     { { 84, 0 }, 1, 7 },     { { 85, 48 }, 2, 12 },
+  { { 85, 49 }, 2, 12 },   { { 85, 50 }, 2, 12 },   { { 85, 97 }, 2, 12 },
+  { { 85, 99 }, 2, 12 },   { { 85, 101 }, 2, 12 },  { { 85, 105 }, 2, 12 },
+  { { 85, 111 }, 2, 12 },  { { 85, 115 }, 2, 12 },  { { 85, 116 }, 2, 12 },
+  { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },
+  { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },
+  { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },
+  { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },
+  { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },
+  { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },
+  { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },     { { 85, 0 }, 1, 7 },
+  { { 85, 0 }, 1, 7 },     { { 86, 48 }, 2, 12 },   { { 86, 49 }, 2, 12 },
+  { { 86, 50 }, 2, 12 },   { { 86, 97 }, 2, 12 },   { { 86, 99 }, 2, 12 },
+  { { 86, 101 }, 2, 12 },  { { 86, 105 }, 2, 12 },  { { 86, 111 }, 2, 12 },
+  { { 86, 115 }, 2, 12 },  { { 86, 116 }, 2, 12 },  { { 86, 0 }, 1, 7 },
+  { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },
+  { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },
+  { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },
+  { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },
+  { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },
+  { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },
+  { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },     { { 86, 0 }, 1, 7 },
+  { { 87, 48 }, 2, 12 },   { { 87, 49 }, 2, 12 },   { { 87, 50 }, 2, 12 },
+  { { 87, 97 }, 2, 12 },   { { 87, 99 }, 2, 12 },   { { 87, 101 }, 2, 12 },
+  { { 87, 105 }, 2, 12 },  { { 87, 111 }, 2, 12 },  { { 87, 115 }, 2, 12 },
+  { { 87, 116 }, 2, 12 },  { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },
+  { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },
+  { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },
+  { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },
+  { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },
+  { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },
+  { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },
+  { { 87, 0 }, 1, 7 },     { { 87, 0 }, 1, 7 },     { { 89, 48 }, 2, 12 },
+  { { 89, 49 }, 2, 12 },   { { 89, 50 }, 2, 12 },   { { 89, 97 }, 2, 12 },
+  { { 89, 99 }, 2, 12 },   { { 89, 101 }, 2, 12 },  { { 89, 105 }, 2, 12 },
+  { { 89, 111 }, 2, 12 },  { { 89, 115 }, 2, 12 },  { { 89, 116 }, 2, 12 },
+  { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },
+  { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },
+  { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },
+  { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },
+  { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },
+  { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },
+  { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },     { { 89, 0 }, 1, 7 },
+  { { 89, 0 }, 1, 7 },     { { 106, 48 }, 2, 12 },  { { 106, 49 }, 2, 12 },
+  { { 106, 50 }, 2, 12 },  { { 106, 97 }, 2, 12 },  { { 106, 99 }, 2, 12 },
+  { { 106, 101 }, 2, 12 }, { { 106, 105 }, 2, 12 }, { { 106, 111 }, 2, 12 },
+  { { 106, 115 }, 2, 12 }, { { 106, 116 }, 2, 12 }, { { 106, 0 }, 1, 7 },
+  { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },
+  { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },
+  { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },
+  { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },
+  { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },
+  { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },
+  { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },    { { 106, 0 }, 1, 7 },
+  { { 107, 48 }, 2, 12 },  { { 107, 49 }, 2, 12 },  { { 107, 50 }, 2, 12 },
+  { { 107, 97 }, 2, 12 },  { { 107, 99 }, 2, 12 },  { { 107, 101 }, 2, 12 },
+  { { 107, 105 }, 2, 12 }, { { 107, 111 }, 2, 12 }, { { 107, 115 }, 2, 12 },
+  { { 107, 116 }, 2, 12 }, { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },
+  { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },
+  { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },
+  { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },
+  { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },
+  { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },
+  { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },
+  { { 107, 0 }, 1, 7 },    { { 107, 0 }, 1, 7 },    { { 113, 48 }, 2, 12 },
+  { { 113, 49 }, 2, 12 },  { { 113, 50 }, 2, 12 },  { { 113, 97 }, 2, 12 },
+  { { 113, 99 }, 2, 12 },  { { 113, 101 }, 2, 12 }, { { 113, 105 }, 2, 12 },
+  { { 113, 111 }, 2, 12 }, { { 113, 115 }, 2, 12 }, { { 113, 116 }, 2, 12 },
+  { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },
+  { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },
+  { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },
+  { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },
+  { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },
+  { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },
+  { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },    { { 113, 0 }, 1, 7 },
+  { { 113, 0 }, 1, 7 },    { { 118, 48 }, 2, 12 },  { { 118, 49 }, 2, 12 },
+  { { 118, 50 }, 2, 12 },  { { 118, 97 }, 2, 12 },  { { 118, 99 }, 2, 12 },
+  { { 118, 101 }, 2, 12 }, { { 118, 105 }, 2, 12 }, { { 118, 111 }, 2, 12 },
+  { { 118, 115 }, 2, 12 }, { { 118, 116 }, 2, 12 }, { { 118, 0 }, 1, 7 },
+  { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },
+  { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },
+  { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },
+  { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },
+  { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },
+  { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },
+  { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },    { { 118, 0 }, 1, 7 },
+  { { 119, 48 }, 2, 12 },  { { 119, 49 }, 2, 12 },  { { 119, 50 }, 2, 12 },
+  { { 119, 97 }, 2, 12 },  { { 119, 99 }, 2, 12 },  { { 119, 101 }, 2, 12 },
+  { { 119, 105 }, 2, 12 }, { { 119, 111 }, 2, 12 }, { { 119, 115 }, 2, 12 },
+  { { 119, 116 }, 2, 12 }, { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },
+  { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },
+  { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },
+  { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },
+  { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },
+  { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },
+  { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },
+  { { 119, 0 }, 1, 7 },    { { 119, 0 }, 1, 7 },    { { 120, 48 }, 2, 12 },
+  { { 120, 49 }, 2, 12 },  { { 120, 50 }, 2, 12 },  { { 120, 97 }, 2, 12 },
+  { { 120, 99 }, 2, 12 },  { { 120, 101 }, 2, 12 }, { { 120, 105 }, 2, 12 },
+  { { 120, 111 }, 2, 12 }, { { 120, 115 }, 2, 12 }, { { 120, 116 }, 2, 12 },
+  { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },
+  { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },
+  { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },
+  { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },
+  { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },
+  { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },
+  { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },    { { 120, 0 }, 1, 7 },
+  { { 120, 0 }, 1, 7 },    { { 121, 48 }, 2, 12 },  { { 121, 49 }, 2, 12 },
+  { { 121, 50 }, 2, 12 },  { { 121, 97 }, 2, 12 },  { { 121, 99 }, 2, 12 },
+  { { 121, 101 }, 2, 12 }, { { 121, 105 }, 2, 12 }, { { 121, 111 }, 2, 12 },
+  { { 121, 115 }, 2, 12 }, { { 121, 116 }, 2, 12 }, { { 121, 0 }, 1, 7 },
+  { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },
+  { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },
+  { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },
+  { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },
+  { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },
+  { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },
+  { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },    { { 121, 0 }, 1, 7 },
+  { { 122, 48 }, 2, 12 },  { { 122, 49 }, 2, 12 },  { { 122, 50 }, 2, 12 },
+  { { 122, 97 }, 2, 12 },  { { 122, 99 }, 2, 12 },  { { 122, 101 }, 2, 12 },
+  { { 122, 105 }, 2, 12 }, { { 122, 111 }, 2, 12 }, { { 122, 115 }, 2, 12 },
+  { { 122, 116 }, 2, 12 }, { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },
+  { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },
+  { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },
+  { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },
+  { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },
+  { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },
+  { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },
+  { { 122, 0 }, 1, 7 },    { { 122, 0 }, 1, 7 },    { { 38, 0 }, 1, 8 },
+  { { 38, 0 }, 1, 8 },     { { 38, 0 }, 1, 8 },     { { 38, 0 }, 1, 8 },
+  { { 38, 0 }, 1, 8 },     { { 38, 0 }, 1, 8 },     { { 38, 0 }, 1, 8 },
+  { { 38, 0 }, 1, 8 },     { { 38, 0 }, 1, 8 },     { { 38, 0 }, 1, 8 },
+  { { 38, 0 }, 1, 8 },     { { 38, 0 }, 1, 8 },     { { 38, 0 }, 1, 8 },
+  { { 38, 0 }, 1, 8 },     { { 38, 0 }, 1, 8 },     { { 38, 0 }, 1, 8 },
+  { { 42, 0 }, 1, 8 },     { { 42, 0 }, 1, 8 },     { { 42, 0 }, 1, 8 },
+  { { 42, 0 }, 1, 8 },     { { 42, 0 }, 1, 8 },     { { 42, 0 }, 1, 8 },
+  { { 42, 0 }, 1, 8 },     { { 42, 0 }, 1, 8 },     { { 42, 0 }, 1, 8 },
+  { { 42, 0 }, 1, 8 },     { { 42, 0 }, 1, 8 },     { { 42, 0 }, 1, 8 },
+  { { 42, 0 }, 1, 8 },     { { 42, 0 }, 1, 8 },     { { 42, 0 }, 1, 8 },
+  { { 42, 0 }, 1, 8 },     { { 44, 0 }, 1, 8 },     { { 44, 0 }, 1, 8 },
+  { { 44, 0 }, 1, 8 },     { { 44, 0 }, 1, 8 },     { { 44, 0 }, 1, 8 },
+  { { 44, 0 }, 1, 8 },     { { 44, 0 }, 1, 8 },     { { 44, 0 }, 1, 8 },
+  { { 44, 0 }, 1, 8 },     { { 44, 0 }, 1, 8 },     { { 44, 0 }, 1, 8 },
+  { { 44, 0 }, 1, 8 },     { { 44, 0 }, 1, 8 },     { { 44, 0 }, 1, 8 },
+  { { 44, 0 }, 1, 8 },     { { 44, 0 }, 1, 8 },     { { 59, 0 }, 1, 8 },
+  { { 59, 0 }, 1, 8 },     { { 59, 0 }, 1, 8 },     { { 59, 0 }, 1, 8 },
+  { { 59, 0 }, 1, 8 },     { { 59, 0 }, 1, 8 },     { { 59, 0 }, 1, 8 },
+  { { 59, 0 }, 1, 8 },     { { 59, 0 }, 1, 8 },     { { 59, 0 }, 1, 8 },
+  { { 59, 0 }, 1, 8 },     { { 59, 0 }, 1, 8 },     { { 59, 0 }, 1, 8 },
+  { { 59, 0 }, 1, 8 },     { { 59, 0 }, 1, 8 },     { { 59, 0 }, 1, 8 },
+  { { 88, 0 }, 1, 8 },     { { 88, 0 }, 1, 8 },     { { 88, 0 }, 1, 8 },
+  { { 88, 0 }, 1, 8 },     { { 88, 0 }, 1, 8 },     { { 88, 0 }, 1, 8 },
+  { { 88, 0 }, 1, 8 },     { { 88, 0 }, 1, 8 },     { { 88, 0 }, 1, 8 },
+  { { 88, 0 }, 1, 8 },     { { 88, 0 }, 1, 8 },     { { 88, 0 }, 1, 8 },
+  { { 88, 0 }, 1, 8 },     { { 88, 0 }, 1, 8 },     { { 88, 0 }, 1, 8 },
+  { { 88, 0 }, 1, 8 },     { { 90, 0 }, 1, 8 },     { { 90, 0 }, 1, 8 },
+  { { 90, 0 }, 1, 8 },     { { 90, 0 }, 1, 8 },     { { 90, 0 }, 1, 8 },
+  { { 90, 0 }, 1, 8 },     { { 90, 0 }, 1, 8 },     { { 90, 0 }, 1, 8 },
+  { { 90, 0 }, 1, 8 },     { { 90, 0 }, 1, 8 },     { { 90, 0 }, 1, 8 },
+  { { 90, 0 }, 1, 8 },     { { 90, 0 }, 1, 8 },     { { 90, 0 }, 1, 8 },
+  { { 90, 0 }, 1, 8 },     { { 90, 0 }, 1, 8 },     { { 33, 0 }, 1, 10 },
+  { { 33, 0 }, 1, 10 },    { { 33, 0 }, 1, 10 },    { { 33, 0 }, 1, 10 },
+  { { 34, 0 }, 1, 10 },    { { 34, 0 }, 1, 10 },    { { 34, 0 }, 1, 10 },
+  { { 34, 0 }, 1, 10 },    { { 40, 0 }, 1, 10 },    { { 40, 0 }, 1, 10 },
+  { { 40, 0 }, 1, 10 },    { { 40, 0 }, 1, 10 },    { { 41, 0 }, 1, 10 },
+  { { 41, 0 }, 1, 10 },    { { 41, 0 }, 1, 10 },    { { 41, 0 }, 1, 10 },
+  { { 63, 0 }, 1, 10 },    { { 63, 0 }, 1, 10 },    { { 63, 0 }, 1, 10 },
+  { { 63, 0 }, 1, 10 },    { { 39, 0 }, 1, 11 },    { { 39, 0 }, 1, 11 },
+  { { 43, 0 }, 1, 11 },    { { 43, 0 }, 1, 11 },    { { 124, 0 }, 1, 11 },
+  { { 124, 0 }, 1, 11 },   { { 35, 0 }, 1, 12 },    { { 62, 0 }, 1, 12 },
+  { { 0, 0 }, 0, 0 },      { { 0, 0 }, 0, 0 },      { { 0, 0 }, 0, 0 },
+  { { 0, 0 }, 0, 0 }
+};
+
+// Codes of each length, indexed by code length.
+struct canonical {
+  uint32_t first;
+  uint16_t count;
+  // Index of the symbol of `first` in `symbols`.
+  uint16_t offset;
+};
+
+const canonical codes[] = {
+  { 0x0u, 0, 0 },          { 0x0u, 0, 0 },          { 0x0u, 0, 0 },
+  { 0x0u, 0, 0 },          { 0x0u, 0, 0 },          { 0x0u, 10, 0 },
+  { 0x14u, 26, 10 },       { 0x5cu, 32, 36 },       { 0xf8u, 6, 68 },
+  { 0x0u, 0, 74 },         { 0x3f8u, 5, 74 },       { 0x7fau, 3, 79 },
+  { 0xffau, 2, 82 },       { 0x1ff8u, 6, 84 },      { 0x3ffcu, 2, 90 },
+  { 0x7ffcu, 3, 92 },      { 0x0u, 0, 95 },         { 0x0u, 0, 95 },
+  { 0x0u, 0, 95 },         { 0x7fff0u, 3, 95 },     { 0xfffe6u, 8, 98 },
+  { 0x1fffdcu, 13, 106 },  { 0x3fffd2u, 26, 119 },  { 0x7fffd8u, 29, 145 },
+  { 0xffffeau, 12, 174 },  { 0x1ffffecu, 4, 186 },  { 0x3ffffe0u, 15, 190 },
+  { 0x7ffffdeu, 19, 205 }, { 0xfffffe2u, 29, 224 }, { 0x0u, 0, 253 },
+  { 0x3ffffffcu, 4, 253 }
+};
+
+// Symbols sorted by code.
+const uint16_t symbols[] = {
+  48,  49,  50,  97,  99,  101, 105, 111, 115, 116, 32,  37,  45,  46,  47,
+  51,  52,  53,  54,  55,  56,  57,  61,  65,  95,  98,  100, 102, 103, 104,
+  108, 109, 110, 112, 114, 117, 58,  66,  67,  68,  69,  70,  71,  72,  73,
+  74,  75,  76,  77,  78,  79,  80,  81,  82,  83,  84,  85,  86,  87,  89,
+  106, 107, 113, 118, 119, 120, 121, 122, 38,  42,  44,  59,  88,  90,  33,
+  34,  40,  41,  63,  39,  43,  124, 35,  62,  0,   36,  64,  91,  93,  126,
+  94,  125, 60,  96,  123, 92,  195, 208, 128, 130, 131, 162, 184, 194, 224,
+  226, 153, 161, 167, 172, 176, 177, 179, 209, 216, 217, 227, 229, 230, 129,
+  132, 133, 134, 136, 146, 154, 156, 160, 163, 164, 169, 170, 173, 178, 181,
+  185, 186, 187, 189, 190, 196, 198, 228, 232, 233, 1,   135, 137, 138, 139,
+  140, 141, 143, 147, 149, 150, 151, 152, 155, 157, 158, 165, 166, 168, 174,
+  175, 180, 182, 183, 188, 191, 197, 231, 239, 9,   142, 144, 145, 148, 159,
+  171, 206, 215, 225, 236, 237, 199, 207, 234, 235, 192, 193, 200, 201, 202,
+  205, 210, 213, 218, 219, 238, 240, 242, 243, 255, 203, 204, 211, 212, 214,
+  221, 222, 223, 241, 244, 245, 246, 247, 248, 250, 251, 252, 253, 254, 2,
+  3,   4,   5,   6,   7,   8,   11,  12,  14,  15,  16,  17,  18,  19,  20,
+  21,  23,  24,  25,  26,  27,  28,  29,  30,  31,  127, 220, 249, 10,  13,
+  22,  256
+};
+
+}
+}
+}
+}
+}
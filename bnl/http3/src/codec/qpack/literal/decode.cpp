@@ -1,10 +1,28 @@
 #include <bnl/http3/codec/qpack/literal.hpp>
 
+#include <algorithm>
+
 namespace bnl {
 namespace http3 {
 namespace qpack {
 namespace literal {
 
+template<typename Lookahead>
+static void
+copy(Lookahead &encoded, char *dest, size_t size)
+{
+  size_t copied = 0;
+  while (copied != size) {
+    base::buffer_view contiguous = encoded.contiguous();
+    size_t left = std::min(contiguous.size(), size - copied);
+
+    std::copy_n(contiguous.data(), left, dest + copied);
+
+    encoded.consume(left);
+    copied += left;
+  }
+}
+
 template<typename Sequence>
 result<base::string>
 decode(Sequence &encoded, uint8_t prefix)
@@ -32,12 +50,59 @@ decode(Sequence &encoded, uint8_t prefix)
     literal = BNL_TRY(huffman::decode(lookahead, bounded_encoded_size));
   } else {
     literal.resize(bounded_encoded_size);
+    copy(lookahead, &literal[0], bounded_encoded_size);
+  }
+
+  encoded.consume(lookahead.consumed());
+
+  return literal;
+}
+
+template<typename Sequence>
+result<base::string_view>
+decode(Sequence &encoded, uint8_t prefix, base::arena &arena)
+{
+  typename Sequence::lookahead_type lookahead(encoded);
+
+  if (lookahead.empty()) {
+    return error::incomplete;
+  }
+
+  bool is_huffman = static_cast<uint8_t>(*lookahead >> prefix) & 0x01; // NOLINT
+
+  uint64_t literal_encoded_size =
+    BNL_TRY(prefix_int::decode(lookahead, prefix));
+
+  if (literal_encoded_size > lookahead.size()) {
+    return error::incomplete;
+  }
+
+  size_t bounded_encoded_size = static_cast<size_t>(literal_encoded_size);
 
-    for (size_t i = 0; i < bounded_encoded_size; i++) {
-      literal[i] = static_cast<char>(lookahead[i]);
+  base::string_view literal;
+  base::buffer_view contiguous = lookahead.contiguous();
+
+  if (is_huffman) {
+    size_t max_size = huffman::decoded_max_size(bounded_encoded_size);
+    char *dest = arena.allocate(max_size);
+
+    result<size_t> r = huffman::decode(lookahead, bounded_encoded_size, dest);
+    if (!r) {
+      arena.shrink(max_size);
+      return r.error();
     }
 
+    arena.shrink(max_size - r.value());
+    literal = base::string_view(dest, r.value());
+  } else if (contiguous.size() >= bounded_encoded_size) {
+    literal =
+      base::string_view(reinterpret_cast<const char *>(contiguous.data()),
+                        bounded_encoded_size);
     lookahead.consume(bounded_encoded_size);
+  } else {
+    char *dest = arena.allocate(bounded_encoded_size);
+    copy(lookahead, dest, bounded_encoded_size);
+    literal = base::string_view(dest, bounded_encoded_size);
   }
 
   encoded.consume(lookahead.consumed());
@@ -47,6 +112,8 @@ decode(Sequence &encoded, uint8_t prefix)
 
 BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_QPACK_LITERAL_DECODE_IMPL);
 BNL_BASE_LOOKAHEAD_IMPL(BNL_HTTP3_QPACK_LITERAL_DECODE_IMPL);
+BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_QPACK_LITERAL_DECODE_VIEW_IMPL);
+BNL_BASE_LOOKAHEAD_IMPL(BNL_HTTP3_QPACK_LITERAL_DECODE_VIEW_IMPL);
 
 }
 }
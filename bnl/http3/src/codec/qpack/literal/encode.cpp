@@ -42,6 +42,51 @@ encode(uint8_t *dest, base::string_view literal, uint8_t prefix) noexcept
   return static_cast<size_t>(dest - begin);
 }
 
+size_t
+encode(base::buffer_builder &encoded,
+       base::string_view literal,
+       uint8_t prefix)
+{
+  // Huffman encoding is only used if it's shorter than the literal so the
+  // encoded literal is never larger than this.
+  size_t header_size = prefix_int::encoded_size(literal.size(), prefix);
+  uint8_t *dest = encoded.reserve(header_size + literal.size());
+
+  *dest = 0;
+
+  // Huffman encode right after the space reserved for the length of the
+  // unencoded literal. We stop and send the literal as is as soon as the
+  // huffman encoded literal stops being shorter than the literal.
+  size_t huffman_encoded_size =
+    literal.empty()
+      ? SIZE_MAX
+      : huffman::encode(dest + header_size, literal, literal.size() - 1);
+
+  size_t encoded_size = 0;
+
+  if (huffman_encoded_size == SIZE_MAX) {
+    encoded_size += prefix_int::encode(dest, literal.size(), prefix);
+    std::copy_n(literal.data(), literal.size(), dest + encoded_size);
+    encoded_size += literal.size();
+  } else {
+    *dest = static_cast<uint8_t>(1U << prefix);
+    encoded_size += prefix_int::encode(dest, huffman_encoded_size, prefix);
+
+    // The length of the huffman encoded literal might need fewer bytes than
+    // we reserved for it.
+    if (encoded_size < header_size) {
+      std::copy_n(dest + header_size, huffman_encoded_size,
+                  dest + encoded_size);
+    }
+
+    encoded_size += huffman_encoded_size;
+  }
+
+  encoded.advance(encoded_size);
+
+  return encoded_size;
+}
+
 base::buffer
 encode(base::string_view literal, uint8_t prefix)
 {
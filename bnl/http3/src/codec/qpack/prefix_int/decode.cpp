@@ -20,13 +20,61 @@ uint8_decode(Lookahead &encoded) noexcept
   return result;
 }
 
+// Decodes a prefix integer from contiguous memory. Returns false if `encoded`
+// ends before the integer does.
+static bool
+contiguous_decode(base::buffer_view encoded,
+                  uint8_t prefix,
+                  uint64_t &result,
+                  size_t &size) noexcept
+{
+  const uint8_t *begin = encoded.begin();
+  const uint8_t *end = encoded.end();
+  const uint8_t *current = begin;
+
+  if (current == end) {
+    return false;
+  }
+
+  uint8_t prefix_max = static_cast<uint8_t>((1U << prefix) - 1);
+  result = *current++ & prefix_max;
+
+  if (result >= prefix_max) {
+    uint64_t offset = 0;
+    uint8_t byte = 0;
+    do {
+      if (current == end) {
+        return false;
+      }
+
+      byte = *current++;
+      result += (byte & 127U) * (1U << offset);
+      offset += 7;
+    } while ((byte & 128U) == 128);
+  }
+
+  size = static_cast<size_t>(current - begin);
+
+  return true;
+}
+
 template<typename Sequence>
 result<uint64_t>
 decode(Sequence &encoded, uint8_t prefix) noexcept
 {
   typename Sequence::lookahead_type lookahead(encoded);
 
-  uint64_t result = BNL_TRY(uint8_decode(encoded));
+  {
+    uint64_t result = 0;
+    size_t size = 0;
+
+    if (contiguous_decode(lookahead.contiguous(), prefix, result, size)) {
+      encoded.consume(size);
+      return result;
+    }
+  }
+
+  uint64_t result = BNL_TRY(uint8_decode(lookahead));
 
   uint8_t prefix_max = static_cast<uint8_t>((1U << prefix) - 1);
   result &= prefix_max;
@@ -35,7 +83,7 @@ decode(Sequence &encoded, uint8_t prefix) noexcept
     uint64_t offset = 0;
     uint8_t byte = 0;
     do {
-      byte = BNL_TRY(uint8_decode(encoded));
+      byte = BNL_TRY(uint8_decode(lookahead));
       result += (byte & 127U) * (1U << offset);
       offset += 7;
     } while ((byte & 128U) == 128);
@@ -55,6 +55,19 @@ encode(uint8_t *dest, uint64_t value, uint8_t prefix) noexcept
   return static_cast<size_t>(dest - begin);
 }
 
+size_t
+encode(base::buffer_builder &encoded, uint64_t value, uint8_t prefix)
+{
+  size_t encoded_size = prefix_int::encoded_size(value, prefix);
+  uint8_t *dest = encoded.reserve(encoded_size);
+
+  *dest = 0;
+  encode(dest, value, prefix);
+  encoded.advance(encoded_size);
+
+  return encoded_size;
+}
+
 base::buffer
 encode(uint64_t value, uint8_t prefix)
 {
@@ -0,0 +1,242 @@
+#include <bnl/http3/codec/qpack/stream.hpp>
+
+#include <bnl/base/log.hpp>
+#include <bnl/http3/codec/qpack/literal.hpp>
+#include <bnl/http3/codec/qpack/prefix_int.hpp>
+
+#include <tuple>
+#include <utility>
+
+namespace bnl {
+namespace http3 {
+namespace qpack {
+namespace table {
+namespace fixed {
+
+// Defined in decode_generated.cpp.
+std::pair<bool, base::string_view>
+find_header_only(uint8_t index);
+
+}
+}
+
+namespace stream {
+
+static constexpr uint8_t INSERT_WITH_NAME_REFERENCE_PREFIX = 0x80;
+static constexpr uint8_t INSERT_WITH_NAME_REFERENCE_STATIC = 0x40;
+static constexpr uint8_t INSERT_WITHOUT_NAME_REFERENCE_PREFIX = 0x40;
+static constexpr uint8_t SET_DYNAMIC_TABLE_CAPACITY_PREFIX = 0x20;
+
+static constexpr uint8_t SECTION_ACKNOWLEDGMENT_PREFIX = 0x80;
+
+decoder::decoder(uint64_t capacity, uint64_t blocked_streams) noexcept
+  : capacity_(capacity)
+  , max_blocked_streams_(blocked_streams)
+{}
+
+const qpack::table::dynamic &
+decoder::table() const noexcept
+{
+  return table_;
+}
+
+uint64_t
+decoder::blocked_streams() const noexcept
+{
+  return blocked_.size();
+}
+
+result<uint64_t>
+decoder::unblocked() noexcept
+{
+  if (unblocked_.empty()) {
+    return error::idle;
+  }
+
+  uint64_t id = unblocked_.front();
+  unblocked_.pop_front();
+
+  return id;
+}
+
+result<base::buffer>
+decoder::encode() noexcept
+{
+  if (instructions_.empty()) {
+    return error::idle;
+  }
+
+  return instructions_.finish();
+}
+
+template<typename Sequence>
+result<void>
+decoder::decode(Sequence &encoded)
+{
+  while (!encoded.empty()) {
+    typename Sequence::lookahead_type lookahead(encoded);
+
+    result<void> r = instruction(lookahead);
+    if (!r) {
+      if (r.error() != error::incomplete) {
+        return r;
+      }
+
+      break;
+    }
+
+    encoded.consume(lookahead.consumed());
+  }
+
+  uint64_t inserted = table_.inserted();
+
+  if (inserted == known_received_count_) {
+    return base::success();
+  }
+
+  // Insert Count Increment (the instruction prefix is all zeros).
+  prefix_int::encode(instructions_, inserted - known_received_count_, 6);
+  known_received_count_ = inserted;
+
+  for (auto it = blocked_.begin(); it != blocked_.end();) {
+    if (it->second <= inserted) {
+      unblocked_.push_back(it->first);
+      it = blocked_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  return base::success();
+}
+
+// Returns the absolute index of the entry at `relative` which is relative to
+// the last inserted entry or `UINT64_MAX` if there's no such entry.
+static uint64_t
+absolute(const table::dynamic &table, uint64_t relative) noexcept
+{
+  if (relative >= table.inserted() ||
+      !table.contains(table.inserted() - 1 - relative)) {
+    return UINT64_MAX;
+  }
+
+  return table.inserted() - 1 - relative;
+}
+
+template<typename Lookahead>
+result<void>
+decoder::instruction(Lookahead &encoded)
+{
+  uint8_t byte = *encoded;
+  base::string name;
+
+  if ((byte & INSERT_WITH_NAME_REFERENCE_PREFIX) != 0) {
+    uint64_t index = BNL_TRY(prefix_int::decode(encoded, 6));
+
+    if ((byte & INSERT_WITH_NAME_REFERENCE_STATIC) != 0) {
+      bool found = false;
+      base::string_view entry;
+
+      if (index <= UINT8_MAX) {
+        std::tie(found, entry) =
+          table::fixed::find_header_only(static_cast<uint8_t>(index));
+      }
+
+      if (!found) {
+        BNL_LOG_E("Name reference ({}) not found in static table", index);
+        return error::qpack_encoder_stream_error;
+      }
+
+      name = base::string(entry.data(), entry.size());
+    } else {
+      uint64_t entry = absolute(table_, index);
+
+      if (entry == UINT64_MAX) {
+        BNL_LOG_E("Name reference ({}) not found in dynamic table", index);
+        return error::qpack_encoder_stream_error;
+      }
+
+      base::string_view found = table_.at(entry).name();
+      name = base::string(found.data(), found.size());
+    }
+  } else if ((byte & INSERT_WITHOUT_NAME_REFERENCE_PREFIX) != 0) {
+    name = BNL_TRY(literal::decode(encoded, 5));
+  } else if ((byte & SET_DYNAMIC_TABLE_CAPACITY_PREFIX) != 0) {
+    uint64_t capacity = BNL_TRY(prefix_int::decode(encoded, 5));
+
+    if (capacity > capacity_) {
+      BNL_LOG_E("Dynamic table capacity ({}) exceeds maximum ({})",
+                capacity,
+                capacity_);
+      return error::qpack_encoder_stream_error;
+    }
+
+    table_.capacity(capacity);
+
+    return base::success();
+  } else {
+    // Duplicate
+    uint64_t index = BNL_TRY(prefix_int::decode(encoded, 5));
+    uint64_t entry = absolute(table_, index);
+
+    if (entry == UINT64_MAX) {
+      BNL_LOG_E("Duplicated entry ({}) not found in dynamic table", index);
+      return error::qpack_encoder_stream_error;
+    }
+
+    header_view duplicate = table_.at(entry);
+
+    if (qpack::table::dynamic::entry_size(duplicate) > table_.capacity()) {
+      BNL_LOG_E("Duplicated entry ({}) is larger than the dynamic table",
+                duplicate);
+      return error::qpack_encoder_stream_error;
+    }
+
+    table_.insert(duplicate);
+
+    return base::success();
+  }
+
+  base::string value = BNL_TRY(literal::decode(encoded, 7));
+  header header(std::move(name), std::move(value));
+
+  if (qpack::table::dynamic::entry_size(header) > table_.capacity()) {
+    BNL_LOG_E("Inserted entry ({}) is larger than the dynamic table",
+              header_view(header));
+    return error::qpack_encoder_stream_error;
+  }
+
+  table_.insert(header);
+
+  return base::success();
+}
+
+result<void>
+decoder::block(uint64_t id, uint64_t required)
+{
+  if (blocked_.find(id) == blocked_.end() &&
+      blocked_.size() >= max_blocked_streams_) {
+    BNL_LOG_E("Header block of stream ({}) exceeds the blocked streams limit",
+              id);
+    return error::qpack_decompression_failed;
+  }
+
+  blocked_[id] = required;
+
+  return base::success();
+}
+
+void
+decoder::acknowledge(uint64_t id)
+{
+  size_t instruction = instructions_.size();
+  prefix_int::encode(instructions_, id, 7);
+  instructions_[instruction] |= SECTION_ACKNOWLEDGMENT_PREFIX;
+}
+
+BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_QPACK_STREAM_DECODER_DECODE_IMPL);
+
+}
+}
+}
+}
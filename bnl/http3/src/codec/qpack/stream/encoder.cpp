@@ -0,0 +1,273 @@
+#include <bnl/http3/codec/qpack/stream.hpp>
+
+#include <bnl/base/log.hpp>
+#include <bnl/http3/codec/qpack/literal.hpp>
+#include <bnl/http3/codec/qpack/prefix_int.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace bnl {
+namespace http3 {
+namespace qpack {
+namespace stream {
+
+static constexpr uint8_t SET_DYNAMIC_TABLE_CAPACITY_PREFIX = 0x20;
+static constexpr uint8_t INSERT_WITH_STATIC_NAME_REFERENCE_PREFIX = 0xc0;
+static constexpr uint8_t INSERT_WITH_DYNAMIC_NAME_REFERENCE_PREFIX = 0x80;
+static constexpr uint8_t INSERT_WITHOUT_NAME_REFERENCE_PREFIX = 0x40;
+
+static constexpr uint8_t SECTION_ACKNOWLEDGMENT_PREFIX = 0x80;
+static constexpr uint8_t STREAM_CANCELLATION_PREFIX = 0x40;
+
+encoder::encoder(uint64_t capacity) noexcept
+  : capacity_(capacity)
+{}
+
+const qpack::table::dynamic &
+encoder::table() const noexcept
+{
+  return table_;
+}
+
+uint64_t
+encoder::known_received_count() const noexcept
+{
+  return known_received_count_;
+}
+
+uint64_t
+encoder::blocked_streams() const noexcept
+{
+  return blocked_.size();
+}
+
+result<void>
+encoder::configure(const settings &peer)
+{
+  peer_ = peer;
+
+  uint64_t capacity = std::min(capacity_, peer.qpack_max_table_capacity);
+  if (capacity == 0) {
+    return base::success();
+  }
+
+  size_t instruction = instructions_.size();
+  prefix_int::encode(instructions_, capacity, 5);
+  instructions_[instruction] |= SET_DYNAMIC_TABLE_CAPACITY_PREFIX;
+
+  table_.capacity(capacity);
+
+  return base::success();
+}
+
+result<base::buffer>
+encoder::encode() noexcept
+{
+  if (instructions_.empty()) {
+    return error::idle;
+  }
+
+  return instructions_.finish();
+}
+
+template<typename Sequence>
+result<void>
+encoder::decode(Sequence &encoded)
+{
+  while (!encoded.empty()) {
+    typename Sequence::lookahead_type lookahead(encoded);
+
+    result<void> r = instruction(lookahead);
+    if (!r) {
+      return r.error() == error::incomplete ? base::success() : r;
+    }
+
+    encoded.consume(lookahead.consumed());
+  }
+
+  return base::success();
+}
+
+template<typename Lookahead>
+result<void>
+encoder::instruction(Lookahead &encoded)
+{
+  if ((*encoded & SECTION_ACKNOWLEDGMENT_PREFIX) != 0) {
+    uint64_t id = BNL_TRY(prefix_int::decode(encoded, 7));
+
+    auto match = blocks_.find(id);
+    if (match == blocks_.end() || match->second.front().open) {
+      BNL_LOG_E("Section acknowledgment for stream ({}) without an "
+                "unacknowledged header block",
+                id);
+      return error::qpack_decoder_stream_error;
+    }
+
+    std::deque<block> &blocks = match->second;
+
+    known_received_count_ =
+      std::max(known_received_count_, blocks.front().required);
+
+    blocks.pop_front();
+
+    if (blocks.empty()) {
+      blocks_.erase(match);
+    }
+
+    // If the acknowledged block had the largest Required Insert Count of its
+    // stream, the stream isn't blocked anymore since all of its other blocks
+    // are now covered by `known_received_count_`.
+    unblock();
+
+    return base::success();
+  }
+
+  if ((*encoded & STREAM_CANCELLATION_PREFIX) != 0) {
+    uint64_t id = BNL_TRY(prefix_int::decode(encoded, 6));
+    blocks_.erase(id);
+    blocked_.erase(id);
+    return base::success();
+  }
+
+  // Insert Count Increment
+  uint64_t increment = BNL_TRY(prefix_int::decode(encoded, 6));
+
+  if (increment == 0 ||
+      increment > table_.inserted() - known_received_count_) {
+    BNL_LOG_E("Invalid insert count increment ({})", increment);
+    return error::qpack_decoder_stream_error;
+  }
+
+  known_received_count_ += increment;
+
+  unblock();
+
+  return base::success();
+}
+
+void
+encoder::insert(const representation &representation, header_view header)
+{
+  using type = representation::type;
+
+  size_t instruction = instructions_.size();
+
+  switch (representation.insert) {
+
+    case type::static_name:
+      prefix_int::encode(instructions_, representation.insert_index, 6);
+      instructions_[instruction] |= INSERT_WITH_STATIC_NAME_REFERENCE_PREFIX;
+
+      literal::encode(instructions_, header.value(), 7);
+      break;
+
+    case type::dynamic_name: {
+      // Name references on the encoder stream are relative to the last
+      // inserted entry.
+      uint64_t relative = table_.inserted() - 1 - representation.insert_index;
+
+      prefix_int::encode(instructions_, relative, 6);
+      instructions_[instruction] |= INSERT_WITH_DYNAMIC_NAME_REFERENCE_PREFIX;
+
+      literal::encode(instructions_, header.value(), 7);
+      break;
+    }
+
+    case type::literal:
+      literal::encode(instructions_, header.name(), 5);
+      instructions_[instruction] |= INSERT_WITHOUT_NAME_REFERENCE_PREFIX;
+
+      literal::encode(instructions_, header.value(), 7);
+      break;
+
+    default:
+      assert(false);
+  }
+
+  table_.insert(header);
+}
+
+void
+encoder::reference(uint64_t id, uint64_t index)
+{
+  std::deque<block> &blocks = blocks_[id];
+
+  if (index >= known_received_count_) {
+    uint64_t &required = blocked_[id];
+    required = std::max(required, index + 1);
+  }
+
+  if (blocks.empty() || !blocks.back().open) {
+    blocks.push_back({ index + 1, index, true });
+    return;
+  }
+
+  block &block = blocks.back();
+  block.required = std::max(block.required, index + 1);
+  block.smallest = std::min(block.smallest, index);
+}
+
+void
+encoder::close(uint64_t id) noexcept
+{
+  auto match = blocks_.find(id);
+  if (match != blocks_.end()) {
+    match->second.back().open = false;
+  }
+}
+
+bool
+encoder::blocking(uint64_t id) const noexcept
+{
+  return blocked_.find(id) != blocked_.end();
+}
+
+void
+encoder::unblock() noexcept
+{
+  // Bounded by the peer's blocked streams limit.
+  for (auto it = blocked_.begin(); it != blocked_.end();) {
+    it = it->second > known_received_count_ ? std::next(it)
+                                            : blocked_.erase(it);
+  }
+}
+
+uint64_t
+encoder::evict(uint64_t size) const noexcept
+{
+  if (size > table_.capacity()) {
+    return UINT64_MAX;
+  }
+
+  // Entries can only be evicted once the peer has received them and they
+  // aren't referenced by any unacknowledged header blocks.
+  uint64_t evictable = known_received_count_;
+
+  for (const auto &entry : blocks_) {
+    for (const block &block : entry.second) {
+      evictable = std::min(evictable, block.smallest);
+    }
+  }
+
+  uint64_t available = table_.capacity() - table_.size();
+  uint64_t index = table_.dropped();
+
+  while (available < size) {
+    if (index >= evictable) {
+      return UINT64_MAX;
+    }
+
+    available += qpack::table::dynamic::entry_size(table_.at(index));
+    index++;
+  }
+
+  return index;
+}
+
+BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_QPACK_STREAM_ENCODER_DECODE_IMPL);
+
+}
+}
+}
+}
@@ -0,0 +1,94 @@
+#include <bnl/http3/codec/qpack/table.hpp>
+
+#include <cassert>
+
+namespace bnl {
+namespace http3 {
+namespace qpack {
+namespace table {
+
+uint64_t
+dynamic::entry_size(header_view header) noexcept
+{
+  return header.name().size() + header.value().size() + ENTRY_OVERHEAD;
+}
+
+uint64_t
+dynamic::capacity() const noexcept
+{
+  return capacity_;
+}
+
+uint64_t
+dynamic::size() const noexcept
+{
+  return size_;
+}
+
+uint64_t
+dynamic::inserted() const noexcept
+{
+  return dropped_ + entries_.size();
+}
+
+uint64_t
+dynamic::dropped() const noexcept
+{
+  return dropped_;
+}
+
+bool
+dynamic::contains(uint64_t index) const noexcept
+{
+  return index >= dropped_ && index < inserted();
+}
+
+header_view
+dynamic::at(uint64_t index) const noexcept
+{
+  assert(contains(index));
+  return entries_[static_cast<size_t>(index - dropped_)];
+}
+
+void
+dynamic::capacity(uint64_t capacity) noexcept
+{
+  capacity_ = capacity;
+
+  while (size_ > capacity_) {
+    evict();
+  }
+}
+
+void
+dynamic::insert(header_view header)
+{
+  uint64_t size = entry_size(header);
+  assert(size <= capacity_);
+
+  // Copy first since `header` might refer to an entry that's evicted.
+  base::string name(header.name().data(), header.name().size());
+  base::string value(header.value().data(), header.value().size());
+
+  while (size_ + size > capacity_) {
+    evict();
+  }
+
+  entries_.emplace_back(std::move(name), std::move(value));
+  size_ += size;
+}
+
+void
+dynamic::evict() noexcept
+{
+  assert(!entries_.empty());
+
+  size_ -= entry_size(entries_.front());
+  entries_.pop_front();
+  dropped_++;
+}
+
+}
+}
+}
+}
@@ -7,61 +7,104 @@ namespace varint {
 // All decode functions convert from network to host byte order and remove the
 // varint header (first two bits) before returning a value.
 
-template<typename Lookahead>
+// `Bytes` is either a pointer into contiguous memory or a lookahead.
+
+template<typename Bytes>
 static uint8_t
-uint8_decode(Lookahead &lookahead)
+uint8_decode(const Bytes &bytes)
 {
-  uint8_t result = lookahead[0] & 0x3fU;
-
-  lookahead.consume(sizeof(uint8_t));
-
-  return result;
+  return bytes[0] & 0x3fU;
 }
 
-template<typename Lookahead>
+template<typename Bytes>
 static uint16_t
-uint16_decode(Lookahead &lookahead)
+uint16_decode(const Bytes &bytes)
 {
   uint16_t result = static_cast<uint16_t>(
-    static_cast<uint16_t>(static_cast<uint16_t>(lookahead[0]) << 8U) |
-    static_cast<uint16_t>(static_cast<uint16_t>(lookahead[1]) << 0U));
-
-  lookahead.consume(sizeof(uint16_t));
+    static_cast<uint16_t>(static_cast<uint16_t>(bytes[0]) << 8U) |
+    static_cast<uint16_t>(static_cast<uint16_t>(bytes[1]) << 0U));
 
   return result & 0x3fffU;
 }
 
-template<typename Lookahead>
+template<typename Bytes>
 static uint32_t
-uint32_decode(Lookahead &lookahead)
+uint32_decode(const Bytes &bytes)
 {
+  uint32_t result = static_cast<uint32_t>(bytes[0]) << 24U |
+                    static_cast<uint32_t>(bytes[1]) << 16U |
+                    static_cast<uint32_t>(bytes[2]) << 8U |
+                    static_cast<uint32_t>(bytes[3]) << 0U;
 
-  uint32_t result = static_cast<uint32_t>(lookahead[0]) << 24U |
-                    static_cast<uint32_t>(lookahead[1]) << 16U |
-                    static_cast<uint32_t>(lookahead[2]) << 8U |
-                    static_cast<uint32_t>(lookahead[3]) << 0U;
+  return result & 0x3fffffffU;
+}
 
-  lookahead.consume(sizeof(uint32_t));
+template<typename Bytes>
+static uint64_t
+uint64_decode(const Bytes &bytes)
+{
+  uint64_t result = static_cast<uint64_t>(bytes[0]) << 56U |
+                    static_cast<uint64_t>(bytes[1]) << 48U |
+                    static_cast<uint64_t>(bytes[2]) << 40U |
+                    static_cast<uint64_t>(bytes[3]) << 32U |
+                    static_cast<uint64_t>(bytes[4]) << 24U |
+                    static_cast<uint64_t>(bytes[5]) << 16U |
+                    static_cast<uint64_t>(bytes[6]) << 8U |
+                    static_cast<uint64_t>(bytes[7]) << 0U;
 
-  return result & 0x3fffffffU;
+  return result & 0x3fffffffffffffffU;
 }
 
-template<typename Lookahead>
+template<typename Bytes>
 static uint64_t
-uint64_decode(Lookahead &lookahead)
+varint_decode(const Bytes &bytes, size_t varint_size)
 {
-  uint64_t result = static_cast<uint64_t>(lookahead[0]) << 56U |
-                    static_cast<uint64_t>(lookahead[1]) << 48U |
-                    static_cast<uint64_t>(lookahead[2]) << 40U |
-                    static_cast<uint64_t>(lookahead[3]) << 32U |
-                    static_cast<uint64_t>(lookahead[4]) << 24U |
-                    static_cast<uint64_t>(lookahead[5]) << 16U |
-                    static_cast<uint64_t>(lookahead[6]) << 8U |
-                    static_cast<uint64_t>(lookahead[7]) << 0U;
+  switch (varint_size) {
+    case sizeof(uint8_t):
+      return uint8_decode(bytes);
+    case sizeof(uint16_t):
+      return uint16_decode(bytes);
+    case sizeof(uint32_t):
+      return uint32_decode(bytes);
+    case sizeof(uint64_t):
+      return uint64_decode(bytes);
+    default:
+      assert(false);
+  }
 
-  lookahead.consume(sizeof(uint64_t));
+  return 0;
+}
 
-  return result & 0x3fffffffffffffffU;
+// Loads 8 bytes in network byte order. Compilers turn this into a single load
+// (and byte swap on little-endian machines).
+static uint64_t
+uint64_load(const uint8_t *bytes)
+{
+  return static_cast<uint64_t>(bytes[0]) << 56U |
+         static_cast<uint64_t>(bytes[1]) << 48U |
+         static_cast<uint64_t>(bytes[2]) << 40U |
+         static_cast<uint64_t>(bytes[3]) << 32U |
+         static_cast<uint64_t>(bytes[4]) << 24U |
+         static_cast<uint64_t>(bytes[5]) << 16U |
+         static_cast<uint64_t>(bytes[6]) << 8U |
+         static_cast<uint64_t>(bytes[7]) << 0U;
+}
+
+// Shift and mask that extract a varint from the 8 bytes starting at the
+// varint, indexed by the varint header.
+static constexpr uint8_t WORD_SHIFT[] = { 56, 48, 32, 0 };
+static constexpr uint64_t WORD_MASK[] = { 0x3fU,
+                                          0x3fffU,
+                                          0x3fffffffU,
+                                          0x3fffffffffffffffU };
+
+// Decodes a varint without branching on its size. At least 8 bytes have to be
+// readable at `bytes`.
+static uint64_t
+varint_decode_word(const uint8_t *bytes)
+{
+  uint8_t header = static_cast<uint8_t>(bytes[0] >> 6U);
+  return uint64_load(bytes) >> WORD_SHIFT[header] & WORD_MASK[header];
 }
 
 template<typename Sequence>
@@ -84,30 +127,55 @@ decode(Sequence &encoded) noexcept
     return error::incomplete;
   }
 
-  uint64_t varint = 0;
+  base::buffer_view contiguous = lookahead.contiguous();
 
-  switch (varint_size) {
-    case sizeof(uint8_t):
-      varint = uint8_decode(lookahead);
-      break;
-    case sizeof(uint16_t):
-      varint = uint16_decode(lookahead);
-      break;
-    case sizeof(uint32_t):
-      varint = uint32_decode(lookahead);
-      break;
-    case sizeof(uint64_t):
-      varint = uint64_decode(lookahead);
-      break;
-    default:
-      assert(false);
-  }
+  // Only varints that span multiple buffers have to be decoded through the
+  // lookahead.
+  uint64_t varint =
+    contiguous.size() >= sizeof(uint64_t)
+      ? varint_decode_word(contiguous.data())
+      : contiguous.size() >= varint_size
+          ? varint_decode(contiguous.data(), varint_size)
+          : varint_decode(lookahead, varint_size);
+
+  lookahead.consume(varint_size);
 
   encoded.consume(lookahead.consumed());
 
   return varint;
 }
 
+result<size_t>
+decode(base::buffer_view encoded, uint64_t *dest, size_t count) noexcept
+{
+  assert(dest != nullptr);
+
+  const uint8_t *bytes = encoded.data();
+  size_t size = encoded.size();
+  size_t offset = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    if (offset == size) {
+      return error::incomplete;
+    }
+
+    size_t varint_size = static_cast<size_t>(1U) << (bytes[offset] >> 6U);
+
+    // Only the last few varints have to be decoded byte by byte.
+    if (size - offset >= sizeof(uint64_t)) {
+      dest[i] = varint_decode_word(bytes + offset);
+    } else if (size - offset >= varint_size) {
+      dest[i] = varint_decode(bytes + offset, varint_size);
+    } else {
+      return error::incomplete;
+    }
+
+    offset += varint_size;
+  }
+
+  return offset;
+}
+
 BNL_BASE_SEQUENCE_IMPL(BNL_HTTP3_VARINT_DECODE_IMPL);
 BNL_BASE_LOOKAHEAD_IMPL(BNL_HTTP3_VARINT_DECODE_IMPL);
 
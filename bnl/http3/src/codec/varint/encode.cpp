@@ -104,6 +104,107 @@ encode(uint8_t *dest, uint64_t varint) noexcept
   return varint_size;
 }
 
+// Stores 8 bytes in network byte order. Compilers turn this into a single
+// store (and byte swap on little-endian machines).
+static void
+uint64_store(uint8_t *dest, uint64_t word)
+{
+  dest[0] = static_cast<uint8_t>(word >> 56U);
+  dest[1] = static_cast<uint8_t>(word >> 48U);
+  dest[2] = static_cast<uint8_t>(word >> 40U);
+  dest[3] = static_cast<uint8_t>(word >> 32U);
+  dest[4] = static_cast<uint8_t>(word >> 24U);
+  dest[5] = static_cast<uint8_t>(word >> 16U);
+  dest[6] = static_cast<uint8_t>(word >> 8U);
+  dest[7] = static_cast<uint8_t>(word >> 0U);
+}
+
+// Shift that moves a varint to the front of an 8 byte word, indexed by the
+// varint header.
+static constexpr uint8_t WORD_SHIFT[] = { 56, 48, 32, 0 };
+
+// Encodes a varint without branching on its size. All 8 bytes at `dest` are
+// written so there has to be room for them even if the varint is smaller. The
+// varint shouldn't exceed `varint::max`.
+static size_t
+varint_encode_word(uint8_t *dest, uint64_t varint)
+{
+  uint8_t header = static_cast<uint8_t>(
+    static_cast<uint8_t>(varint >= 0x40U) +
+    static_cast<uint8_t>(varint >= (0x40U << 8U)) +
+    static_cast<uint8_t>(varint >= (0x40U << 24U)));
+
+  uint64_store(dest,
+               varint << WORD_SHIFT[header] |
+                 static_cast<uint64_t>(header) << 62U);
+
+  return static_cast<size_t>(1U) << header;
+}
+
+result<size_t>
+encode(base::buffer_builder &encoded, uint64_t varint)
+{
+  if (varint > varint::max) {
+    return error::varint_overflow;
+  }
+
+  size_t encoded_size = varint_encode_word(encoded.reserve(sizeof(uint64_t)),
+                                           varint);
+  encoded.advance(encoded_size);
+
+  return encoded_size;
+}
+
+result<size_t>
+encoded_size(const uint64_t *varints, size_t count) noexcept
+{
+  size_t encoded_size = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    encoded_size += BNL_TRY(varint::encoded_size(varints[i]));
+  }
+
+  return encoded_size;
+}
+
+result<size_t>
+encode(uint8_t *dest, const uint64_t *varints, size_t count) noexcept
+{
+  assert(dest != nullptr);
+
+  size_t encoded_size = BNL_TRY(varint::encoded_size(varints, count));
+  uint8_t *end = dest + encoded_size;
+
+  for (size_t i = 0; i < count; i++) {
+    // Only the last few varints have to be encoded without overwriting the
+    // bytes after them.
+    if (end - dest >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+      dest += varint_encode_word(dest, varints[i]);
+    } else {
+      dest += BNL_TRY(encode(dest, varints[i]));
+    }
+  }
+
+  return encoded_size;
+}
+
+result<size_t>
+encode(base::buffer_builder &encoded, const uint64_t *varints, size_t count)
+{
+  size_t encoded_size = BNL_TRY(varint::encoded_size(varints, count));
+
+  // Reserve room for overwriting 8 bytes when encoding the last varint.
+  uint8_t *dest = encoded.reserve(encoded_size + sizeof(uint64_t));
+
+  for (size_t i = 0; i < count; i++) {
+    dest += varint_encode_word(dest, varints[i]);
+  }
+
+  encoded.advance(encoded_size);
+
+  return encoded_size;
+}
+
 result<base::buffer>
 encode(uint64_t varint)
 {
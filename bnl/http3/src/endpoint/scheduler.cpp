@@ -0,0 +1,41 @@
+#include <bnl/http3/endpoint/scheduler.hpp>
+
+#include <cassert>
+
+namespace bnl {
+namespace http3 {
+namespace endpoint {
+
+void
+scheduler::schedule(uint64_t id)
+{
+  if (scheduled_.insert(id).second) {
+    ready_.push_back(id);
+  }
+}
+
+bool
+scheduler::empty() const noexcept
+{
+  return ready_.empty();
+}
+
+uint64_t
+scheduler::front() const noexcept
+{
+  assert(!ready_.empty());
+  return ready_.front();
+}
+
+void
+scheduler::pop() noexcept
+{
+  assert(!ready_.empty());
+
+  scheduled_.erase(ready_.front());
+  ready_.pop_front();
+}
+
+}
+}
+}
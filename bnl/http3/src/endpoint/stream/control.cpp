@@ -8,8 +8,9 @@ namespace endpoint {
 namespace stream {
 namespace control {
 
-sender::sender(uint64_t id) noexcept
-  : id_(id)
+sender::sender(uint64_t id, settings settings) noexcept
+  : settings_(settings)
+  , id_(id)
 {}
 
 result<quic::event>
@@ -0,0 +1,77 @@
+#include <bnl/http3/endpoint/stream/encoder.hpp>
+
+#include <bnl/base/log.hpp>
+#include <bnl/http3/codec/varint.hpp>
+
+namespace bnl {
+namespace http3 {
+namespace endpoint {
+namespace stream {
+namespace encoder {
+
+sender::sender(uint64_t id, qpack::stream::encoder *qpack) noexcept
+  : qpack_(qpack)
+  , id_(id)
+{}
+
+result<quic::event>
+sender::send() noexcept
+{
+  base::buffer encoded = BNL_TRY(qpack_->encode());
+
+  // The encoder stream is only opened once there are instructions to send so
+  // the stream type is sent together with the first instructions.
+  if (state_ == state::type) {
+    base::buffer type = BNL_TRY(varint::encode(encoder::type));
+    encoded = base::buffer::concat(type, encoded);
+    state_ = state::instructions;
+  }
+
+  return quic::data{ id_, false, std::move(encoded) };
+}
+
+receiver::receiver(uint64_t id, qpack::stream::decoder *qpack) noexcept
+  : qpack_(qpack)
+  , id_(id)
+{}
+
+uint64_t
+receiver::id() const noexcept
+{
+  return id_;
+}
+
+result<void>
+receiver::recv(quic::data data)
+{
+  if (data.fin) {
+    return error::closed_critical_stream;
+  }
+
+  buffers_.push(std::move(data.buffer));
+
+  return base::success();
+}
+
+result<void>
+receiver::process()
+{
+  if (state_ == state::type) {
+    uint64_t type = BNL_TRY(varint::decode(buffers_));
+
+    if (type != encoder::type) {
+      BNL_LOG_E("Unexpected stream type ({}) on encoder stream", type);
+      return error::wrong_stream;
+    }
+
+    state_ = state::instructions;
+  }
+
+  return qpack_->decode(buffers_);
+}
+
+}
+}
+}
+}
+}
@@ -8,12 +8,17 @@ namespace endpoint {
 namespace stream {
 namespace request {
 
-sender::sender(uint64_t id) noexcept
-  : id_(id)
+sender::sender(uint64_t id,
+               qpack::stream::encoder *qpack,
+               endpoint::scheduler *scheduler) noexcept
+  : scheduler_(scheduler)
+  , headers_(id, qpack)
+  , id_(id)
 {}
 
 sender::sender(sender &&other) noexcept
   : handle_(other.handle_)
+  , scheduler_(other.scheduler_)
   , state_(other.state_)
   , headers_(std::move(other.headers_))
   , body_(std::move(other.body_))
@@ -31,6 +36,7 @@ sender::operator=(sender &&other) noexcept
 {
   if (&other != this) {
     handle_ = other.handle_;
+    scheduler_ = other.scheduler_;
     state_ = other.state_;
     headers_ = std::move(other.headers_);
     body_ = std::move(other.body_);
@@ -97,25 +103,65 @@ sender::send() noexcept
 result<void>
 sender::header(header_view header)
 {
-  return headers_.add(header);
+  return schedule(headers_.add(header));
+}
+
+result<void>
+sender::header(const qpack::static_header &header)
+{
+  return schedule(headers_.add(header));
+}
+
+result<void>
+sender::header(const headers::prototype &prototype)
+{
+  return schedule(headers_.add(prototype));
 }
 
 result<void>
 sender::body(base::buffer body)
 {
-  return body_.add(std::move(body));
+  return schedule(body_.add(std::move(body)));
+}
+
+result<void>
+sender::body(base::file body)
+{
+  return schedule(body_.add(std::move(body)));
+}
+
+result<void>
+sender::configure(body::policy policy) noexcept
+{
+  return body_.configure(policy);
+}
+
+result<void>
+sender::flush() noexcept
+{
+  return schedule(body_.flush());
 }
 
 result<void>
 sender::start() noexcept
 {
-  return headers_.fin();
+  return schedule(headers_.fin());
 }
 
 result<void>
 sender::fin() noexcept
 {
-  return body_.fin();
+  return schedule(body_.fin());
+}
+
+result<void>
+sender::schedule(result<void> r)
+{
+  if (r && scheduler_ != nullptr) {
+    scheduler_->schedule(id_);
+  }
+
+  return r;
 }
 
 sender::handle::handle(sender *sender)
@@ -171,6 +217,26 @@ sender::handle::header(header_view header)
   return sender_->header(header);
 }
 
+result<void>
+sender::handle::header(const qpack::static_header &header)
+{
+  if (sender_ == nullptr) {
+    return error::invalid_handle;
+  }
+
+  return sender_->header(header);
+}
+
+result<void>
+sender::handle::header(const headers::prototype &prototype)
+{
+  if (sender_ == nullptr) {
+    return error::invalid_handle;
+  }
+
+  return sender_->header(prototype);
+}
+
 result<void>
 sender::handle::body(base::buffer body)
 {
@@ -181,6 +247,36 @@ sender::handle::body(base::buffer body)
   return sender_->body(std::move(body));
 }
 
+result<void>
+sender::handle::body(base::file body)
+{
+  if (sender_ == nullptr) {
+    return error::invalid_handle;
+  }
+
+  return sender_->body(std::move(body));
+}
+
+result<void>
+sender::handle::configure(body::policy policy) noexcept
+{
+  if (sender_ == nullptr) {
+    return error::invalid_handle;
+  }
+
+  return sender_->configure(policy);
+}
+
+result<void>
+sender::handle::flush() noexcept
+{
+  if (sender_ == nullptr) {
+    return error::invalid_handle;
+  }
+
+  return sender_->flush();
+}
+
 result<void>
 sender::handle::start() noexcept
 {
@@ -201,8 +297,9 @@ sender::handle::fin() noexcept
   return sender_->fin();
 }
 
-receiver::receiver(uint64_t id) noexcept
-  : id_(id)
+receiver::receiver(uint64_t id, qpack::stream::decoder *qpack) noexcept
+  : headers_(id, qpack)
+  , id_(id)
 {}
 
 receiver::~receiver() noexcept = default;
@@ -251,6 +348,10 @@ receiver::recv(quic::data data)
 result<event>
 receiver::process() noexcept
 {
+  if (delegated_) {
+    return delegate();
+  }
+
   http3::error error;
 
   switch (state_) {
@@ -259,27 +360,20 @@ receiver::process() noexcept
       return error::internal;
 
     case state::headers: {
-      result<header> r = headers_.decode(buffers_);
+      result<void> r = headers_.decode(buffers_, list_);
       if (!r) {
         error = r.error();
         break;
       }
 
       bool fin = buffers_.empty() && fin_received_;
+      state_ = fin ? state::fin : state::body;
 
-      if (headers_.finished() && fin) {
-        state_ = state::fin;
-      } else if (headers_.finished()) {
-        state_ = state::body;
-      }
-
-      return event::payload::header{ id_,
-                                     headers_.finished(),
-                                     std::move(r).value() };
+      return event::payload::headers{ id_, fin, &list_ };
     }
 
     case state::body: {
-      result<base::buffer> r = body_.decode(buffers_);
+      result<base::buffers> r = body_.decode(buffers_);
       if (!r) {
         error = r.error();
         break;
@@ -304,38 +398,62 @@ receiver::process() noexcept
       return event::payload::finished{ id_ };
   };
 
-  if (error == error::incomplete && fin_received_) {
+  // Blocked header blocks are completed by the peer's encoder stream so they
+  // can't be malformed yet.
+  if (error == error::incomplete && fin_received_ && !headers_.blocked()) {
     return error::malformed_frame;
   }
 
   if (error == error::delegate) {
-    frame frame = BNL_TRY(frame::decode(buffers_));
-
-    switch (frame) {
-      case frame::type::headers:
-        // TODO: Implement trailing HEADERS
-        if (state_ == receiver::state::body) {
-          BNL_LOG_W("Ignoring trailing headers");
-          buffers_.consume(buffers_.size());
-          state_ = state::fin;
-          return event::payload::body{ id_, true, base::buffer() };
-        }
-        break;
-      case frame::type::data:
-        return error::unexpected_frame;
-      case frame::type::settings:
-      case frame::type::max_push_id:
-      case frame::type::cancel_push:
-      case frame::type::goaway:
-        return error::wrong_stream;
-      default:
-        return process(frame);
-    }
+    frame_ = state_ == state::headers ? headers_.delegated()
+                                      : body_.delegated();
+    delegated_ = true;
+
+    return delegate();
   }
 
   return error;
 }
 
+result<event>
+receiver::delegate() noexcept
+{
+  switch (frame_.type) {
+    case frame::type::headers:
+      // TODO: Implement trailing HEADERS
+      if (state_ == receiver::state::body) {
+        BNL_LOG_W("Ignoring trailing headers");
+        buffers_.consume(buffers_.size());
+        state_ = state::fin;
+        delegated_ = false;
+        return event::payload::body{ id_, true, base::buffers() };
+      }
+      break;
+    case frame::type::data:
+      return error::unexpected_frame;
+    case frame::type::settings:
+    case frame::type::max_push_id:
+    case frame::type::cancel_push:
+    case frame::type::goaway:
+      return error::wrong_stream;
+    default:
+      break;
+  }
+
+  result<frame> r = frame::decode(buffers_, frame_);
+  if (!r) {
+    if (r.error() == error::incomplete && fin_received_) {
+      return error::malformed_frame;
+    }
+
+    return r.error();
+  }
+
+  delegated_ = false;
+
+  return process(std::move(r).value());
+}
+
 }
 }
 }
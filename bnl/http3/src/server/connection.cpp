@@ -1,9 +1,46 @@
 #include <bnl/http3/server/connection.hpp>
 
+static constexpr uint64_t CLIENT_STREAM_ENCODER_ID = 0x06;
+static constexpr uint64_t SERVER_STREAM_ENCODER_ID = 0x07;
+static constexpr uint64_t CLIENT_STREAM_DECODER_ID = 0x0a;
+static constexpr uint64_t SERVER_STREAM_DECODER_ID = 0x0b;
+
 namespace bnl {
 namespace http3 {
 namespace server {
 
+// Settings advertised by default. The dynamic table capacity and amount of
+// blocked streams match the defaults of `qpack::stream::decoder`.
+static settings
+local_settings() noexcept
+{
+  settings settings;
+  settings.qpack_max_table_capacity = qpack::stream::decoder::DEFAULT_CAPACITY;
+  settings.qpack_blocked_streams =
+    qpack::stream::decoder::DEFAULT_BLOCKED_STREAMS;
+  return settings;
+}
+
+connection::connection()
+  : settings_{ local_settings(), {} }
+  , control_(server::stream::control::sender(settings_.local),
+             server::stream::control::receiver())
+  , qpack_{ std::unique_ptr<qpack::stream::encoder>(
+               new qpack::stream::encoder()),
+             std::unique_ptr<qpack::stream::decoder>(new qpack::stream::decoder(
+               settings_.local.qpack_max_table_capacity,
+               settings_.local.qpack_blocked_streams)) }
+  , scheduler_(new endpoint::scheduler())
+  , encoder_(endpoint::stream::encoder::sender(SERVER_STREAM_ENCODER_ID,
+                                               qpack_.encoder.get()),
+             endpoint::stream::decoder::receiver(CLIENT_STREAM_DECODER_ID,
+                                                 qpack_.encoder.get()))
+  , decoder_(endpoint::stream::decoder::sender(SERVER_STREAM_DECODER_ID,
+                                               qpack_.decoder.get()),
+             endpoint::stream::encoder::receiver(CLIENT_STREAM_ENCODER_ID,
+                                                 qpack_.decoder.get()))
+{}
+
 result<quic::event>
 connection::send() noexcept
 {
@@ -20,18 +57,58 @@ connection::send() noexcept
     }
   }
 
-  for (auto &entry : requests_) {
-    uint64_t id = entry.first;
-    server::stream::request::sender &request = entry.second.first;
+  // Send the encoder stream instructions before the header blocks that
+  // reference them.
+  {
+    result<quic::event> r = encoder_.first.send();
+    if (r) {
+      return r;
+    }
+
+    if (r.error() != error::idle) {
+      return r.error();
+    }
+  }
+
+  {
+    result<quic::event> r = decoder_.first.send();
+    if (r) {
+      return r;
+    }
+
+    if (r.error() != error::idle) {
+      return r.error();
+    }
+  }
+
+  while (!scheduler_->empty()) {
+    uint64_t id = scheduler_->front();
+
+    auto match = requests_.find(id);
+    // The request might have been closed after it was scheduled.
+    if (match == requests_.end()) {
+      scheduler_->pop();
+      continue;
+    }
+
+    server::stream::request::sender &request = match->second.first;
 
     if (request.finished()) {
+      scheduler_->pop();
       continue;
     }
 
+    // Streams take turns: a stream that sent something goes to the back of
+    // the queue. A stream that has nothing left to send is dropped from the
+    // queue and is scheduled again when more data is added.
     result<quic::event> r = request.send();
     if (r) {
+      scheduler_->pop();
+
       if (request.finished()) {
-        requests_.erase(id);
+        requests_.erase(match);
+      } else {
+        scheduler_->schedule(id);
       }
 
       return r;
@@ -40,6 +117,8 @@ connection::send() noexcept
     if (r.error() != error::idle) {
       return r.error();
     }
+
+    scheduler_->pop();
   }
 
   return error::idle;
@@ -70,10 +149,29 @@ connection::recv(quic::data data)
     return control.recv(std::move(data));
   };
 
+  endpoint::stream::decoder::receiver &decoder = encoder_.second;
+
+  if (data.id == decoder.id()) {
+    return decoder.recv(std::move(data));
+  }
+
+  endpoint::stream::encoder::receiver &encoder = decoder_.second;
+
+  if (data.id == encoder.id()) {
+    return encoder.recv(std::move(data));
+  }
+
+  // TODO: Actually handle unidirectional streams.
+  if ((data.id & 0x2U) != 0) {
+    return base::success();
+  }
+
   auto match = requests_.find(data.id);
   if (match == requests_.end()) {
-    server::stream::request::sender sender(data.id);
-    server::stream::request::receiver receiver(data.id);
+    server::stream::request::sender sender(
+      data.id, qpack_.encoder.get(), scheduler_.get());
+    server::stream::request::receiver receiver(data.id,
+                                             qpack_.decoder.get());
 
     BNL_TRY(receiver.start());
 
@@ -97,6 +195,7 @@ connection::process(uint64_t id)
     switch (event) {
       case event::type::settings:
         settings_.peer = event.settings;
+        BNL_TRY(qpack_.encoder->configure(settings_.peer));
         break;
       default:
         break;
@@ -105,11 +204,63 @@ connection::process(uint64_t id)
     return event;
   }
 
+  endpoint::stream::decoder::receiver &decoder = encoder_.second;
+
+  if (id == decoder.id()) {
+    BNL_TRY(decoder.process());
+    // Decoder stream instructions don't produce any events.
+    return error::incomplete;
+  }
+
+  endpoint::stream::encoder::receiver &encoder = decoder_.second;
+
+  if (id == encoder.id()) {
+    BNL_TRY(encoder.process());
+    return unblocked();
+  }
+
+  // TODO: Actually handle unidirectional streams.
+  if ((id & 0x2U) != 0) {
+    return error::incomplete;
+  }
+
   server::stream::request::receiver &request = requests_.at(id).second;
 
   return request.process();
 }
 
+result<event>
+connection::unblocked()
+{
+  while (true) {
+    if (unblocked_ == UINT64_MAX) {
+      result<uint64_t> r = qpack_.decoder->unblocked();
+      if (!r) {
+        if (r.error() == error::idle) {
+          return error::incomplete;
+        }
+
+        return r.error();
+      }
+
+      unblocked_ = r.value();
+    }
+
+    // The request might have been closed while it was blocked.
+    if (requests_.find(unblocked_) == requests_.end()) {
+      unblocked_ = UINT64_MAX;
+      continue;
+    }
+
+    result<event> r = process(unblocked_);
+    if (r || r.error() != error::incomplete) {
+      return r;
+    }
+
+    unblocked_ = UINT64_MAX;
+  }
+}
+
 result<response::handle>
 connection::response(uint64_t id)
 {
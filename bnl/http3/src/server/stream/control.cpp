@@ -9,8 +9,8 @@ namespace server {
 namespace stream {
 namespace control {
 
-sender::sender() noexcept
-  : endpoint::stream::control::sender(SERVER_STREAM_CONTROL_ID)
+sender::sender(settings settings) noexcept
+  : endpoint::stream::control::sender(SERVER_STREAM_CONTROL_ID, settings)
 {}
 
 receiver::receiver() noexcept
@@ -0,0 +1,259 @@
+#include <doctest.h>
+
+#include <bnl/base/cursor.hpp>
+#include <bnl/http3/codec/body.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace bnl;
+
+// Returns the payload size of each DATA frame in `encoded`.
+static std::vector<size_t>
+frames(base::buffer encoded)
+{
+  std::vector<size_t> sizes;
+
+  while (!encoded.empty()) {
+    http3::frame frame = http3::frame::decode(encoded).value();
+    REQUIRE(frame == http3::frame::type::data);
+    REQUIRE(frame.data.size <= encoded.size());
+
+    sizes.push_back(static_cast<size_t>(frame.data.size));
+    encoded.consume(static_cast<size_t>(frame.data.size));
+  }
+
+  return sizes;
+}
+
+static base::buffer
+chunk(size_t size)
+{
+  base::buffer chunk(size);
+  std::fill_n(chunk.data(), size, 'a');
+  return chunk;
+}
+
+// Returns a file of `size` bytes. The file is removed from the file system
+// right away so nothing is left behind if a check fails.
+static base::file
+file(size_t size)
+{
+  const char *directory = std::getenv("TMPDIR");
+  std::string path = std::string(directory != nullptr ? directory : "/tmp") +
+                     "/bnl-test-body-XXXXXX";
+
+  int fd = mkstemp(&path[0]);
+  REQUIRE(fd >= 0);
+
+  std::FILE *stream = fdopen(fd, "wb");
+  for (size_t i = 0; stream != nullptr && i < size; i++) {
+    std::fputc('a', stream);
+  }
+
+  bool written = stream != nullptr && std::fclose(stream) == 0;
+  base::result<base::file, std::error_code> r = base::file::open(path.c_str());
+  std::remove(path.c_str());
+
+  REQUIRE(written);
+  return std::move(r).value();
+}
+
+TEST_CASE("body")
+{
+  http3::body::encoder encoder;
+
+  SUBCASE("single write")
+  {
+    REQUIRE(encoder.add(chunk(100)));
+    REQUIRE(encoder.fin());
+
+    // The frame header and the payload are encoded into a single buffer.
+    base::buffer encoded = encoder.encode().value();
+    REQUIRE(encoder.finished());
+
+    REQUIRE(frames(std::move(encoded)) == std::vector<size_t>{ 100 });
+  }
+
+  SUBCASE("fin after frame header")
+  {
+    REQUIRE(encoder.add(chunk(16 * 1024)));
+
+    base::buffer header = encoder.encode().value();
+    http3::frame frame = http3::frame::decode(header).value();
+    REQUIRE(frame.data.size == 16 * 1024);
+
+    REQUIRE(encoder.fin());
+    REQUIRE(!encoder.finished());
+
+    base::buffer encoded = encoder.encode().value();
+    REQUIRE(encoded.size() == 16 * 1024);
+    REQUIRE(encoder.finished());
+  }
+
+  SUBCASE("small writes")
+  {
+    for (size_t i = 0; i < 10; i++) {
+      REQUIRE(encoder.add(chunk(10)));
+    }
+
+    // Without coalescing, the queued writes are still sent as a single frame.
+    base::buffer encoded = encoder.encode().value();
+    REQUIRE(frames(std::move(encoded)) == std::vector<size_t>{ 100 });
+
+    REQUIRE(encoder.encode().error() == http3::error::idle);
+  }
+
+  SUBCASE("coalesce")
+  {
+    http3::body::policy policy;
+    policy.coalesce = 100;
+    REQUIRE(encoder.configure(policy));
+
+    for (size_t i = 0; i < 5; i++) {
+      REQUIRE(encoder.add(chunk(10)));
+      REQUIRE(encoder.encode().error() == http3::error::idle);
+    }
+
+    REQUIRE(encoder.flush());
+
+    base::buffer encoded = encoder.encode().value();
+    REQUIRE(frames(std::move(encoded)) == std::vector<size_t>{ 50 });
+
+    for (size_t i = 0; i < 9; i++) {
+      REQUIRE(encoder.add(chunk(10)));
+      REQUIRE(encoder.encode().error() == http3::error::idle);
+    }
+
+    // Reaching the threshold sends the frame without an explicit flush.
+    REQUIRE(encoder.add(chunk(10)));
+
+    encoded = encoder.encode().value();
+    REQUIRE(frames(std::move(encoded)) == std::vector<size_t>{ 100 });
+
+    REQUIRE(encoder.add(chunk(10)));
+    REQUIRE(encoder.encode().error() == http3::error::idle);
+
+    REQUIRE(encoder.fin());
+
+    encoded = encoder.encode().value();
+    REQUIRE(encoder.finished());
+    REQUIRE(frames(std::move(encoded)) == std::vector<size_t>{ 10 });
+  }
+
+  SUBCASE("split")
+  {
+    http3::body::policy policy;
+    policy.max_frame_size = 16 * 1024;
+    REQUIRE(encoder.configure(policy));
+
+    REQUIRE(encoder.add(chunk(40 * 1024)));
+    REQUIRE(encoder.fin());
+
+    // Large buffers are sent without copying them so the frame header and
+    // the payload are separate buffers.
+    base::buffer header = encoder.encode().value();
+    http3::frame frame = http3::frame::decode(header).value();
+    REQUIRE(header.empty());
+    REQUIRE(frame.data.size == 16 * 1024);
+
+    base::buffer encoded = encoder.encode().value();
+    REQUIRE(encoded.size() == 16 * 1024);
+
+    while (!encoder.finished()) {
+      encoded = base::buffer::concat(encoded, encoder.encode().value());
+    }
+
+    // The remainder is small enough to be copied behind its frame header.
+    encoded.consume(16 * 1024);
+    REQUIRE(frames(std::move(encoded)) ==
+            std::vector<size_t>{ 16 * 1024, 8 * 1024 });
+  }
+
+  SUBCASE("split: fin after frame header")
+  {
+    http3::body::policy policy;
+    policy.max_frame_size = 16 * 1024;
+    REQUIRE(encoder.configure(policy));
+
+    REQUIRE(encoder.add(chunk(32 * 1024)));
+
+    for (size_t i = 0; i < 2; i++) {
+      base::buffer header = encoder.encode().value();
+      http3::frame frame = http3::frame::decode(header).value();
+      REQUIRE(frame.data.size == 16 * 1024);
+
+      // The last frame's header is encoded once the whole buffer has been
+      // taken from the queue.
+      if (i == 1) {
+        REQUIRE(encoder.fin());
+        REQUIRE(!encoder.finished());
+      }
+
+      base::buffer encoded = encoder.encode().value();
+      REQUIRE(encoded.size() == 16 * 1024);
+    }
+
+    REQUIRE(encoder.finished());
+  }
+
+  SUBCASE("file: fin after frame header")
+  {
+    REQUIRE(encoder.add(file(20 * 1024)));
+
+    base::buffer header = encoder.encode().value();
+    http3::frame frame = http3::frame::decode(header).value();
+    REQUIRE(frame.data.size == 20 * 1024);
+
+    REQUIRE(encoder.fin());
+    REQUIRE(!encoder.finished());
+
+    base::buffer encoded = encoder.encode().value();
+    REQUIRE(encoded.size() == 20 * 1024);
+    REQUIRE(encoded[20 * 1024 - 1] == 'a');
+    REQUIRE(encoder.finished());
+  }
+
+  SUBCASE("decode: cursor")
+  {
+    REQUIRE(encoder.add(chunk(100)));
+    REQUIRE(encoder.add(chunk(40 * 1024)));
+    REQUIRE(encoder.fin());
+
+    base::buffer encoded;
+
+    while (!encoder.finished()) {
+      encoded = base::buffer::concat(encoded, encoder.encode().value());
+    }
+
+    http3::body::decoder decoder;
+    base::cursor cursor(encoded);
+
+    size_t decoded = 0;
+
+    while (!cursor.empty()) {
+      base::buffer_view body_part = decoder.decode(cursor).value();
+
+      // Body parts refer to the cursor's memory instead of a copy.
+      REQUIRE(body_part.data() >= encoded.data());
+      REQUIRE(body_part.data() + body_part.size() <=
+              encoded.data() + encoded.size());
+
+      decoded += body_part.size();
+    }
+
+    REQUIRE(decoded == 100 + 40 * 1024);
+  }
+
+  SUBCASE("configure: invalid")
+  {
+    http3::body::policy policy;
+    policy.max_frame_size = 0;
+
+    REQUIRE(encoder.configure(policy).error() == http3::error::internal);
+  }
+}
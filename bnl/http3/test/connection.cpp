@@ -4,7 +4,9 @@
 #include <bnl/http3/server/connection.hpp>
 
 #include <array>
+#include <cstdio>
 #include <map>
+#include <string>
 #include <vector>
 
 using namespace bnl;
@@ -77,12 +79,17 @@ transfer(Sender &sender, Receiver &receiver)
         case http3::event::type::settings:
           break;
 
-        case http3::event::type::header:
-          decoded.headers.emplace_back(std::move(event.header.header));
+        case http3::event::type::headers:
+          for (http3::header_view header : *event.headers.list) {
+            decoded.headers.emplace_back(header);
+          }
           break;
 
         case http3::event::type::body:
-          decoded.body = base::buffer::concat(decoded.body, event.body.buffer);
+          while (!event.body.buffers.empty()) {
+            decoded.body =
+              base::buffer::concat(decoded.body, event.body.buffers.pop());
+          }
           break;
 
         case http3::event::type::finished:
@@ -119,3 +126,305 @@ TEST_CASE("connection")
   decoded = transfer(server, client).value();
   REQUIRE(decoded == msg);
 }
+
+TEST_CASE("connection: file body")
+{
+  http3::client::connection client;
+  http3::server::connection server;
+
+  // Larger than a single chunk so the file is sent in multiple DATA frames.
+  base::buffer body(300 * 1024);
+
+  for (size_t i = 0; i < body.size(); i++) {
+    body[i] = static_cast<uint8_t>('a' + i % 26);
+  }
+
+  std::string path = "bnl-test-body";
+
+  {
+    std::FILE *stream = std::fopen(path.c_str(), "wb");
+    REQUIRE(stream != nullptr);
+    std::fwrite(body.data(), 1, body.size(), stream);
+    std::fclose(stream);
+  }
+
+  message msg = { { { ":status", "200" } }, base::buffer() };
+
+  http3::request::handle request = client.request().value();
+  REQUIRE(request.header({ ":method", "GET" }));
+  REQUIRE(request.start());
+  REQUIRE(request.fin());
+  REQUIRE(transfer(client, server));
+
+  http3::response::handle response = server.response(request.id()).value();
+
+  for (const http3::header &header : msg.headers) {
+    REQUIRE(response.header(header));
+  }
+
+  REQUIRE(response.start());
+  REQUIRE(response.body(base::file::open(path.c_str()).value()));
+  REQUIRE(response.fin());
+
+  message decoded = transfer(server, client).value();
+  REQUIRE(decoded.headers == msg.headers);
+  REQUIRE(decoded.body == body);
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("connection: headers event")
+{
+  http3::client::connection client;
+  http3::server::connection server;
+
+  REQUIRE(transfer(client, server));
+  REQUIRE(transfer(server, client));
+
+  message msg = { { { ":method", "GET" },
+                    { ":scheme", "https" },
+                    { ":authority", "www.example.com" },
+                    { ":path", "/" } },
+                  base::buffer() };
+
+  http3::request::handle request = client.request().value();
+
+  for (const http3::header &header : msg.headers) {
+    REQUIRE(request.header(header));
+  }
+
+  REQUIRE(request.start());
+  REQUIRE(request.fin());
+
+  size_t events = 0;
+
+  while (true) {
+    http3::result<quic::event> r = client.send();
+    if (!r) {
+      REQUIRE(r.error() == http3::error::idle);
+      break;
+    }
+
+    http3::server::generator generator =
+      server.recv(std::move(r).value()).value();
+
+    while (generator.next()) {
+      http3::event event = generator.get().value();
+
+      if (event == http3::event::type::headers) {
+        // The full header block is delivered at once and no body follows.
+        REQUIRE(event.headers.id == request.id());
+        REQUIRE(event.headers.fin);
+        REQUIRE(event.headers.list->size() == msg.headers.size());
+
+        for (size_t i = 0; i < msg.headers.size(); i++) {
+          REQUIRE(http3::header((*event.headers.list)[i]) == msg.headers[i]);
+        }
+
+        events++;
+      }
+    }
+  }
+
+  REQUIRE(events == 1);
+}
+
+TEST_CASE("connection: scheduler")
+{
+  http3::client::connection client;
+  http3::server::connection server;
+
+  REQUIRE(transfer(client, server));
+  REQUIRE(transfer(server, client));
+  REQUIRE(transfer(client, server));
+
+  std::vector<http3::request::handle> requests;
+
+  for (size_t i = 0; i < 100; i++) {
+    requests.push_back(client.request().value());
+  }
+
+  // Requests without data are never scheduled.
+  REQUIRE(client.send().error() == http3::error::idle);
+
+  message msg = { { { ":method", "GET" },
+                    { ":scheme", "https" },
+                    { ":authority", "www.example.com" },
+                    { ":path", "/" } },
+                  { "abcde" } };
+
+  start(requests[42], msg);
+  start(requests[7], msg);
+
+  // Only the two requests with data send anything and they take turns
+  // instead of one request sending everything it has first.
+  std::vector<uint64_t> order;
+
+  while (true) {
+    http3::result<quic::event> r = client.send();
+    if (!r) {
+      REQUIRE(r.error() == http3::error::idle);
+      break;
+    }
+
+    uint64_t id = r.value().id();
+
+    // Client initiated request streams are the bidirectional streams.
+    if (id % 4 == 0) {
+      REQUIRE((id == requests[42].id() || id == requests[7].id()));
+      order.push_back(id);
+    }
+
+    auto generator = server.recv(std::move(r).value()).value();
+    while (generator.next()) {
+      REQUIRE(generator.get());
+    }
+  }
+
+  REQUIRE(order.size() >= 4);
+  REQUIRE(order.size() % 2 == 0);
+
+  for (size_t i = 0; i < order.size(); i++) {
+    REQUIRE(order[i] == (i % 2 == 0 ? requests[42].id() : requests[7].id()));
+  }
+
+  for (const http3::header &header : msg.headers) {
+    REQUIRE(requests[13].header(header));
+  }
+
+  REQUIRE(requests[13].start());
+
+  message decoded = transfer(client, server).value();
+  REQUIRE(decoded.headers == msg.headers);
+  REQUIRE(decoded.body.empty());
+
+  // The request is scheduled again when the body is added.
+  REQUIRE(requests[13].body({ msg.body.data(), msg.body.size() }));
+  REQUIRE(requests[13].fin());
+
+  decoded = transfer(client, server).value();
+  REQUIRE(decoded.headers.empty());
+  REQUIRE(decoded.body == msg.body);
+}
+
+TEST_CASE("connection: allocations")
+{
+  http3::client::connection client;
+  http3::server::connection server;
+
+  message msg = { { { ":method", "GET" },
+                    { ":scheme", "https" },
+                    { ":authority", "www.example.com" },
+                    { ":path", "/index.html" },
+                    { "user-agent", "bnl" },
+                    { "accept", "*/*" },
+                    { "accept-encoding", "gzip, deflate, br" },
+                    { "accept-language", "en-US,en;q=0.9" } },
+                  base::buffer() };
+
+  // Exclude the SETTINGS exchange and the first request, which fills the
+  // QPACK dynamic table, from the budget.
+  REQUIRE(transfer(client, server));
+  REQUIRE(transfer(server, client));
+
+  {
+    http3::request::handle request = client.request().value();
+
+    for (const http3::header &header : msg.headers) {
+      REQUIRE(request.header(header));
+    }
+
+    REQUIRE(request.start());
+    REQUIRE(request.fin());
+
+    REQUIRE(transfer(client, server).value() == msg);
+    REQUIRE(transfer(server, client));
+  }
+
+  base::buffer::collect(true);
+  base::buffer::reset_stats();
+
+  http3::request::handle request = client.request().value();
+
+  for (const http3::header &header : msg.headers) {
+    REQUIRE(request.header(header));
+  }
+
+  REQUIRE(request.start());
+  REQUIRE(request.fin());
+
+  message decoded = transfer(client, server).value();
+  REQUIRE(decoded == msg);
+
+  base::buffer::statistics stats = base::buffer::stats();
+  base::buffer::collect(false);
+
+  // The header block is encoded into a single buffer which is decoded without
+  // copying it. The decoder keeps a slice of the header block alive which
+  // copies it inline instead of allocating when it's small enough (20 bytes).
+  REQUIRE(stats.allocations <= 2);
+  REQUIRE(stats.copies <= 1);
+  REQUIRE(stats.copied <= 20);
+}
+
+TEST_CASE("connection: blocked header block")
+{
+  http3::client::connection client;
+  http3::server::connection server;
+
+  REQUIRE(transfer(client, server));
+  REQUIRE(transfer(server, client));
+
+  message msg = { { { ":method", "GET" },
+                    { ":scheme", "https" },
+                    { ":authority", "www.example.com" },
+                    { ":path", "/" } },
+                  base::buffer() };
+
+  http3::request::handle request = client.request().value();
+
+  for (const http3::header &header : msg.headers) {
+    REQUIRE(request.header(header));
+  }
+
+  REQUIRE(request.start());
+  REQUIRE(request.fin());
+
+  // Deliver the request stream before the encoder stream so the header block
+  // has to wait for the dynamic table inserts it references.
+  std::vector<quic::event> streams[2];
+
+  while (true) {
+    http3::result<quic::event> r = client.send();
+    if (!r) {
+      REQUIRE(r.error() == http3::error::idle);
+      break;
+    }
+
+    bool encoder = r.value().id() != request.id();
+    streams[encoder].emplace_back(std::move(r).value());
+  }
+
+  message decoded;
+
+  for (std::vector<quic::event> &events : streams) {
+    REQUIRE(decoded.headers.empty());
+
+    for (quic::event &event : events) {
+      http3::server::generator generator =
+        server.recv(std::move(event)).value();
+
+      while (generator.next()) {
+        http3::event event = generator.get().value();
+
+        if (event == http3::event::type::headers) {
+          for (http3::header_view header : *event.headers.list) {
+            decoded.headers.emplace_back(header);
+          }
+        }
+      }
+    }
+  }
+
+  REQUIRE(decoded == msg);
+}
@@ -1,5 +1,8 @@
 #include <doctest.h>
 
+#include <bnl/base/buffer_builder.hpp>
+#include <bnl/base/buffers.hpp>
+#include <bnl/base/cursor.hpp>
 #include <bnl/http3/codec/frame.hpp>
 
 using namespace bnl;
@@ -19,6 +22,22 @@ encode_and_decode(const http3::frame &frame)
 
   REQUIRE(decoded == frame);
 
+  // Decoding straight from memory gives the same result.
+  encoded = http3::frame::encode(frame).value();
+  base::cursor cursor(encoded);
+
+  REQUIRE(http3::frame::decode(cursor).value() == frame);
+  REQUIRE(cursor.empty());
+
+  // Varints that span multiple buffers can't be decoded in bulk.
+  base::buffers buffers;
+  for (size_t i = 0; i < encoded.size(); i++) {
+    buffers.push(base::buffer(encoded.data() + i, 1));
+  }
+
+  REQUIRE(http3::frame::decode(buffers).value() == frame);
+  REQUIRE(buffers.empty());
+
   return decoded;
 }
 
@@ -155,3 +174,59 @@ TEST_CASE("frame")
     REQUIRE(encoded.size() == 6);
   }
 }
+
+TEST_CASE("frame: parser")
+{
+  base::buffer_builder builder;
+
+  // Unknown frame types are skipped.
+  REQUIRE(http3::varint::encode(builder, 0x21));
+  REQUIRE(http3::varint::encode(builder, 3));
+  builder.append(base::buffer("abc", 3));
+
+  // Needs a four byte varint.
+  http3::frame headers = http3::frame::payload::headers{ 16384 };
+  REQUIRE(http3::frame::encode(builder, headers));
+
+  http3::frame goaway = http3::frame::payload::goaway{ 4 };
+  REQUIRE(http3::frame::encode(builder, goaway));
+
+  base::buffer encoded = builder.finish();
+
+  http3::frame::parser parser;
+  base::buffers buffers;
+
+  // Feed the frames one byte at a time. Every byte is consumed as soon as it
+  // is received.
+  size_t i = 0;
+
+  auto next = [&]() -> http3::frame::header {
+    while (true) {
+      http3::result<http3::frame::header> r = parser.decode(buffers);
+      if (r) {
+        return r.value();
+      }
+
+      REQUIRE(r.error() == http3::error::incomplete);
+      REQUIRE(buffers.empty());
+      REQUIRE(i < encoded.size());
+
+      buffers.push(base::buffer(encoded.data() + i++, 1));
+    }
+  };
+
+  http3::frame::header header = next();
+  REQUIRE(header.type == http3::frame::type::headers);
+  REQUIRE(header.size == 16384);
+  REQUIRE(!parser.in_progress());
+
+  header = next();
+  REQUIRE(header.type == http3::frame::type::goaway);
+  REQUIRE(header.size == 1);
+
+  buffers.push(base::buffer(encoded.data() + i, encoded.size() - i));
+
+  http3::frame decoded = http3::frame::decode(buffers, header).value();
+  REQUIRE(decoded == goaway);
+  REQUIRE(buffers.empty());
+}
@@ -0,0 +1,180 @@
+#include <doctest.h>
+
+#include <bnl/base/cursor.hpp>
+#include <bnl/http3/codec/headers.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace bnl;
+
+static const std::vector<http3::header> headers = {
+  { ":method", "GET" },
+  { ":scheme", "https" },
+  { ":authority", "www.example.com" },
+  { ":path", "/index.html" },
+  { "user-agent", "bnl" }
+};
+
+static base::buffer
+encode(uint64_t id, http3::qpack::stream::encoder *qpack)
+{
+  http3::headers::encoder encoder(id, qpack);
+
+  for (const http3::header &header : headers) {
+    REQUIRE(encoder.add(header));
+  }
+
+  REQUIRE(encoder.fin());
+
+  // The frame header and the full header block are encoded into a single
+  // buffer.
+  base::buffer encoded = encoder.encode().value();
+  REQUIRE(encoder.finished());
+
+  return encoded;
+}
+
+static void
+require_equal(const std::vector<http3::header_view> &decoded)
+{
+  REQUIRE(decoded.size() == headers.size());
+
+  for (size_t i = 0; i < headers.size(); i++) {
+    REQUIRE(http3::header(decoded[i]) == headers[i]);
+  }
+}
+
+TEST_CASE("headers")
+{
+  http3::qpack::stream::encoder encoder;
+  http3::qpack::stream::decoder decoder;
+
+  base::buffer encoded = encode(0, &encoder);
+
+  SUBCASE("decode")
+  {
+    http3::headers::decoder receiver(0, &decoder);
+    std::vector<http3::header_view> decoded;
+
+    REQUIRE(receiver.decode(encoded, decoded));
+    REQUIRE(receiver.finished());
+    REQUIRE(encoded.empty());
+
+    require_equal(decoded);
+  }
+
+  SUBCASE("decode: cursor")
+  {
+    http3::headers::decoder receiver(0, &decoder);
+    std::vector<http3::header_view> decoded;
+
+    base::cursor cursor(encoded);
+
+    REQUIRE(receiver.decode(cursor, decoded));
+    REQUIRE(receiver.finished());
+    REQUIRE(cursor.empty());
+
+    require_equal(decoded);
+
+    // Literals that aren't huffman encoded refer to the cursor's memory.
+    REQUIRE(std::any_of(decoded.begin(),
+                        decoded.end(),
+                        [&](const http3::header_view &header) {
+                          const uint8_t *value = reinterpret_cast<
+                            const uint8_t *>(header.value().data());
+                          return value >= encoded.data() &&
+                                 value < encoded.data() + encoded.size();
+                        }));
+  }
+
+  SUBCASE("incomplete")
+  {
+    http3::headers::decoder receiver(0, &decoder);
+    std::vector<http3::header_view> decoded;
+
+    base::buffers buffers;
+    buffers.push(encoded.slice(encoded.size() - 1));
+
+    http3::result<void> r = receiver.decode(buffers, decoded);
+    REQUIRE(r.error() == http3::error::incomplete);
+    REQUIRE(receiver.started());
+
+    buffers.push(std::move(encoded));
+
+    REQUIRE(receiver.decode(buffers, decoded));
+    REQUIRE(buffers.empty());
+
+    require_equal(decoded);
+  }
+
+  SUBCASE("reuse")
+  {
+    std::vector<http3::header_view> decoded;
+
+    http3::headers::decoder first(0, &decoder);
+    REQUIRE(first.decode(encoded, decoded));
+    require_equal(decoded);
+
+    base::buffer again = encode(4, &encoder);
+
+    http3::headers::decoder second(4, &decoder);
+    REQUIRE(second.decode(again, decoded));
+    require_equal(decoded);
+  }
+}
+
+TEST_CASE("headers: prototype")
+{
+  http3::headers::prototype prototype;
+
+  for (const http3::header &header : headers) {
+    if (header.name() != ":path") {
+      REQUIRE(prototype.add(header));
+    }
+  }
+
+  REQUIRE(prototype.size() == headers.size() - 1);
+
+  http3::settings settings;
+  settings.qpack_max_table_capacity = 4096;
+  settings.qpack_blocked_streams = 16;
+
+  http3::qpack::stream::encoder qpack;
+  REQUIRE(qpack.configure(settings));
+
+  http3::qpack::stream::decoder decoder;
+
+  for (uint64_t id = 0; id < 12; id += 4) {
+    // The variable headers may still use the dynamic table.
+    http3::headers::encoder encoder(id, &qpack);
+    REQUIRE(encoder.add({ ":path", "/index.html" }));
+    REQUIRE(encoder.add(prototype));
+    REQUIRE(encoder.add({ "x-request", std::to_string(id) }));
+    REQUIRE(encoder.fin());
+
+    base::buffer encoded = encoder.encode().value();
+
+    http3::result<base::buffer> instructions = qpack.encode();
+    if (instructions) {
+      REQUIRE(decoder.decode(instructions.value()));
+    }
+
+    http3::headers::decoder receiver(id, &decoder);
+    std::vector<http3::header_view> decoded;
+    REQUIRE(receiver.decode(encoded, decoded));
+
+    REQUIRE(decoded.size() == prototype.size() + 2);
+    REQUIRE(http3::header(decoded[0]) ==
+            http3::header(":path", "/index.html"));
+
+    // `headers` without `:path` (at index 3).
+    for (size_t i = 0; i < prototype.size(); i++) {
+      REQUIRE(http3::header(decoded[i + 1]) == headers[i < 3 ? i : i + 1]);
+    }
+
+    REQUIRE(http3::header(decoded.back()) ==
+            http3::header("x-request", std::to_string(id)));
+  }
+}
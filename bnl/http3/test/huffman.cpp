@@ -2,6 +2,7 @@
 
 #include <bnl/http3/codec/qpack/huffman.hpp>
 
+#include <algorithm>
 #include <random>
 
 using namespace bnl;
@@ -26,6 +27,22 @@ random_string(size_t length)
   return string;
 }
 
+static base::string
+random_bytes(size_t length)
+{
+  static std::mt19937 rg{ std::random_device{}() };
+  static std::uniform_int_distribution<int> pick(0, UINT8_MAX);
+
+  base::string string;
+  string.resize(length);
+
+  for (char &character : string) {
+    character = static_cast<char>(pick(rg));
+  }
+
+  return string;
+}
+
 static void
 encode_and_decode(base::string_view string)
 {
@@ -61,4 +78,115 @@ TEST_CASE("huffman")
     REQUIRE(r.error() == http3::error::incomplete);
     REQUIRE(incomplete.size() == encoded.size() - 1);
   }
+
+  SUBCASE("max size")
+  {
+    base::string data = random_string(100);
+    size_t encoded_size = http3::qpack::huffman::encoded_size(data);
+
+    base::buffer encoded(encoded_size);
+
+    REQUIRE(http3::qpack::huffman::encode(
+              encoded.data(), data, encoded_size - 1) == SIZE_MAX);
+    REQUIRE(http3::qpack::huffman::encode(
+              encoded.data(), data, encoded_size) == encoded_size);
+
+    base::string decoded =
+      http3::qpack::huffman::decode(encoded, encoded_size).value();
+    REQUIRE(data == decoded);
+  }
+
+  SUBCASE("split")
+  {
+    base::string data = random_string(100);
+    base::buffer encoded = http3::qpack::huffman::encode(data);
+    size_t encoded_size = encoded.size();
+
+    base::buffers buffers;
+    while (!encoded.empty()) {
+      buffers.push(encoded.slice(std::min<size_t>(encoded.size(), 7)));
+    }
+
+    base::string decoded =
+      http3::qpack::huffman::decode(buffers, encoded_size).value();
+
+    REQUIRE(buffers.empty());
+    REQUIRE(data == decoded);
+  }
+}
+
+TEST_CASE("huffman: reference")
+{
+  SUBCASE("random")
+  {
+    for (size_t i = 0; i < 1000; i++) {
+      // The reference decoder doesn't accept empty strings.
+      base::string string = random_bytes(1 + i % 100);
+      base::buffer encoded = http3::qpack::huffman::encode(string);
+
+      base::buffer first(encoded.data(), encoded.size());
+      base::buffer second(encoded.data(), encoded.size());
+
+      base::string decoded =
+        http3::qpack::huffman::decode(first, encoded.size()).value();
+      base::string reference =
+        http3::qpack::huffman::reference::decode(second, encoded.size())
+          .value();
+
+      REQUIRE(decoded == string);
+      REQUIRE(decoded == reference);
+      REQUIRE(first.empty());
+    }
+  }
+
+  SUBCASE("invalid")
+  {
+    // Random bytes are mostly invalid (EOS, too much padding, padding that
+    // isn't all ones) so both decoders should agree on the errors as well.
+    for (size_t i = 0; i < 1000; i++) {
+      base::string bytes = random_bytes(1 + i % 20);
+
+      base::buffer first(bytes.data(), bytes.size());
+      base::buffer second(bytes.data(), bytes.size());
+
+      http3::result<base::string> decoded =
+        http3::qpack::huffman::decode(first, bytes.size());
+      http3::result<base::string> reference =
+        http3::qpack::huffman::reference::decode(second, bytes.size());
+
+      REQUIRE(static_cast<bool>(decoded) == static_cast<bool>(reference));
+
+      if (decoded) {
+        REQUIRE(decoded.value() == reference.value());
+      } else {
+        REQUIRE(decoded.error() == reference.error());
+      }
+    }
+  }
+
+  SUBCASE("padding")
+  {
+    // 'a' is encoded as 00011 followed by three bits of padding.
+    const uint8_t valid[] = { 0x1f };
+    // Padding that isn't all ones.
+    const uint8_t zeros[] = { 0x18 };
+    // A full byte of padding.
+    const uint8_t full[] = { 0x1f, 0xff };
+    const uint8_t eos[] = { 0xff, 0xff, 0xff, 0xff };
+
+    base::buffer encoded(valid, sizeof(valid));
+    REQUIRE(http3::qpack::huffman::decode(encoded, 1).value() == "a");
+
+    base::buffer_view invalid[] = { { zeros, sizeof(zeros) },
+                                    { full, sizeof(full) },
+                                    { eos, sizeof(eos) } };
+
+    for (base::buffer_view view : invalid) {
+      encoded = base::buffer(view);
+
+      http3::result<base::string> r =
+        http3::qpack::huffman::decode(encoded, encoded.size());
+      REQUIRE(r.error() == http3::error::qpack_decompression_failed);
+    }
+  }
 }
@@ -1,5 +1,6 @@
 #include <doctest.h>
 
+#include <bnl/base/buffer_builder.hpp>
 #include <bnl/http3/codec/qpack.hpp>
 
 #include <algorithm>
@@ -48,6 +49,56 @@ TEST_CASE("qpack")
     encode_and_decode<13>(via, encoder, decoder);
   }
 
+  SUBCASE("static table: near miss")
+  {
+    // Same size and first character as static table entries.
+    http3::header path = { ":path", "/x" };
+    encode_and_decode<6>(path, encoder, decoder);
+
+    http3::header pbth = { ":pbth", "/" };
+    encode_and_decode<7>(pbth, encoder, decoder);
+
+    http3::header age = { "agx", "0" };
+    encode_and_decode<6>(age, encoder, decoder);
+  }
+
+  SUBCASE("encode: builder")
+  {
+    // Huffman encoding shrinks the value below 127 bytes so its length needs
+    // one byte less than the length of the unencoded value.
+    base::string shrinks(130, 'a');
+
+    http3::header headers[] = { { ":path", "/" },
+                                { ":authority", "www.example.com" },
+                                { "via", "1.0 fred" },
+                                // Longer when huffman encoded.
+                                { "x-unencoded", "{|}~^[]" },
+                                { "x-shrinks", shrinks },
+                                { "x-empty", "" } };
+
+    http3::qpack::encoder other;
+    base::buffer_builder builder;
+    base::buffers expected;
+
+    for (const http3::header &header : headers) {
+      encoder.encode(builder, header).value();
+      expected.push(other.encode(header).value());
+    }
+
+    base::buffer encoded = builder.finish();
+
+    REQUIRE(encoded.size() == expected.size());
+    REQUIRE(encoded == expected.slice(expected.size()));
+    REQUIRE(encoder.count() == other.count());
+
+    for (const http3::header &header : headers) {
+      http3::header decoded = decoder.decode(encoded).value();
+      REQUIRE(decoded == header);
+    }
+
+    REQUIRE(encoded.empty());
+  }
+
   SUBCASE("encode: malformed header")
   {
     http3::header via = { "Via", "1.0.fred" };
@@ -99,3 +150,312 @@ TEST_CASE("qpack")
     REQUIRE(encoded.size() == 2);
   }
 }
+
+static bool
+contains(const base::buffer_view &buffer, base::string_view string)
+{
+  const char *begin = reinterpret_cast<const char *>(buffer.data());
+  return string.data() >= begin && string.data() < begin + buffer.size();
+}
+
+TEST_CASE("qpack: decode view")
+{
+  http3::qpack::encoder encoder;
+  http3::qpack::decoder decoder;
+
+  http3::header method = { ":method", "GET" };
+  http3::header raw = { "x-raw", "~~~~" };
+
+  base::buffer_builder builder;
+  REQUIRE(encoder.encode(builder, method));
+  REQUIRE(encoder.encode(builder, raw));
+
+  base::buffer encoded = builder.finish();
+  base::buffer_view block = encoded;
+
+  http3::header_view decoded = decoder.decode_view(encoded).value();
+  REQUIRE(decoded == method);
+  // Static table entries refer to constant storage.
+  REQUIRE(!contains(block, decoded.name()));
+  REQUIRE(!contains(block, decoded.value()));
+
+  decoded = decoder.decode_view(encoded).value();
+  REQUIRE(encoded.empty());
+  REQUIRE(decoded == raw);
+  // The name is huffman encoded and decoded into the decoder's arena while the
+  // value is not and refers to the header block.
+  REQUIRE(!contains(block, decoded.name()));
+  REQUIRE(contains(block, decoded.value()));
+}
+
+template<size_t N>
+static void
+require_equal(const base::buffer &encoded, const uint8_t (&expected)[N])
+{
+  REQUIRE(encoded.size() == N);
+  REQUIRE(std::equal(encoded.begin(), encoded.end(), expected));
+}
+
+template<size_t N>
+static void
+require_prefix(http3::qpack::encoder &encoder, const uint8_t (&expected)[N])
+{
+  uint8_t prefix[32] = {};
+
+  REQUIRE(encoder.prefix_encoded_size() == N);
+  REQUIRE(encoder.fin(prefix) == N);
+  REQUIRE(std::equal(prefix, prefix + N, expected));
+}
+
+static constexpr auto METHOD_GET =
+  http3::qpack::static_header::make(":method", "GET");
+static constexpr auto STATUS_100 =
+  http3::qpack::static_header::make(":status", "100");
+static constexpr auto AUTHORITY =
+  http3::qpack::static_header::make(":authority", "www.example.com");
+static constexpr auto VIA =
+  http3::qpack::static_header::make("via", "1.0 fred");
+static constexpr auto UPPERCASE =
+  http3::qpack::static_header::make("Via", "1.0 fred");
+
+// Static table lookups and prefix integers are resolved at compile time.
+static_assert(METHOD_GET.encoded_size() == 1, "");
+static_assert(STATUS_100.encoded_size() == 2, "");
+static_assert(AUTHORITY.encoded_size() == 17, "");
+static_assert(VIA.encoded_size() == 13, "");
+static_assert(!UPPERCASE.lowercase(), "");
+
+static void
+encode_and_decode(const http3::qpack::static_header &header)
+{
+  http3::qpack::encoder encoder;
+  http3::qpack::decoder decoder;
+
+  base::buffer_builder builder;
+
+  // The first header is preceded by the header block prefix.
+  size_t encoded_size = encoder.encode(builder, header).value();
+  REQUIRE(encoded_size == header.encoded_size() + 2);
+  REQUIRE(encoder.count() == encoded_size);
+
+  base::buffer encoded = builder.finish();
+
+  http3::header decoded = decoder.decode(encoded).value();
+  REQUIRE(encoded.empty());
+  REQUIRE(decoded == http3::header(header.header()));
+}
+
+TEST_CASE("qpack: static header")
+{
+  SUBCASE("indexed header field")
+  {
+    encode_and_decode(METHOD_GET);
+    encode_and_decode(STATUS_100);
+  }
+
+  SUBCASE("literal with name reference")
+  {
+    encode_and_decode(AUTHORITY);
+  }
+
+  SUBCASE("literal without name reference")
+  {
+    encode_and_decode(VIA);
+  }
+
+  SUBCASE("uppercase")
+  {
+    http3::qpack::encoder encoder;
+    base::buffer_builder builder;
+
+    http3::result<size_t> r = encoder.encode(builder, UPPERCASE);
+    REQUIRE(r.error() == http3::error::malformed_header);
+  }
+}
+
+TEST_CASE("qpack: dynamic table")
+{
+  http3::qpack::stream::encoder stream;
+
+  http3::settings settings;
+  settings.qpack_max_table_capacity = 4096;
+
+  SUBCASE("insert and reference")
+  {
+    REQUIRE(stream.configure(settings));
+
+    // Set Dynamic Table Capacity (4096)
+    const uint8_t capacity[] = { 0x3f, 0xe1, 0x1f };
+    require_equal(stream.encode().value(), capacity);
+
+    http3::header agent = { "user-agent", "bnl" };
+
+    {
+      http3::qpack::encoder encoder(0, &stream);
+      base::buffer encoded = encoder.encode(agent).value();
+
+      // The entry is inserted but can't be referenced until the peer
+      // acknowledged it since blocked streams aren't allowed.
+      const uint8_t literal[] = { 0x5f, 0x50, 0x03, 'b', 'n', 'l' };
+      require_equal(encoded, literal);
+
+      const uint8_t prefix[] = { 0x00, 0x00 };
+      require_prefix(encoder, prefix);
+    }
+
+    // Insert With Name Reference (static, 95)
+    const uint8_t insert[] = { 0xff, 0x20, 0x03, 'b', 'n', 'l' };
+    require_equal(stream.encode().value(), insert);
+    REQUIRE(stream.table().inserted() == 1);
+
+    // Insert Count Increment (1)
+    base::buffer increment(1);
+    increment[0] = 0x01;
+    REQUIRE(stream.decode(increment));
+    REQUIRE(stream.known_received_count() == 1);
+
+    {
+      http3::qpack::encoder encoder(4, &stream);
+      base::buffer encoded = encoder.encode(agent).value();
+
+      // Indexed Header Field (dynamic, relative index 0)
+      const uint8_t indexed[] = { 0x80 };
+      require_equal(encoded, indexed);
+
+      // Required Insert Count (1) + Delta Base (0)
+      const uint8_t prefix[] = { 0x02, 0x00 };
+      require_prefix(encoder, prefix);
+    }
+
+    REQUIRE(stream.encode().error() == http3::error::idle);
+
+    // Section Acknowledgment (4)
+    base::buffer acknowledgment(1);
+    acknowledgment[0] = 0x84;
+    REQUIRE(stream.decode(acknowledgment));
+
+    // No more unacknowledged header blocks on stream 4.
+    acknowledgment = base::buffer(1);
+    acknowledgment[0] = 0x84;
+    http3::result<void> r = stream.decode(acknowledgment);
+    REQUIRE(r.error() == http3::error::qpack_decoder_stream_error);
+  }
+
+  SUBCASE("blocked streams")
+  {
+    settings.qpack_blocked_streams = 1;
+    REQUIRE(stream.configure(settings));
+    REQUIRE(stream.encode());
+
+    {
+      http3::qpack::encoder encoder(0, &stream);
+      base::buffer encoded = encoder.encode({ "x-first", "1" }).value();
+
+      // Indexed Header Field With Post-Base Index (0)
+      const uint8_t indexed[] = { 0x10 };
+      require_equal(encoded, indexed);
+
+      // Required Insert Count (1) + Delta Base (-1)
+      const uint8_t prefix[] = { 0x02, 0x80 };
+      require_prefix(encoder, prefix);
+    }
+
+    REQUIRE(stream.blocked_streams() == 1);
+
+    {
+      http3::qpack::encoder encoder(4, &stream);
+      base::buffer encoded = encoder.encode({ "x-second", "2" }).value();
+
+      // Inserted but not referenced since stream 0 is already blocked.
+      REQUIRE(encoded.size() > 1);
+
+      const uint8_t prefix[] = { 0x00, 0x00 };
+      require_prefix(encoder, prefix);
+    }
+
+    REQUIRE(stream.blocked_streams() == 1);
+    REQUIRE(stream.table().inserted() == 2);
+
+    // The first entry can't be evicted while stream 0 references it.
+    REQUIRE(stream.table().dropped() == 0);
+
+    // Insert Count Increment (1) unblocks stream 0 even though its header
+    // block hasn't been acknowledged yet.
+    base::buffer increment(1);
+    increment[0] = 0x01;
+    REQUIRE(stream.decode(increment));
+    REQUIRE(stream.blocked_streams() == 0);
+
+    {
+      http3::qpack::encoder encoder(8, &stream);
+      base::buffer encoded = encoder.encode({ "x-second", "2" }).value();
+
+      // Indexed Header Field (dynamic, relative index 0)
+      const uint8_t indexed[] = { 0x80 };
+      require_equal(encoded, indexed);
+    }
+
+    REQUIRE(stream.blocked_streams() == 1);
+
+    // Stream Cancellation (8)
+    base::buffer cancellation(1);
+    cancellation[0] = 0x48;
+    REQUIRE(stream.decode(cancellation));
+    REQUIRE(stream.blocked_streams() == 0);
+  }
+
+  SUBCASE("decode")
+  {
+    http3::qpack::stream::decoder decoder;
+
+    settings.qpack_blocked_streams = 1;
+    REQUIRE(stream.configure(settings));
+
+    base::buffer instructions = stream.encode().value();
+    REQUIRE(decoder.decode(instructions));
+
+    http3::header agent = { "user-agent", "bnl" };
+
+    http3::qpack::encoder encoder(0, &stream);
+    base::buffer encoded = encoder.encode(agent).value();
+
+    base::buffer prefix(encoder.prefix_encoded_size());
+    encoder.fin(prefix.data());
+    encoded = base::buffer::concat(prefix, encoded);
+
+    // The header block references an entry that hasn't been received yet.
+    http3::qpack::decoder block(0, &decoder);
+    http3::result<http3::header> r = block.decode(encoded);
+    REQUIRE(r.error() == http3::error::incomplete);
+    REQUIRE(decoder.blocked_streams() == 1);
+    REQUIRE(decoder.unblocked().error() == http3::error::idle);
+
+    instructions = stream.encode().value();
+    REQUIRE(decoder.decode(instructions));
+    REQUIRE(decoder.blocked_streams() == 0);
+    REQUIRE(decoder.unblocked().value() == 0);
+
+    REQUIRE(block.decode(encoded).value() == agent);
+    block.fin();
+
+    // Insert Count Increment (1) + Section Acknowledgment (0)
+    const uint8_t acknowledgments[] = { 0x01, 0x80 };
+    instructions = decoder.encode().value();
+    require_equal(instructions, acknowledgments);
+
+    REQUIRE(stream.decode(instructions));
+    REQUIRE(stream.known_received_count() == 1);
+    REQUIRE(stream.blocked_streams() == 0);
+  }
+
+  SUBCASE("static table only")
+  {
+    // Peer settings haven't been received yet.
+    http3::qpack::encoder encoder(0, &stream);
+    base::buffer encoded = encoder.encode({ "user-agent", "bnl" }).value();
+
+    REQUIRE(encoded.size() == 6);
+    REQUIRE(stream.table().inserted() == 0);
+    REQUIRE(stream.encode().error() == http3::error::idle);
+  }
+}
@@ -1,5 +1,6 @@
 #include <doctest.h>
 
+#include <bnl/base/buffer_builder.hpp>
 #include <bnl/http3/codec/varint.hpp>
 
 static constexpr uint8_t VARINT_UINT8_HEADER = 0x00;
@@ -171,4 +172,101 @@ TEST_CASE("varint")
     REQUIRE(encoded.empty());
     REQUIRE(varint == decoded);
   }
+
+  SUBCASE("decode: split")
+  {
+    uint64_t varint = 1073741823;
+
+    base::buffer encoded = http3::varint::encode(varint).value();
+    REQUIRE(encoded.size() == sizeof(uint32_t));
+
+    base::buffers buffers;
+    buffers.push(encoded.slice(1));
+    buffers.push(encoded.slice(3));
+
+    uint64_t decoded = http3::varint::decode(buffers).value();
+
+    REQUIRE(buffers.empty());
+    REQUIRE(varint == decoded);
+  }
+
+  SUBCASE("bulk")
+  {
+    // All size classes with enough varints to exercise both the word at a time
+    // path and the byte by byte path for the last few varints.
+    const uint64_t varints[] = { 0,          62,         15248,
+                                 1073721823, 4611386010427387203,
+                                 63,         16383,      16384,
+                                 1073741823, 1073741824, http3::varint::max,
+                                 5,          300 };
+    constexpr size_t count = sizeof(varints) / sizeof(varints[0]);
+
+    size_t encoded_size = http3::varint::encoded_size(varints, count).value();
+
+    size_t expected = 0;
+    for (uint64_t varint : varints) {
+      expected += http3::varint::encoded_size(varint).value();
+    }
+
+    REQUIRE(encoded_size == expected);
+
+    base::buffer encoded(encoded_size);
+    REQUIRE(http3::varint::encode(encoded.data(), varints, count).value() ==
+            encoded_size);
+
+    base::buffer_builder builder;
+    REQUIRE(http3::varint::encode(builder, varints, count).value() ==
+            encoded_size);
+    REQUIRE(builder.finish() == encoded);
+
+    // The bulk encoding matches encoding the varints one by one.
+    for (uint64_t varint : varints) {
+      REQUIRE(http3::varint::encode(builder, varint));
+    }
+
+    REQUIRE(builder.finish() == encoded);
+
+    uint64_t decoded[count] = {};
+    REQUIRE(http3::varint::decode(encoded, decoded, count).value() ==
+            encoded_size);
+
+    for (size_t i = 0; i < count; i++) {
+      REQUIRE(decoded[i] == varints[i]);
+    }
+
+    for (uint64_t varint : varints) {
+      REQUIRE(http3::varint::decode(encoded).value() == varint);
+    }
+
+    REQUIRE(encoded.empty());
+  }
+
+  SUBCASE("bulk: incomplete")
+  {
+    const uint64_t varints[] = { 169, 1073741823 };
+
+    base::buffer_builder builder;
+    REQUIRE(http3::varint::encode(builder, varints, 2));
+    base::buffer encoded = builder.finish();
+
+    uint64_t decoded[2] = {};
+    base::buffer_view incomplete(encoded.data(), encoded.size() - 1);
+
+    http3::result<size_t> r = http3::varint::decode(incomplete, decoded, 2);
+    REQUIRE(r.error() == http3::error::incomplete);
+
+    REQUIRE(http3::varint::decode(encoded, decoded, 2).value() ==
+            encoded.size());
+    REQUIRE(decoded[0] == varints[0]);
+    REQUIRE(decoded[1] == varints[1]);
+  }
+
+  SUBCASE("bulk: overflow")
+  {
+    const uint64_t varints[] = { 0, http3::varint::max + 1 };
+
+    base::buffer_builder builder;
+    http3::result<size_t> r = http3::varint::encode(builder, varints, 2);
+    REQUIRE(r.error() == http3::error::varint_overflow);
+  }
 }
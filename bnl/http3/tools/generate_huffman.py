@@ -513,3 +513,131 @@ decode_table = decode_table_template.format(HUFFMAN_DECODE_ACCEPTED, HUFFMAN_DEC
 file = open("decode_generated.cpp", "w+")
 file.write(decode_table)
 file.close()
+
+### Multi-symbol lookup table ###
+
+# The code is canonical: codes of the same length are consecutive and codes are
+# assigned in order of length and then symbol. Long codes and the final bits
+# are decoded with the canonical tables instead of the lookup table.
+
+LOOKUP_BITS = 12
+
+codes = [(code, num_bits) for (code, num_bits, _) in symbol_table]
+codes = [(int(code, 16), num_bits) for (code, num_bits) in codes]
+
+canonical_order = sorted(range(257), key=lambda symbol: (codes[symbol][1], symbol))
+
+code = 0
+previous_num_bits = codes[canonical_order[0]][1]
+for symbol in canonical_order:
+    num_bits = codes[symbol][1]
+    code <<= num_bits - previous_num_bits
+    previous_num_bits = num_bits
+    assert codes[symbol][0] == code, "Huffman code is not canonical"
+    code += 1
+
+min_num_bits = min(num_bits for (_, num_bits) in codes)
+max_num_bits = max(num_bits for (_, num_bits) in codes)
+
+by_code = {}
+for symbol, (code, num_bits) in enumerate(codes):
+    by_code[(code, num_bits)] = symbol
+
+def decode_one(bits, available):
+    for num_bits in range(min_num_bits, available + 1):
+        code = bits >> (available - num_bits)
+        symbol = by_code.get((code, num_bits))
+        if symbol is not None:
+            return symbol, num_bits
+    return None, 0
+
+def lookup_entry(index):
+    symbols = []
+    length = 0
+
+    while len(symbols) < 2:
+        available = LOOKUP_BITS - length
+        bits = index & ((1 << available) - 1)
+        symbol, num_bits = decode_one(bits, available)
+        if symbol is None or symbol == 256:
+            break
+        symbols.append(symbol)
+        length += num_bits
+
+    count = len(symbols)
+    symbols += [0] * (2 - count)
+
+    return "{{ {{ {}, {} }}, {}, {} }}".format(symbols[0], symbols[1], count, length)
+
+lookup_entries = ",".join(lookup_entry(index) for index in range(1 << LOOKUP_BITS))
+
+canonical_entries = []
+offset = 0
+for num_bits in range(max_num_bits + 1):
+    symbols = [symbol for symbol in canonical_order if codes[symbol][1] == num_bits]
+    first = codes[symbols[0]][0] if symbols else 0
+    canonical_entries.append("{{ 0x{:x}u, {}, {} }}".format(first, len(symbols), offset))
+    offset += len(symbols)
+
+canonical_symbols = ",".join(str(symbol) for symbol in canonical_order)
+
+lookup_table_template = """\
+#include <cstddef>
+#include <cstdint>
+
+namespace bnl {{
+namespace http3 {{
+namespace qpack {{
+namespace huffman {{
+namespace lookup {{
+
+// Amount of bits used to index `table`.
+constexpr size_t bits = {};
+
+constexpr size_t min_code_length = {};
+constexpr size_t max_code_length = {};
+
+constexpr uint16_t eos = 256;
+
+// Symbols of the codes that fit in the next `bits` bits of the input. `count`
+// is zero if the first code is longer than `bits` bits.
+struct entry {{
+  uint8_t symbols[2];
+  uint8_t count;
+  // Amount of bits taken up by the decoded symbols.
+  uint8_t length;
+}};
+
+const entry table[] = {{
+    {}
+}};
+
+// Codes of each length, indexed by code length.
+struct canonical {{
+  uint32_t first;
+  uint16_t count;
+  // Index of the symbol of `first` in `symbols`.
+  uint16_t offset;
+}};
+
+const canonical codes[] = {{
+    {}
+}};
+
+// Symbols sorted by code.
+const uint16_t symbols[] = {{
+    {}
+}};
+
+}}
+}}
+}}
+}}
+}}
+"""
+
+lookup_table = lookup_table_template.format(LOOKUP_BITS, min_num_bits, max_num_bits, lookup_entries, ",".join(canonical_entries), canonical_symbols)
+
+file = open("lookup_generated.cpp", "w+")
+file.write(lookup_table)
+file.close()
@@ -1,14 +1,12 @@
 #!usr/bin/env python3
 
-"""
-Dependencies:
-- pip install --user xxhash
-"""
-
-import xxhash
 import itertools
 import os
 
+# Outputs are written relative to this script so it can be run from any
+# directory.
+directory = os.path.dirname(os.path.abspath(__file__))
+
 static_table_raw = """\
 0 	:authority
 1 	:path 	/
@@ -111,44 +109,52 @@ static_table_raw = """\
 98 	x-frame-options 	sameorigin
 """
 
-find_index_template = """\
-static std::pair<type, uint8_t> find_index(header_view header)
-{{
-  uint64_t name_hash = XXH64(header.name().data(), header.name().size(), 0);
-  uint64_t value_hash;
+def indent(code, level):
+    return "\n".join(("  " * level + line) if line else line for line in code.splitlines())
 
-  switch (name_hash) {{
-    {}
-  }}
+def char_literal(character):
+    if character in "\\'":
+        return "'\\{}'".format(character)
+    return "'{}'".format(character)
 
-  return {{ type::missing, {{ }} }};
-}}\
-"""
+# Generates code that looks up `variable` in `entries` (a list of (string, code)
+# tuples) by switching on the size and the first character of `variable`. A
+# candidate only matches if all its characters compare equal to `variable` so
+# no false positives are possible. `code` is executed when `variable` matches.
+def dispatch(variable, entries):
+    result = "switch ({}.size()) {{\n".format(variable)
 
-no_values_template = """\
-case {}U: // {}
-  return {{ type::header_only, uint8_t({}) }};\
-"""
+    entries = sorted(entries, key=lambda entry: (len(entry[0]), entry[0]))
 
-values_template = """\
-case {}U: // {}
-  value_hash = XXH64(header.value().data(), header.value().size(), 0);
-  switch(value_hash) {{
-    {}
-  }}
-  return {{ type::header_only, uint8_t({}) }};\
-"""
+    for size, same_size in itertools.groupby(entries, lambda entry: len(entry[0])):
+        result += "  case {}:\n".format(size)
+        result += "    switch ({}[0]) {{\n".format(variable)
 
-value_template = """\
-case {}U: // {}
-  return {{ type::header_value, uint8_t({}) }};\
-"""
+        for first, same_first in itertools.groupby(same_size, lambda entry: entry[0][0]):
+            result += "      case {}:\n".format(char_literal(first))
+
+            for string, code in same_first:
+                result += "        if (std::memcmp({}.data(), \"{}\", {}) == 0) {{\n".format(variable, string, size)
+                result += indent(code, 5) + "\n"
+                result += "        }\n"
+
+            result += "        break;\n"
+
+        result += "    }\n"
+        result += "    break;\n"
+
+    result += "}"
+
+    return result
+
+header_only_template = "return {{ type::header_only, uint8_t({}) }};"
+header_value_template = "return {{ type::header_value, uint8_t({}) }};"
 
 static_table = [line.split() for line in static_table_raw.splitlines()]
 static_table = filter(lambda entry: len(entry) >= 2, static_table)
 static_table = sorted(static_table, key=lambda x: x[1])
 
-cases = ""
+names = []
 
 for header, entry in itertools.groupby(static_table, lambda x: x[1]):
     entry = list(entry)
@@ -157,24 +163,38 @@ for header, entry in itertools.groupby(static_table, lambda x: x[1]):
     values = [str.join(" ", nested[2:]) for nested in entry if len(nested) > 2]
 
     if len(values) == 0:
-        index = entry[0][0]
-        cases += no_values_template.format(xxhash.xxh64_intdigest(header), header, index)
+        names.append((header, header_only_template.format(indices[0])))
     else:
-        value_cases = ""
+        value_entries = [(value, header_value_template.format(index)) for index, value in zip(indices, values)]
 
-        for index, value in zip(indices, values):
-            value_cases += value_template.format(xxhash.xxh64_intdigest(value), value, index)
+        code = dispatch("value", value_entries) + "\n\n"
+        code += header_only_template.format(indices[0])
 
-        cases += values_template.format(xxhash.xxh64_intdigest(header), header, value_cases, indices[0])
+        names.append((header, code))
 
-find_index = find_index_template.format(cases)
+find_index_template = """\
+// Static table entries are found by switching on the size and the first
+// character of the name and the value. Candidates are compared in full so
+// headers that aren't in the static table never match.
+static std::pair<type, uint8_t>
+find_index(header_view header)
+{{
+  base::string_view name = header.name();
+  base::string_view value = header.value();
+
+{}
+
+  return {{ type::missing, {{}} }};
+}}\
+"""
+
+find_index = find_index_template.format(indent(dispatch("name", names), 1))
 
 encode_generated_template = """\
 #include <bnl/http3/header.hpp>
 
-#include <xxhash.h>
-
 #include <cstdint>
+#include <cstring>
 #include <utility>
 
 namespace bnl {{
@@ -200,12 +220,12 @@ enum class type {{
 
 encode_generated = encode_generated_template.format(find_index)
 
-file = open("encode_generated.cpp", "w+")
+file = open(os.path.join(directory, "../src/codec/qpack/encode_generated.cpp"), "w+")
 file.write(encode_generated)
 file.close()
 
 find_header_value_template = """\
-std::pair<bool, header> find_header_value(uint8_t index)
+std::pair<bool, header_view> find_header_value(uint8_t index)
 {{
   switch(index) {{
     {}
@@ -230,7 +250,7 @@ for entry in static_table:
 find_header_value = find_header_value_template.format(cases)
 
 find_header_only_template = """\
-std::pair<bool, base::string> find_header_only(uint8_t index)
+std::pair<bool, base::string_view> find_header_only(uint8_t index)
 {{
   switch(index) {{
     {}
@@ -254,7 +274,7 @@ find_header_only = find_header_only_template.format(cases)
 
 decode_generated_template = """\
 #include <bnl/http3/header.hpp>
-#include <bnl/base/string.hpp>
+#include <bnl/base/string_view.hpp>
 
 #include <cstdint>
 #include <utility>
@@ -308,6 +328,47 @@ static type find_type(uint8_t byte)
 
 decode_generated = decode_generated_template.format(find_header_value, find_header_only)
 
-file = open("decode_generated.cpp", "w+")
+file = open(os.path.join(directory, "../src/codec/qpack/decode_generated.cpp"), "w+")
 file.write(decode_generated)
 file.close()
+
+static_entries = ""
+
+for entry in sorted(static_table, key=lambda x: int(x[0])):
+    if len(entry) > 2:
+        static_entries += "  {{ \"{}\", \"{}\" }},\n".format(entry[1], str.join(" ", entry[2:]))
+    else:
+        static_entries += "  {{ \"{}\", nullptr }},\n".format(entry[1])
+
+static_table_generated_template = """\
+#pragma once
+
+namespace bnl {{
+namespace http3 {{
+namespace qpack {{
+namespace table {{
+namespace fixed {{
+
+struct entry {{
+  const char *name;
+  // `nullptr` for entries without a value.
+  const char *value;
+}};
+
+// Static table entries by index. Used to find static table indices at compile
+// time (see `static_header`).
+static constexpr entry ENTRIES[] = {{
+{}}};
+
+}}
+}}
+}}
+}}
+}}
+"""
+
+static_table_generated = static_table_generated_template.format(static_entries)
+
+file = open(os.path.join(directory, "../include/bnl/http3/codec/qpack/static_table_generated.hpp"), "w+")
+file.write(static_table_generated)
+file.close()
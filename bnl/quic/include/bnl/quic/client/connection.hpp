@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bnl/base/buffer.hpp>
+#include <bnl/base/buffer_builder.hpp>
 #include <bnl/quic/client/handshake.hpp>
 #include <bnl/quic/client/ngtcp2/connection.hpp>
 #include <bnl/quic/client/stream.hpp>
@@ -12,6 +13,7 @@
 #include <bnl/quic/path.hpp>
 #include <bnl/quic/result.hpp>
 
+#include <list>
 #include <map>
 #include <random>
 
@@ -120,6 +122,11 @@ private:
   // `recv`.
   std::list<result<quic::event>> event_buffer_;
 
+  // Received stream data is only valid during the ngtcp2 callback so we copy
+  // it. Chunks of consecutive callbacks are copied into the same memory block
+  // to avoid an allocation per chunk.
+  base::buffer_builder stream_data_;
+
   uint64_t max_local_bidi_streams_ = 0;
   uint64_t max_local_uni_streams_ = 0;
   uint64_t max_remote_bidi_streams_ = 0;
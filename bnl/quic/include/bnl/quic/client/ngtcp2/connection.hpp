@@ -31,6 +31,9 @@ namespace ngtcp2 {
 
 class BNL_QUIC_EXPORT connection {
 public:
+  // Maximum amount of buffers passed to a single `writev_stream` call.
+  static constexpr size_t MAX_STREAM_SEGMENTS = 16;
+
   connection(path path,
              const params &params,
              client::connection *context,
@@ -70,9 +73,11 @@ public:
 
   result<base::buffer> write_pkt();
 
-  result<std::pair<base::buffer, size_t>> write_stream(uint64_t id,
-                                                       base::buffer_view data,
-                                                       bool fin);
+  result<std::pair<base::buffer, size_t>>
+  writev_stream(uint64_t id,
+                const base::buffer_view *data,
+                size_t count,
+                bool fin);
 
   result<void> read_pkt(base::buffer_view packet);
 
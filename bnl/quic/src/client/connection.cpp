@@ -6,6 +6,9 @@ namespace bnl {
 namespace quic {
 namespace client {
 
+// Memory blocks fit the largest size class of the default allocator.
+static constexpr size_t STREAM_DATA_BLOCK_SIZE = 64 * 1024;
+
 generator::generator(connection &connection)
   : connection_(connection)
 {}
@@ -29,6 +32,7 @@ connection::connection(const ip::host &host,
                        const params &params,
                        clock clock) noexcept
   : prng_(std::random_device()())
+  , stream_data_(STREAM_DATA_BLOCK_SIZE)
   , ngtcp2_(path, params, this, std::move(clock), prng_)
   , handshake_(host, ngtcp2_.dcid(), &ngtcp2_)
   , path_(path)
@@ -64,10 +68,9 @@ connection::handshake_completed()
 void
 connection::recv_stream_data(uint64_t id, bool fin, base::buffer_view data)
 {
-  base::buffer buffer(data.size());
-  std::copy_n(data.data(), data.size(), buffer.data());
+  stream_data_.append(data);
 
-  event_buffer_.emplace_back(quic::data{ id, fin, std::move(buffer) });
+  event_buffer_.emplace_back(quic::data{ id, fin, stream_data_.finish() });
 }
 
 result<void>
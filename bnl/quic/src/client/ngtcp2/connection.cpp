@@ -1001,31 +1001,43 @@ connection::write_pkt()
 }
 
 result<std::pair<base::buffer, size_t>>
-connection::write_stream(uint64_t id, base::buffer_view data, bool fin)
+connection::writev_stream(uint64_t id,
+                          const base::buffer_view *data,
+                          size_t count,
+                          bool fin)
 {
   std::array<uint8_t, NGTCP2_MAX_PKTLEN_IPV4> storage = {};
+  std::array<ngtcp2_vec, MAX_STREAM_SEGMENTS> datav = {};
+
+  assert(count <= datav.size());
+
+  for (size_t i = 0; i < count; i++) {
+    // ngtcp2 doesn't modify the stream data.
+    datav[i].base = const_cast<uint8_t *>(data[i].data()); // NOLINT
+    datav[i].len = data[i].size();
+  }
 
   ssize_t stream_data_written = 0;
 
   duration ts = clock_();
-  ssize_t rv = ngtcp2_conn_write_stream(connection_.get(),
-                                        nullptr,
-                                        storage.data(),
-                                        storage.size(),
-                                        &stream_data_written,
-                                        NGTCP2_WRITE_STREAM_FLAG_NONE,
-                                        static_cast<int64_t>(id),
-                                        static_cast<uint8_t>(fin),
-                                        data.data(),
-                                        data.size(),
-                                        make_timestamp(ts));
+  ssize_t rv = ngtcp2_conn_writev_stream(connection_.get(),
+                                         nullptr,
+                                         storage.data(),
+                                         storage.size(),
+                                         &stream_data_written,
+                                         NGTCP2_WRITE_STREAM_FLAG_NONE,
+                                         static_cast<int64_t>(id),
+                                         static_cast<uint8_t>(fin),
+                                         datav.data(),
+                                         count,
+                                         make_timestamp(ts));
 
   if (rv == NGTCP2_ERR_STREAM_DATA_BLOCKED) {
     return error::stream_data_blocked;
   }
 
   if (rv < 0) {
-    THROW_NGTCP2(ngtcp2_conn_write_stream, static_cast<int>(rv));
+    THROW_NGTCP2(ngtcp2_conn_writev_stream, static_cast<int>(rv));
   }
 
   stream_data_written = stream_data_written == -1 ? 0 : stream_data_written;
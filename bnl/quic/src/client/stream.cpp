@@ -3,6 +3,8 @@
 #include <bnl/base/log.hpp>
 #include <bnl/quic/client/ngtcp2/connection.hpp>
 
+#include <array>
+
 namespace bnl {
 namespace quic {
 namespace client {
@@ -30,14 +32,24 @@ stream::send()
     opened_ = true;
   }
 
-  const base::buffer &first = buffers_.front();
-  bool fin = fin_ && (first == buffers_.back());
+  // Pass multiple buffers at once so small buffers (such as HTTP/3 frame
+  // headers) end up in the same packet as the data that follows them.
+  std::array<base::buffer_view, ngtcp2::connection::MAX_STREAM_SEGMENTS>
+    segments;
+  size_t count = buffers_.segments(segments.data(), segments.size());
+
+  size_t size = 0;
+  for (size_t i = 0; i < count; i++) {
+    size += segments[i].size();
+  }
+
+  bool fin = fin_ && size == buffers_.size();
 
   base::buffer packet;
   size_t stream_bytes_written = 0;
 
   result<std::pair<base::buffer, size_t>> r =
-    ngtcp2_->write_stream(id_, first, fin);
+    ngtcp2_->writev_stream(id_, segments.data(), count, fin);
 
   if (!r) {
     if (r.error() == error::stream_id_blocked ||
@@ -50,8 +62,13 @@ stream::send()
 
   std::tie(packet, stream_bytes_written) = std::move(r).value();
 
-  base::buffer sent = buffers_.slice(stream_bytes_written);
-  keepalive_.push(std::move(sent));
+  // ngtcp2 keeps pointers to the written data until it is acked so we keep
+  // the exact buffers that were passed to it alive instead of a copy.
+  base::buffers sent = buffers_.split(stream_bytes_written);
+
+  while (!sent.empty()) {
+    keepalive_.push(sent.pop());
+  }
 
   return packet;
 }
@@ -61,7 +78,7 @@ stream::add(base::buffer buffer)
 {
   assert(!fin_);
 
-  buffers_.push(std::move(buffer));
+  buffers_.push_stable(std::move(buffer));
 
   return base::success();
 }